@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNATOMIC_FILE_HPP
+#define MTEA_DYNATOMIC_FILE_HPP
+
+#include <filesystem>
+#include <functional>
+#include <ostream>
+
+namespace mtea {
+
+// Writes a file through a temporary file that then replaces it, so that a failure part way through never leaves a truncated
+// file in place, and any existing mapping of the previous file remains valid
+void write_file_atomic(const std::filesystem::path& path, const std::function<void(std::ostream&)>& write);
+
+}
+
+#endif // MTEA_DYNATOMIC_FILE_HPP
@@ -6,7 +6,10 @@
 #include <cstdlib>
 
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "parameter.hpp"
@@ -15,10 +18,12 @@
 #include "variable_manager.hpp"
 
 #include "codegen_component.hpp"
+#include "symbol.hpp"
 
 namespace mtea {
 
 class BlockExecutionInterface;
+struct ExecutionArtifact;
 
 struct BlockError {
     BlockError(const size_t id, const std::string& message);
@@ -47,6 +52,9 @@ public:
 
     virtual std::unique_ptr<codegen::CodeComponent> get_codegen_self() const = 0;
 
+    virtual void add_to_artifact(const ConnectionManager& connections, const std::unordered_map<VariableIdentifier, size_t>& slots,
+                                 ExecutionArtifact& artifact) const;
+
 protected:
     virtual std::vector<std::unique_ptr<codegen::CodeComponent>> get_codegen_other() const;
 };
@@ -103,10 +111,13 @@ public:
 
     virtual std::unique_ptr<CompiledBlockInterface> get_compiled(const ModelInfo& s) const = 0;
 
-    virtual std::string get_library() const { return library_name; }
+    virtual std::string get_library() const { return library_name.str(); }
 
     virtual std::string get_full_name() const;
 
+    // Block names don't change once created, and so the qualified symbol is interned on first use and kept for the block
+    Symbol get_full_symbol() const;
+
 protected:
     std::unique_ptr<const BlockError> make_error(const std::string& msg) const;
 
@@ -114,7 +125,9 @@ private:
     size_t _id{0};
     BlockLocation _loc{};
     bool _inverted{false};
-    const std::string library_name;
+    const Symbol library_name;
+    mutable std::once_flag full_symbol_flag;
+    mutable std::optional<Symbol> full_symbol;
 };
 
 class BlockExecutionInterface {
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNBLOCK_STORE_HPP
+#define MTEA_DYNBLOCK_STORE_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mtea {
+
+class BlockInterface;
+
+// Slot-based block storage, where the block ID is the index of the slot, and iteration is in ascending ID order
+class BlockStore {
+public:
+    using value_type = std::pair<size_t, std::shared_ptr<BlockInterface>>;
+
+    // Block ID along with the generation of its slot, which no longer resolves once the block is removed, even if the ID is reused
+    struct Handle {
+        size_t id{0};
+        uint64_t generation{0};
+
+        bool operator==(const Handle& other) const = default;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BlockStore::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type&;
+        using pointer = const value_type*;
+
+        const_iterator() = default;
+
+        const_iterator(const std::vector<value_type>* slots, const size_t index);
+
+        reference operator*() const;
+
+        pointer operator->() const;
+
+        const_iterator& operator++();
+
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator& other) const = default;
+
+    private:
+        void skip_empty();
+
+        const std::vector<value_type>* slots{nullptr};
+        size_t index{0};
+    };
+
+    using iterator = const_iterator;
+
+    bool contains(const size_t id) const;
+
+    const_iterator find(const size_t id) const;
+
+    const std::shared_ptr<BlockInterface>& at(const size_t id) const;
+
+    Handle get_handle(const size_t id) const;
+
+    bool contains(const Handle& handle) const;
+
+    const_iterator find(const Handle& handle) const;
+
+    bool try_emplace(const size_t id, std::shared_ptr<BlockInterface> block);
+
+    void erase(const_iterator it);
+
+    bool erase(const size_t id);
+
+    void clear();
+
+    // Most recently freed ID first, so that allocation is constant time
+    size_t next_id();
+
+    size_t size() const;
+
+    size_t capacity() const;
+
+    bool empty() const;
+
+    // IDs are slot indices, and so IDs far beyond the existing slots, such as from a corrupt file, are rejected rather than allocated
+    static constexpr size_t MAX_ID_GAP = 1 << 20;
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+private:
+    std::vector<value_type> slots;
+    std::vector<uint64_t> generations; // Not trimmed with the slots, so that a reused ID always gets a new generation
+    std::vector<size_t> free_ids; // May hold IDs since filled explicitly or trimmed from the end, which are skipped when allocating
+    size_t count{0};
+};
+
+}
+
+#endif // MTEA_DYNBLOCK_STORE_HPP
@@ -3,7 +3,9 @@
 #ifndef MTEA_DYNCODEGEN_HPP
 #define MTEA_DYNCODEGEN_HPP
 
+#include <cstddef>
 #include <string>
+#include <unordered_map>
 
 #include "data_type.hpp"
 
@@ -19,6 +21,75 @@ enum class BlockFunction {
     STEP,
 };
 
+enum class SignalStorage {
+    BLOCK_INTERFACE = 0, // Signals are copied between the interface structs of connected blocks
+    FLAT,                // Signals are stored once by their source, with generated models bound to their sources by pointer,
+                         // which removes the copies between blocks but adds an indirection to every signal read
+};
+
+enum class InterfaceBinding {
+    VALUE = 0,
+    POINTER,
+};
+
+enum class CodeLayout {
+    HIERARCHICAL = 0, // One header per component, with a nested struct instance for each model block
+    AMALGAMATED,      // The full model hierarchy flattened into a single header for the root model
+};
+
+enum class ParameterBinding {
+    CONSTANT = 0, // Block constructor arguments are constexpr constants of the model, which blocks still store as constructed
+    CONSTRUCTOR,  // Block constructor arguments are fields of the model parameters, given once when the model is constructed
+};
+
+struct CodegenOptions {
+    SignalStorage signal_storage{SignalStorage::BLOCK_INTERFACE};
+    CodeLayout layout{CodeLayout::HIERARCHICAL};
+    size_t num_threads{0};       // Zero uses one thread per hardware thread
+    bool write_benchmark{false}; // Also write a benchmark main and CMake project for the root model
+    size_t batch_size{0};        // Instances stepped together by amalgamated code, or zero for a single instance
+    size_t num_partitions{0};    // Partitions of amalgamated code that are stepped in parallel, or zero for serial code only
+    std::unordered_map<std::string, double> block_costs; // Estimated step cost by block type name, defaulting to one
+    double min_partition_cost{2000.0}; // Estimated work each partition needs per step to outweigh synchronising with the others
+    bool multi_rate{false};      // Step amalgamated code in rate groups, from the preferred step of each model
+    bool rate_dispatcher{false}; // Also write a rate-monotonic dispatcher for running each rate group from its own task
+    ParameterBinding parameter_binding{ParameterBinding::CONSTANT}; // Binding of block constructor arguments without an override
+    std::unordered_map<std::string, ParameterBinding> parameter_bindings; // Overrides by qualified argument name, as in Model::_block_2_arg
+    bool write_parameter_report{false}; // Also write a report of the binding chosen for each block constructor argument
+    bool optimise_size{false}; // Share one type between structurally identical models, and define large functions out of line
+    size_t inline_budget{16};  // Statements a function of size-optimised code may hold while still defined inline in its header
+};
+
+// Size of the generated source, used to compare output modes
+struct CodegenSummary {
+    size_t files{0};
+    size_t lines{0};
+    size_t bytes{0};
+    size_t files_written{0}; // Files whose contents changed since the previous run, and so were rewritten
+    size_t files_removed{0}; // Files from the previous run that are no longer generated
+    size_t parameters_constant{0};
+    size_t parameters_constructor{0};
+    size_t types_shared{0}; // Model types written as aliases of a structurally identical type in size-optimised code
+};
+
+// Block constructor argument as written in generated code, with the binding that was chosen for it
+struct ParameterReport {
+    std::string name; // Qualified by the generated type that holds it, as in Model::_block_2_arg
+    std::string type_name;
+    std::string value;
+    ParameterBinding binding{ParameterBinding::CONSTANT};
+};
+
+// Estimated size of a generated component, with code counted in statements and data in members rather than in bytes, as the sizes
+// of the block types are only known to the compiler
+struct ComponentSize {
+    std::string name;
+    std::string shared_with; // Type holding the implementation, for types written as an alias of a structurally identical type
+    size_t estimated_inline_statements{0};
+    size_t estimated_out_of_line_statements{0};
+    size_t estimated_data_members{0};
+};
+
 class CodegenError {
 public:
     explicit CodegenError(std::string_view msg);
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNCODEGEN_BENCHMARK_HPP
+#define MTEA_DYNCODEGEN_BENCHMARK_HPP
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "codegen.hpp"
+#include "variable_manager.hpp"
+
+namespace mtea {
+
+class Model;
+
+}
+
+namespace mtea::codegen {
+
+class CodeComponent;
+
+struct BenchmarkTiming {
+    double reset_ns{0.0};
+    double mean_ns{0.0};
+    double p50_ns{0.0};
+    double p90_ns{0.0};
+    double p99_ns{0.0};
+};
+
+// Signal values for each step of a run, stored as CSV rows of the step time followed by one column per port
+struct SignalTrace {
+    std::vector<double> times;
+    std::vector<std::vector<double>> values;
+    std::optional<BenchmarkTiming> timing;
+
+    size_t get_num_steps() const;
+
+    static SignalTrace read_csv(const std::filesystem::path& path);
+
+    void write_csv(const std::filesystem::path& path) const;
+};
+
+struct BenchmarkComparison {
+    double max_deviation{0.0};
+    size_t max_deviation_step{0};
+    size_t max_deviation_port{0};
+    BenchmarkTiming generated;
+    BenchmarkTiming interpreted;
+
+    double get_speedup() const;
+};
+
+// Writes a standalone benchmark for generated code, which drives the root model from a stimulus file, times reset and step,
+// and writes the outputs of the first pass in the same format that the interpreter comparison reads
+class BenchmarkWriter {
+public:
+    static std::vector<std::string> write_main(const CodeComponent& root, const CodegenOptions& options);
+
+    static std::vector<std::string> write_cmake(const CodeComponent& root, const CodegenOptions& options);
+
+    static constexpr std::string_view MAIN_FILE_NAME = "benchmark_main.cpp";
+    static constexpr std::string_view CMAKE_FILE_NAME = "CMakeLists.txt";
+
+private:
+    static std::vector<std::string> write_partitioned_run(const CodeComponent& root);
+};
+
+// Runs a model in the interpreter over the same stimulus as the generated benchmark, recording outputs from the first pass
+SignalTrace run_interpreter(const std::shared_ptr<Model>& model, const SignalTrace& stimulus, const double dt, const size_t passes);
+
+BenchmarkComparison compare_outputs(const SignalTrace& generated, const SignalTrace& interpreted);
+
+// Range of values taken by a block output over a run
+struct SignalRange {
+    VariableIdentifier id;
+    double min{0.0};
+    double max{0.0};
+};
+
+// Runs a model in the interpreter over a stimulus, recording the range of every block output in the model
+std::vector<SignalRange> record_signal_ranges(const std::shared_ptr<Model>& model, const SignalTrace& stimulus, const double dt);
+
+}
+
+#endif // MTEA_DYNCODEGEN_BENCHMARK_HPP
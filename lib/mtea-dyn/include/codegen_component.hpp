@@ -28,6 +28,12 @@ private:
     std::vector<std::string> fields;
 };
 
+// Constructor argument of a generated block, given by type and value so that it may be bound as a constant or as a model parameter
+struct ConstructorArgument {
+    std::string type_name;
+    std::string value;
+};
+
 class CodeComponent {
 public:
     CodeComponent() = default;
@@ -40,7 +46,12 @@ public:
 
     virtual std::optional<InterfaceDefinition> get_output_type() const = 0;
 
-    virtual std::vector<std::string> write_code(CodeSection section) const = 0;
+    virtual std::vector<std::string> write_code(CodeSection section, const CodegenOptions& options) const = 0;
+
+    virtual InterfaceBinding get_interface_binding(const CodegenOptions& options) const;
+
+    // Partitions that generated code is actually stepped in, which may be fewer than requested for models with little work
+    virtual size_t get_num_partitions(const CodegenOptions& options) const;
 
     virtual std::string get_name_base() const = 0;
 
@@ -50,7 +61,14 @@ public:
 
     virtual std::optional<std::string> get_function_name(BlockFunction ft) const = 0;
 
-    virtual std::vector<std::string> constructor_arguments() const;
+    virtual std::vector<ConstructorArgument> constructor_arguments() const;
+
+    virtual std::vector<ParameterReport> get_parameter_report(const CodegenOptions& options) const;
+
+    // Key that is equal for components generating the same code apart from their names, or empty for components that are not shared
+    virtual std::optional<std::string> get_structure_key(const CodegenOptions& options) const;
+
+    virtual std::optional<ComponentSize> get_size_estimate(const CodegenOptions& options) const;
 };
 
 }
@@ -4,19 +4,28 @@
 #define MTEA_DYNCODEGEN_GENERATOR_HPP
 
 #include <filesystem>
+#include <string>
 
 #include "block_interface.hpp"
+#include "codegen.hpp"
 
 namespace mtea::codegen {
 
 class CodeGenerator {
 public:
-    explicit CodeGenerator(std::unique_ptr<CompiledBlockInterface>&& comp);
+    explicit CodeGenerator(std::unique_ptr<CompiledBlockInterface>&& comp, const CodegenOptions& options = {});
 
-    void write_in_folder(const std::filesystem::path& path) const;
+    CodegenSummary write_in_folder(const std::filesystem::path& path) const;
+
+    static const std::string MANIFEST_FILE_NAME;
+
+    static const std::string PARAMETER_REPORT_FILE_NAME;
+
+    static const std::string SIZE_REPORT_FILE_NAME;
 
 private:
     std::unique_ptr<CompiledBlockInterface> compiled;
+    const CodegenOptions options;
 };
 
 }
@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNCODEGEN_MODEL_HPP
+#define MTEA_DYNCODEGEN_MODEL_HPP
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "codegen.hpp"
+#include "codegen_component.hpp"
+#include "model.hpp"
+
+namespace mtea::codegen {
+
+// Code component of a model, written as one type for each model in the hierarchical layout, or as a single flattened type in the
+// amalgamated layout, which may be run in partitions or in rate groups
+class ModelCodeComponent : public CodeComponent {
+protected:
+    struct ComponentVariable {
+        ComponentVariable(const std::string_view name, std::unique_ptr<const codegen::CodeComponent>&& component)
+            : name{name}, component{std::move(component)} {
+            // Empty Constructor
+        }
+
+        const std::string name;
+        const std::unique_ptr<const codegen::CodeComponent> component;
+    };
+
+    static bool has_component(const std::optional<ComponentVariable>& v);
+
+    static const ComponentVariable& get_component(const std::optional<ComponentVariable>& v);
+
+public:
+    ModelCodeComponent(const mtea::Identifier& model_name, const double base_dt, const double rate_dt,
+                       std::shared_ptr<const mtea::Model::CompiledModelData> exec_data,
+                       std::vector<std::unique_ptr<const codegen::CodeComponent>>&& components,
+                       std::vector<std::shared_ptr<const BlockInterface>>&& sources);
+
+    std::optional<mtea::codegen::InterfaceDefinition> get_input_type() const override;
+
+    std::optional<mtea::codegen::InterfaceDefinition> get_output_type() const override;
+
+    std::string get_name_base() const override;
+
+    std::optional<std::string> get_function_name(mtea::codegen::BlockFunction ft) const override;
+
+    mtea::codegen::InterfaceBinding get_interface_binding(const mtea::codegen::CodegenOptions& options) const override;
+
+    size_t get_num_partitions(const mtea::codegen::CodegenOptions& options) const override;
+
+protected:
+    std::vector<std::string> write_code(mtea::codegen::CodeSection section, const mtea::codegen::CodegenOptions& options) const override;
+
+    std::vector<std::string> write_cpp_implementation(const mtea::codegen::CodegenOptions& options) const;
+
+    /* ==================== CODE SIZE ==================== */
+
+    // Statements in a generated function, as an estimate of its code size
+    static size_t count_statements(const std::vector<std::string>& fcn_lines);
+
+    // Size-optimised code keeps one copy of each large function in the source file of its type, rather than one at each call site
+    static bool is_out_of_line(const std::vector<std::string>& fcn_lines, const mtea::codegen::CodegenOptions& options);
+
+    std::vector<std::string> write_cpp_definitions(const mtea::codegen::CodegenOptions& options) const;
+
+    std::optional<std::string> get_structure_key(const mtea::codegen::CodegenOptions& options) const override;
+
+    std::optional<mtea::codegen::ComponentSize> get_size_estimate(const mtea::codegen::CodegenOptions& options) const override;
+
+    /* ==================== PARAMETERS ==================== */
+
+    // Block members of the generated type by member name, with nested models included as members in the hierarchical layout only
+    using MemberList = std::vector<std::pair<std::string, const mtea::codegen::CodeComponent*>>;
+
+    MemberList get_members() const;
+
+    // Constructor argument of a block member, with the name and binding that it is given in generated code
+    struct BoundArgument {
+        std::string name;
+        mtea::codegen::ConstructorArgument argument;
+        mtea::codegen::ParameterBinding binding;
+    };
+
+    static bool is_from_constructor(const BoundArgument& arg);
+
+    static bool is_constant(const BoundArgument& arg);
+
+    std::vector<BoundArgument> get_bound_arguments(const mtea::codegen::CodeComponent& comp, const std::string_view varname,
+                                                   const mtea::codegen::CodegenOptions& options) const;
+
+    // Whether the generated type takes parameters, either for its own blocks or for the types of nested models
+    bool has_constructor_parameters(const MemberList& members, const mtea::codegen::CodegenOptions& options) const;
+
+    std::string get_argument_list(const mtea::codegen::CodeComponent& comp, const std::string_view varname,
+                                  const mtea::codegen::CodegenOptions& options) const;
+
+    std::string get_member_declaration(const mtea::codegen::CodeComponent& comp, const std::string_view varname,
+                                       const mtea::codegen::CodegenOptions& options) const;
+
+    // Parameters struct and the constructor taking it, written only for types with constructor parameters
+    std::vector<std::string> get_parameter_declarations(const MemberList& members, const mtea::codegen::CodegenOptions& options) const;
+
+    // Constant arguments as constexpr members, which blocks are constructed from
+    std::vector<std::string> get_constant_declarations(const MemberList& members, const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<mtea::codegen::ParameterReport> get_parameter_report(const mtea::codegen::CodegenOptions& options) const override;
+
+    static std::string get_port_declaration(const mtea::DataType dt, const std::string_view name, const bool flat);
+
+    struct SignalSource {
+        std::optional<size_t> input_port; // Set if the signal is a model input port
+        size_t block_id;
+        size_t port_num;
+    };
+
+    std::optional<SignalSource> find_signal_source(const size_t block_id, const size_t port_num) const;
+
+    // Provides an expression for the address of the storage of a signal, for binding ports in flat mode
+    std::string get_source_pointer(const SignalSource& src, const mtea::codegen::CodegenOptions& options) const;
+
+    // Provides an expression for the value of a signal, read directly from its storage in flat mode
+    std::string get_source_value(const SignalSource& src, const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_model_bind_function(const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_model_function_calls(const mtea::codegen::BlockFunction fcn,
+                                                      const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_flat_model_function_calls(const mtea::codegen::BlockFunction fcn,
+                                                           const mtea::codegen::CodegenOptions& options) const;
+
+    const ComponentVariable* find_block(const size_t block_id) const;
+
+    const ComponentVariable& block_at(const size_t block_id) const;
+
+    /* ==================== AMALGAMATED LAYOUT ==================== */
+
+    // Signal resolved through any nested models, to either an input of the root model or the output of a leaf block
+    struct FlatSignal {
+        std::optional<size_t> input_port;
+        std::string block_var;
+        std::string output_field;
+        size_t port_num;
+    };
+
+    struct FlatBlock {
+        std::string varname;
+        const mtea::codegen::CodeComponent* component;
+        std::vector<std::pair<std::string, FlatSignal>> inputs;
+        size_t rate_ticks;
+    };
+
+    // Location of a model within the flattened hierarchy, with the signals for each of its input ports and its period in base steps
+    struct FlatContext {
+        std::string prefix;
+        std::function<FlatSignal(size_t)> input_signal;
+        size_t rate_ticks;
+    };
+
+    struct FlatProgram {
+        std::vector<std::string> include_files;
+        std::vector<FlatBlock> blocks;
+        std::vector<FlatSignal> outputs;
+    };
+
+    static MemberList get_members(const FlatProgram& program);
+
+    FlatContext get_child_context(const FlatContext& ctx, const size_t block_id) const;
+
+    // Period of this model in base steps from its preferred step, where models preferring a faster step run at the rate of their parent
+    size_t get_rate_ticks(const size_t parent_ticks) const;
+
+    // Component of a block compiled for the period of its rate group, so that blocks taking the timestep as an argument match that period
+    const mtea::codegen::CodeComponent& get_rate_component(const size_t block_id, const size_t rate_ticks) const;
+
+    FlatSignal get_flat_signal(const FlatContext& ctx, const SignalSource& src) const;
+
+    void add_flat_blocks(const FlatContext& ctx, FlatProgram& program, const bool multi_rate) const;
+
+    FlatProgram get_flat_program(const mtea::codegen::CodegenOptions& options) const;
+
+    // Name of separate storage for a leaf block output, used for batched signal arrays and partition buffers
+    static std::string get_signal_storage_name(const FlatSignal& sig);
+
+    std::string get_flat_signal_value(const FlatSignal& sig, const size_t batch_size) const;
+
+    std::vector<std::string> write_amalgamated_implementation(const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_flat_function_lines(const FlatProgram& program, const mtea::codegen::BlockFunction fcn) const;
+
+    static std::vector<FlatSignal> get_batched_signals(const FlatProgram& program);
+
+    std::vector<std::string> get_batched_function_lines(const FlatProgram& program, const mtea::codegen::BlockFunction fcn,
+                                                        const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_batched_members(const FlatProgram& program, const mtea::codegen::CodegenOptions& options) const;
+
+    /* ==================== PARTITIONED SCHEDULE ==================== */
+
+    // Assignment of the flattened blocks to partitions, with the blocks and signals that cross between partitions
+    struct FlatSchedule {
+        size_t num_partitions{1};
+        std::vector<size_t> partition;
+        std::vector<bool> is_read_across;
+        std::vector<bool> reads_across;
+        std::vector<std::vector<size_t>> consumers;
+        std::vector<FlatSignal> buffered;
+    };
+
+    static std::unordered_map<std::string, size_t> get_flat_block_indices(const FlatProgram& program);
+
+    static FlatSchedule get_flat_schedule(const FlatProgram& program, const mtea::codegen::CodegenOptions& options);
+
+    static std::string get_buffer_name(const FlatSignal& sig);
+
+    static bool is_buffered(const FlatSchedule& schedule, const FlatSignal& sig);
+
+    static std::vector<std::string> get_partition_reset_lines(const FlatProgram& program, const FlatSchedule& schedule);
+
+    std::vector<std::string> get_partition_functions(const FlatProgram& program, const FlatSchedule& schedule) const;
+
+    static std::vector<std::string> get_partition_members(const FlatProgram& program, const FlatSchedule& schedule);
+
+    /* ==================== MULTI-RATE GROUPS ==================== */
+
+    // Signal read by a block in a different rate group to its source, passed through a rate transition buffer
+    struct RateTransition {
+        FlatSignal signal;
+        size_t from_group;
+        size_t to_group;
+    };
+
+    // Rate groups of the flattened blocks, in rate-monotonic order from the fastest group
+    struct FlatRates {
+        std::vector<size_t> ticks;
+        std::vector<size_t> group;
+        std::vector<RateTransition> transitions;
+    };
+
+    static FlatRates get_flat_rates(const FlatProgram& program);
+
+    // Name of a rate group from its period, such as 10ms
+    std::string get_rate_name(const size_t ticks) const;
+
+    std::string get_transition_name(const RateTransition& t, const FlatRates& rates) const;
+
+    std::vector<std::string> get_rate_reset_lines(const FlatRates& rates) const;
+
+    std::vector<std::string> get_rate_step_lines(const FlatRates& rates, const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_rate_functions(const FlatProgram& program, const FlatRates& rates,
+                                                const mtea::codegen::CodegenOptions& options) const;
+
+    std::vector<std::string> get_rate_members(const FlatRates& rates) const;
+
+private:
+    const mtea::Identifier _model_name;
+    const double _base_dt;
+    const double _rate_dt;
+    const std::shared_ptr<const mtea::Model::CompiledModelData> _model_data;
+    std::vector<mtea::DataType> _input_types;
+    std::vector<std::string> _input_names;
+    std::vector<mtea::DataType> _output_types;
+    std::vector<std::string> _output_names;
+    std::vector<std::optional<ComponentVariable>> _blocks;
+    const std::vector<std::shared_ptr<const BlockInterface>> _sources;
+    mutable std::map<std::pair<size_t, size_t>, std::unique_ptr<const mtea::codegen::CodeComponent>> _rate_components;
+    mutable std::mutex _rate_mutex;
+};
+
+}
+
+#endif // MTEA_DYNCODEGEN_MODEL_HPP
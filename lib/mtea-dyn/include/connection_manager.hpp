@@ -6,6 +6,7 @@
 #include "connection.hpp"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -26,8 +27,16 @@ public:
 
     std::vector<std::shared_ptr<const Connection>> get_connections() const;
 
+    std::vector<std::shared_ptr<const Connection>> get_connections_from(const size_t from_block) const;
+
+    std::vector<std::shared_ptr<const Connection>> get_connections_to(const size_t to_block) const;
+
 private:
+    void remove_from_index(const std::shared_ptr<Connection>& c);
+
     std::vector<std::shared_ptr<Connection>> connections;
+    std::unordered_map<size_t, std::vector<std::shared_ptr<Connection>>> from_index;
+    std::unordered_map<size_t, std::vector<std::shared_ptr<Connection>>> to_index;
 };
 
 void to_json(nlohmann::json& j, const ConnectionManager& cm);
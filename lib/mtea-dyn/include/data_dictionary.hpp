@@ -4,6 +4,7 @@
 #define MTEA_DYNDATA_DICTIONARY_HPP
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -12,6 +13,7 @@
 
 #include "codegen.hpp"
 #include "value.hpp"
+#include "value_array.hpp"
 #include "identifier.hpp"
 
 #include "mtea_types.hpp"
@@ -20,18 +22,40 @@
 
 namespace mtea {
 
+class MappedDataDictionary;
+
 class DataDictionary {
 public:
+    friend class MappedDataDictionary;
+
     DataDictionary() = default;
 
     void add_value(const Identifier& i, std::unique_ptr<ModelValue>&& val);
 
+    void add_array(const Identifier& i, std::unique_ptr<ValueArray>&& arr);
+
+    // Lookups only return entries held in memory, and never allocate. Entries of a mapped dictionary are read in place through
+    // get_mapped, and are only held in memory once converted with materialize_all
     ModelValue* get_value(const Identifier& i) const;
 
+    ValueArray* get_array(const Identifier& i) const;
+
     std::unique_ptr<mtea::Argument> get_arg_ptr();
 
     std::vector<std::pair<Identifier, ModelValue*>> get_values() const;
 
+    std::vector<std::pair<Identifier, ValueArray*>> get_arrays() const;
+
+    // Copies of every entry, including those that are only mapped, for converting the dictionary to another form
+    std::vector<std::pair<Identifier, std::unique_ptr<ModelValue>>> copy_values() const;
+
+    std::vector<std::pair<Identifier, std::unique_ptr<ValueArray>>> copy_arrays() const;
+
+    const MappedDataDictionary* get_mapped() const;
+
+    // Copies mapped entries into memory, so that they may be edited through get_value and get_array
+    void materialize_all();
+
     std::vector<std::string> write_code(codegen::CodeSection section) const;
 
     std::optional<std::string> name() const;
@@ -44,6 +68,8 @@ public:
 
 private:
     std::unordered_map<Identifier, std::unique_ptr<ModelValue>, Identifier::Hasher> vals;
+    std::unordered_map<Identifier, std::unique_ptr<ValueArray>, Identifier::Hasher> arrays;
+    std::shared_ptr<const MappedDataDictionary> mapped;
     std::optional<std::filesystem::path> save_path;
 };
 
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNEXECUTION_ARTIFACT_HPP
+#define MTEA_DYNEXECUTION_ARTIFACT_HPP
+
+#include <cstdint>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data_type.hpp"
+#include "value.hpp"
+#include "variable_manager.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace mtea {
+
+class Model;
+
+// Precompiled, flattened form of a model, containing everything needed to construct an executor without loading, updating
+// or compiling the source model files
+struct ExecutionArtifact {
+    // Leaf library block, connected to signals by slot index
+    struct Block {
+        std::string library;
+        std::string name;
+        std::vector<DataType> data_types;
+        std::shared_ptr<const ModelValue> argument;
+        std::vector<size_t> inputs;
+        std::vector<size_t> outputs;
+    };
+
+    // Root model variable, available for naming in the execution state
+    struct ModelSignal {
+        VariableIdentifier id;
+        size_t slot;
+    };
+
+    using SlotMap = std::unordered_map<VariableIdentifier, size_t>;
+
+    static const std::string FILE_EXTENSION;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    size_t add_signal(const DataType data_type);
+
+    bool is_current() const;
+
+    static size_t get_slot(const SlotMap& slots, const VariableIdentifier& id);
+
+    void save(const std::filesystem::path& path) const;
+
+    static ExecutionArtifact load(const std::filesystem::path& path);
+
+    static ExecutionArtifact from_model(const std::shared_ptr<Model> model, const double dt);
+
+    static uint64_t hash_sources(const std::vector<std::filesystem::path>& sources);
+
+    double dt{0.0};
+    std::vector<std::filesystem::path> sources;
+    uint64_t source_hash{0};
+    std::vector<DataType> signal_types;
+    std::vector<size_t> output_slots;
+    std::vector<ModelSignal> model_signals;
+    std::vector<Block> blocks; // Defines blocks in execution order
+};
+
+void to_json(nlohmann::json& j, const ExecutionArtifact& a);
+void from_json(const nlohmann::json& j, ExecutionArtifact& a);
+
+}
+
+#endif // MTEA_DYNEXECUTION_ARTIFACT_HPP
@@ -10,14 +10,20 @@
 #include <unordered_map>
 
 #include "block_interface.hpp"
+#include "execution_artifact.hpp"
 #include "model.hpp"
+#include "symbol.hpp"
+#include "tunable_parameters.hpp"
 #include "variable_manager.hpp"
 
 namespace mtea {
 
+class ModelManager;
+
 class ExecutionState {
 public:
-    ExecutionState(std::shared_ptr<BlockExecutionInterface> model, std::shared_ptr<VariableManager> variables, const double dt);
+    ExecutionState(std::shared_ptr<BlockExecutionInterface> model, std::shared_ptr<VariableManager> variables,
+                   std::shared_ptr<TunableParameters::Bindings> parameters, const double dt);
 
     void init();
 
@@ -47,6 +53,8 @@ public:
 
     static ExecutionState from_model(const std::shared_ptr<Model> model, const double dt);
 
+    static ExecutionState from_artifact(const ExecutionArtifact& artifact, const ModelManager& session);
+
 protected:
     std::shared_ptr<const ModelExecutionInterface> get_model_exec_interface() const;
 
@@ -55,7 +63,8 @@ protected:
 private:
     std::shared_ptr<BlockExecutionInterface> model;
     std::shared_ptr<VariableManager> variables;
-    std::unordered_map<std::string, std::shared_ptr<const ModelValue>> named_variables;
+    std::unordered_map<Symbol, std::shared_ptr<const ModelValue>, Symbol::Hasher> named_variables;
+    std::shared_ptr<TunableParameters::Bindings> parameters;
     BlockInterface::ModelInfo state;
     uint64_t iterations{0};
 };
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNFIXED_POINT_HPP
+#define MTEA_DYNFIXED_POINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+
+namespace mtea {
+
+// Binary-point scaling of an integer value, where a raw value r represents r * 2^-fraction_length. Block ports don't carry a
+// scaling, and so this only describes the scalings proposed for signals by the scaling tool
+class FixedPointType {
+public:
+    FixedPointType(const bool is_signed, const size_t word_length, const int fraction_length);
+
+    bool is_signed() const { return _is_signed; }
+
+    size_t get_word_length() const { return _word_length; }
+
+    int get_fraction_length() const { return _fraction_length; }
+
+    bool operator==(const FixedPointType& other) const = default;
+
+    int64_t get_min_raw() const;
+
+    int64_t get_max_raw() const;
+
+    double get_resolution() const;
+
+    double get_min() const;
+
+    double get_max() const;
+
+    double to_double(const int64_t raw) const;
+
+    // Name in the form sfix16_En8, for a signed 16-bit word with 8 fraction bits, or ufix8_E2 for an unsigned word scaled by 2^2
+    std::string to_string() const;
+
+    static FixedPointType from_string(std::string_view s);
+
+    // Finest scaling for the word length that holds the range without saturating
+    static FixedPointType propose(const double min, const double max, const size_t word_length);
+
+    // Products of any two words are exact in 64-bit arithmetic, for integer code using a proposed scaling, which limits unsigned
+    // words to one bit less
+    static constexpr size_t MAX_WORD_LENGTH = 32;
+    static constexpr size_t MAX_UNSIGNED_WORD_LENGTH = 31;
+
+private:
+    bool _is_signed;
+    size_t _word_length;
+    int _fraction_length;
+};
+
+}
+
+#endif // MTEA_DYNFIXED_POINT_HPP
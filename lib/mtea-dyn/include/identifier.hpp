@@ -8,6 +8,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include "symbol.hpp"
+
 namespace mtea {
 
 class Identifier;
@@ -36,13 +38,15 @@ public:
 
     void set(std::string_view s);
 
+    const Symbol& get_symbol() const;
+
 public:
     struct Hasher {
         size_t operator()(const Identifier& other) const;
     };
 
 private:
-    std::string _value;
+    Symbol _value;
 
 public:
     static bool is_valid_identifier(std::string_view s);
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "block_interface.hpp"
+#include "execution_artifact.hpp"
 
 namespace mtea {
 
@@ -24,6 +25,10 @@ public:
     virtual std::unique_ptr<BlockInterface> create_block(std::string_view name) const = 0;
 
     virtual std::unique_ptr<BlockInterface> try_create_block(std::string_view name) const;
+
+    virtual std::unique_ptr<BlockExecutionInterface> create_executor(const ExecutionArtifact::Block& block,
+                                                                     std::vector<std::shared_ptr<const ModelValue>>&& inputs,
+                                                                     std::vector<std::shared_ptr<ModelValue>>&& outputs) const;
 };
 
 }
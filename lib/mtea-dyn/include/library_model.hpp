@@ -11,14 +11,22 @@
 #include "library.hpp"
 #include "model.hpp"
 #include "model_block.hpp"
+#include "symbol.hpp"
+#include "workspace_index.hpp"
 
 namespace mtea {
 
+class ModelManager;
+
 class ModelLibrary : public LibraryBase {
 protected:
-    using model_map_t = std::unordered_map<std::string, std::shared_ptr<Model>>;
+    using model_map_t = std::unordered_map<Symbol, std::shared_ptr<Model>, Symbol::Hasher>;
 
 public:
+    explicit ModelLibrary(ModelManager& manager);
+
+    [[nodiscard]] ModelManager& get_manager() const;
+
     [[nodiscard]] const std::string get_library_name() const override;
 
     [[nodiscard]] std::vector<std::string> get_block_names() const override;
@@ -47,6 +55,12 @@ public:
 
     [[nodiscard]] std::shared_ptr<Model> try_get_model(std::string_view name) const;
 
+    void set_workspace_index(std::shared_ptr<WorkspaceIndex> index);
+
+    [[nodiscard]] std::shared_ptr<WorkspaceIndex> get_workspace_index() const;
+
+    [[nodiscard]] std::filesystem::path find_submodel_path(const std::filesystem::path& parent, std::string_view name) const;
+
 protected:
     [[nodiscard]] model_map_t::iterator find_model(const Model* mdl);
     [[nodiscard]] model_map_t::const_iterator find_model(const Model* mdl) const;
@@ -55,7 +69,9 @@ protected:
 
 private:
     inline static std::string library_name = "models";
-    std::unordered_map<std::string, std::shared_ptr<Model>> models;
+    ModelManager& manager;
+    model_map_t models;
+    std::shared_ptr<WorkspaceIndex> workspace_index;
 };
 
 }
@@ -4,8 +4,10 @@
 #define MTEA_DYNSTDLIB_HPP
 
 #include "library.hpp"
+#include "tunable_parameters.hpp"
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -15,7 +17,7 @@ namespace blocks {
 
 class StandardLibrary : public LibraryBase {
 public:
-    StandardLibrary();
+    explicit StandardLibrary(std::shared_ptr<TunableParameters> parameters);
 
     bool has_block(std::string_view name) const override;
 
@@ -25,9 +27,18 @@ public:
 
     std::unique_ptr<BlockInterface> create_block(std::string_view name) const override;
 
+    std::unique_ptr<BlockExecutionInterface> create_executor(const ExecutionArtifact::Block& block,
+                                                             std::vector<std::shared_ptr<const ModelValue>>&& inputs,
+                                                             std::vector<std::shared_ptr<ModelValue>>&& outputs) const override;
+
 private:
     inline static std::string library_name = "stdlib";
+    std::shared_ptr<TunableParameters> parameters;
     std::unordered_map<std::string, std::function<std::unique_ptr<BlockInterface>()>> block_map;
+    std::unordered_map<std::string, std::function<std::unique_ptr<BlockExecutionInterface>(
+                                        const ExecutionArtifact::Block&, std::vector<std::shared_ptr<const ModelValue>>&&,
+                                        std::vector<std::shared_ptr<ModelValue>>&&)>>
+        executor_map;
 };
 
 }
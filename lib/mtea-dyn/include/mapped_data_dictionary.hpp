@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMAPPED_DATA_DICTIONARY_HPP
+#define MTEA_DYNMAPPED_DATA_DICTIONARY_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "data_type.hpp"
+#include "mapped_file.hpp"
+#include "model_exception.hpp"
+#include "value.hpp"
+#include "value_array.hpp"
+
+namespace mtea {
+
+class DataDictionary;
+
+// Binary data dictionary file with a sorted key index and natively typed scalar and array payloads. The file is mapped and read
+// in place, so that opening a dictionary does not depend on the number of entries and lookups do not allocate
+class MappedDataDictionary {
+public:
+    // Typed view of an entry within the mapped file
+    struct Entry {
+        std::string_view name;
+        DataType data_type;
+        bool is_array;
+        size_t cols;
+        size_t rows;
+        std::span<const char> data; // Elements are stored column-major, matching ValueArray
+
+        size_t size() const { return cols * rows; }
+
+        template <DataType DT> typename data_type_t<DT>::type_t get(const size_t i = 0) const {
+            using type_t = typename data_type_t<DT>::type_t;
+
+            if (DT != data_type) {
+                throw ModelException("mismatch in data type - unable to read dictionary entry");
+            } else if (i >= size()) {
+                throw ModelException("dictionary entry index out of range");
+            }
+
+            type_t value;
+            std::memcpy(&value, data.data() + i * sizeof(type_t), sizeof(type_t));
+            return value;
+        }
+
+        std::unique_ptr<ModelValue> to_value(const size_t i = 0) const;
+
+        std::unique_ptr<ValueArray> to_array() const;
+    };
+
+    static const std::string FILE_EXTENSION;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    explicit MappedDataDictionary(const std::filesystem::path& path);
+
+    const std::filesystem::path& get_path() const;
+
+    size_t size() const;
+
+    Entry get_entry(const size_t i) const;
+
+    std::optional<Entry> find(std::string_view name) const;
+
+    static bool is_binary_path(const std::filesystem::path& path);
+
+    static void write(const DataDictionary& dict, const std::filesystem::path& path);
+
+private:
+    std::string_view get_name(const size_t i) const;
+
+    const std::filesystem::path path;
+    const MappedFile file;
+    std::span<const char> entries;
+    std::span<const char> string_data;
+    std::span<const char> payload;
+};
+
+}
+
+#endif // MTEA_DYNMAPPED_DATA_DICTIONARY_HPP
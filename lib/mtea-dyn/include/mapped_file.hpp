@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMAPPED_FILE_HPP
+#define MTEA_DYNMAPPED_FILE_HPP
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace mtea {
+
+// Read-only contents of a file, memory-mapped where supported and otherwise read into memory
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    std::span<const char> get_data() const;
+
+private:
+    void* addr{nullptr};
+    size_t size{0};
+    std::vector<char> buffer;
+};
+
+}
+
+#endif // MTEA_DYNMAPPED_FILE_HPP
@@ -5,12 +5,16 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "block_interface.hpp"
+#include "block_store.hpp"
 #include "connection_manager.hpp"
+#include "execution_artifact.hpp"
 
 #include <nlohmann/json.hpp>
 
@@ -23,6 +27,11 @@ public:
 
 class Model;
 class ModelLibrary;
+class ModelBinaryFormat;
+class ModelLoader;
+class ModelJournal;
+class ModelManager;
+class ParsedModelFile;
 
 void to_json(nlohmann::json& j, const Model& m);
 void from_json(const nlohmann::json& j, Model& m);
@@ -31,6 +40,15 @@ class Model {
 public:
     friend class ModelBlock;
     friend class ModelLibrary;
+    friend class ModelBinaryFormat;
+    friend class ModelLoader;
+    friend class WorkspaceIndex;
+
+    explicit Model(ModelManager& manager);
+
+    ~Model();
+
+    ModelManager& get_manager() const;
 
     void set_unsaved_changes();
 
@@ -70,20 +88,59 @@ public:
 
     bool update_block();
 
+    // Parameter edits mark their block automatically, while other edits made directly on a block are only propagated once marked
+    void mark_block_changed(const size_t id);
+
+    // Location and orientation changes are only journaled, and so saved, once the block is marked
+    void mark_block_layout_changed(const size_t id);
+
+    void mark_connection_changed(const size_t to_block, const size_t to_port);
+
+    struct UpdateStatistics {
+        size_t update_calls{0};
+        size_t last_evaluations{0};
+        size_t total_evaluations{0};
+    };
+
+    const UpdateStatistics& get_update_statistics() const;
+
+    uint64_t get_version() const;
+
     std::unique_ptr<const BlockError> has_error() const;
 
     struct CompiledModelData;
 
+    struct CompileCacheStatistics {
+        size_t hits{0};
+        size_t misses{0};
+    };
+
+    CompileCacheStatistics get_compile_cache_statistics() const;
+
 protected:
     std::unique_ptr<const BlockError> own_error() const;
 
-    CompiledModelData compile_model() const;
+    std::shared_ptr<const CompiledModelData> compile_model() const;
+
+    CompiledModelData build_compiled_model() const;
+
+    struct ExecutionTemplate;
+
+    std::shared_ptr<const ExecutionTemplate> get_execution_template(const BlockInterface::ModelInfo& state) const;
+
+    void mark_structure_changed();
+
+    uint64_t get_submodel_version(const size_t id) const;
 
 public:
     std::unique_ptr<ModelExecutionInterface> get_execution_interface(const size_t block_id, const ConnectionManager& connections,
                                                                      const VariableManager& manager,
                                                                      const BlockInterface::ModelInfo& state) const;
 
+    ExecutionArtifact::SlotMap add_to_artifact(const size_t block_id, const ConnectionManager& connections,
+                                               const ExecutionArtifact::SlotMap& slots, const BlockInterface::ModelInfo& state,
+                                               ExecutionArtifact& artifact) const;
+
     std::unique_ptr<codegen::CodeComponent> get_codegen_component(const BlockInterface::ModelInfo& state) const;
 
     std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> get_all_sub_components(const BlockInterface::ModelInfo& state) const;
@@ -93,11 +150,16 @@ public:
     const ConnectionManager& get_connection_manager() const;
 
 protected:
-    size_t get_next_id() const;
+    size_t get_next_id();
 
 public:
     std::shared_ptr<BlockInterface> get_block(const size_t id) const;
 
+    BlockStore::Handle get_block_handle(const size_t id) const;
+
+    // Returns null if the block has been removed, even if its ID has since been reused
+    std::shared_ptr<BlockInterface> find_block(const BlockStore::Handle& handle) const;
+
     std::vector<std::shared_ptr<BlockInterface>> get_blocks() const;
 
     bool contains_model_name(const std::string_view name) const;
@@ -107,23 +169,63 @@ private:
 
     void clear_filename();
 
-    static std::shared_ptr<Model> load_model(const std::filesystem::path& path);
+    class JsonLoader;
+
+    class JsonParsedFile;
+
+    static std::unique_ptr<ParsedModelFile> parse_file(const std::filesystem::path& path);
 
     void save_model() const;
 
+    std::unique_ptr<BlockInterface> create_saved_block(const std::string_view full_name, const size_t id, const BlockLocation& loc,
+                                                       const bool inverted) const;
+
+    void insert_saved_block(std::unique_ptr<BlockInterface>&& blk);
+
+    void watch_parameters(const BlockInterface& blk);
+
+    static void unwatch_parameters(const BlockInterface& blk);
+
+    void complete_load();
+
+    BlockLocation get_block_offset() const;
+
+    void open_journal();
+
+    void apply_journal_entry(const nlohmann::json& entry);
+
+    void record_journal_entry(nlohmann::json&& entry) const;
+
+    void record_block_entry(const std::string_view op, const BlockInterface& blk) const;
+
 public:
     const std::optional<std::filesystem::path>& get_filename() const;
 
 private:
+    ModelManager* manager;
     std::optional<Identifier> name;
     std::string description{"user-defined model block"};
-    std::unordered_map<size_t, std::shared_ptr<BlockInterface>> blocks;
+    BlockStore blocks;
     ConnectionManager connections;
     std::vector<size_t> input_ids;
     std::vector<size_t> output_ids;
+    std::unordered_set<size_t> submodel_ids;
+    std::vector<size_t> pending_updates;
+    std::unordered_map<size_t, uint64_t> submodel_versions;
+    bool pending_full_update{true};
+    UpdateStatistics update_statistics;
+    uint64_t structure_version{0};
+    mutable std::mutex cache_mutex;
+    mutable std::shared_ptr<const CompiledModelData> compiled_cache;
+    mutable uint64_t compiled_cache_version{0};
+    mutable CompileCacheStatistics compile_cache_statistics;
+    mutable std::shared_ptr<const ExecutionTemplate> execution_template;
+    mutable uint64_t execution_template_version{0};
     double preferred_dt{0.1};
     std::optional<std::filesystem::path> filename;
     mutable bool has_unsaved_changed{ false };
+    mutable std::shared_ptr<ModelJournal> journal;
+    mutable BlockLocation journal_offset{};
 
 public:
     static const std::string DEFAULT_MODEL_EXTENSION;
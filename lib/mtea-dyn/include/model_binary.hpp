@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMODEL_BINARY_HPP
+#define MTEA_DYNMODEL_BINARY_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace mtea {
+
+class Model;
+class ParsedModelFile;
+
+// Binary model file format, storing interned strings, fixed-layout block, parameter and connection tables, and natively typed
+// parameter values, so that the file can be memory-mapped and read in place rather than parsed
+class ModelBinaryFormat {
+public:
+    static const std::string FILE_EXTENSION;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    static bool is_binary_path(const std::filesystem::path& path);
+
+    static void write(const Model& model, const std::filesystem::path& path);
+
+    static std::unique_ptr<ParsedModelFile> parse(const std::filesystem::path& path);
+
+private:
+    class ParsedFile;
+};
+
+}
+
+#endif // MTEA_DYNMODEL_BINARY_HPP
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMODEL_COMPILED_DATA_HPP
+#define MTEA_DYNMODEL_COMPILED_DATA_HPP
+
+#include <limits>
+#include <vector>
+
+#include "model.hpp"
+
+// Shared by the model and its code component, which both read the compiled links and execution order
+struct mtea::Model::CompiledModelData {
+    struct Links {
+        struct Block {
+            size_t block_id;
+            size_t port_num;
+        };
+
+        std::vector<std::vector<Block>> input_port_links;              // Defines input ports -> block input ports
+        std::vector<Block> output_port_links;                          // Defines output ports <- block output ports
+        std::vector<std::vector<std::vector<Block>>> component_links; // Defines dense index -> output port -> block input ports
+    };
+
+    static constexpr size_t NO_INDEX = std::numeric_limits<size_t>::max();
+
+    size_t get_dense_index(const size_t block_id) const {
+        return block_id < dense_index.size() ? dense_index[block_id] : NO_INDEX;
+    }
+
+    Links links;
+    std::vector<size_t> block_ids;   // Defines dense index -> block id, in ascending id order
+    std::vector<size_t> dense_index; // Defines block id -> dense index, or NO_INDEX for unused ids
+    std::vector<size_t> execution_order;
+    std::vector<DataType> input_types;
+    std::vector<DataType> output_types;
+};
+
+#endif // MTEA_DYNMODEL_COMPILED_DATA_HPP
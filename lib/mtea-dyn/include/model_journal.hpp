@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMODEL_JOURNAL_HPP
+#define MTEA_DYNMODEL_JOURNAL_HPP
+
+#include <cstdint>
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace mtea {
+
+// Append-only log of the edits made to a JSON model file since it was last written, stored alongside the model file.
+// Committed entries are compacted into the model file on a background thread, and any entries remaining after a crash
+// are replayed when the model is next loaded
+class ModelJournal {
+public:
+    static const std::string FILE_EXTENSION;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    ModelJournal(const ModelJournal&) = delete;
+
+    ModelJournal& operator=(const ModelJournal&) = delete;
+
+    ~ModelJournal();
+
+    const std::filesystem::path& get_model_path() const;
+
+    std::vector<nlohmann::json> get_entries() const;
+
+    size_t get_num_committed() const;
+
+    std::optional<std::string> get_last_error() const;
+
+    void append(nlohmann::json&& entry);
+
+    void commit();
+
+    void discard_uncommitted();
+
+    void wait_idle();
+
+    static std::shared_ptr<ModelJournal> create(const std::filesystem::path& model_path);
+
+    static std::shared_ptr<ModelJournal> open(const std::filesystem::path& model_path);
+
+    static void remove(const std::filesystem::path& model_path);
+
+    static std::filesystem::path get_journal_path(const std::filesystem::path& model_path);
+
+    static void apply(nlohmann::json& model, const nlohmann::json& entry);
+
+private:
+    ModelJournal(const std::filesystem::path& model_path, const uint64_t base_hash, std::vector<nlohmann::json>&& entries,
+                 const size_t committed);
+
+    static void write_journal(const std::filesystem::path& path, const uint64_t base_hash, const std::vector<nlohmann::json>& entries,
+                              const size_t committed);
+
+    void reopen_stream();
+
+    void run();
+
+    void compact();
+
+    const std::filesystem::path model_path;
+    uint64_t base_hash;
+    std::vector<nlohmann::json> entries;
+    size_t committed;
+    std::ofstream stream;
+    std::optional<std::string> last_error;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool compact_requested{false};
+    bool compacting{false};
+    bool stopping{false};
+    std::thread worker;
+};
+
+}
+
+#endif // MTEA_DYNMODEL_JOURNAL_HPP
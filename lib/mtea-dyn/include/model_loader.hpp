@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNMODEL_LOADER_HPP
+#define MTEA_DYNMODEL_LOADER_HPP
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mtea {
+
+class Model;
+class ModelLibrary;
+
+// A model file that has been read and parsed, but whose blocks have not yet been instantiated
+class ParsedModelFile {
+public:
+    virtual ~ParsedModelFile() = default;
+
+    virtual std::vector<std::string> get_block_names() const = 0;
+
+    virtual std::string get_description() const = 0;
+
+    virtual size_t get_num_inputs() const = 0;
+
+    virtual size_t get_num_outputs() const = 0;
+
+    virtual void load_into(Model& model) const = 0;
+};
+
+// Loads a model along with every submodel it references, parsing the files of the dependency closure in parallel
+// and then instantiating the models in dependency order
+class ModelLoader {
+public:
+    explicit ModelLoader(ModelLibrary& library, const size_t num_threads = 0);
+
+    std::shared_ptr<Model> load(const std::filesystem::path& path);
+
+    static std::filesystem::path find_submodel_path(const std::filesystem::path& parent, std::string_view name);
+
+private:
+    ModelLibrary& library;
+    size_t num_threads;
+};
+
+}
+
+#endif // MTEA_DYNMODEL_LOADER_HPP
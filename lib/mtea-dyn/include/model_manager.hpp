@@ -3,21 +3,28 @@
 #ifndef MTEA_DYNMANAGER_HPP
 #define MTEA_DYNMANAGER_HPP
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "data_dictionary.hpp"
 #include "library.hpp"
 #include "library_model.hpp"
+#include "symbol.hpp"
+#include "tunable_parameters.hpp"
 
 namespace mtea {
 
+// Session owning a set of block libraries, the model library and data dictionaries. Independent sessions may be used from
+// separate threads, and the library and dictionary registries of a session may be read concurrently with registration
 class ModelManager {
 public:
-    static ModelManager& get_instance(); // TODO - Remove Singleton
+    static ModelManager& get_instance(); // Default session, used by the editor
 
-protected:
     ModelManager();
 
     ModelManager(const ModelManager&) = delete;
@@ -25,12 +32,12 @@ protected:
     ModelManager& operator=(const ModelManager&) = delete;
     ModelManager& operator=(ModelManager&&) = delete;
 
-public:
     LibraryBase* register_library(std::string_view name, std::unique_ptr<LibraryBase>&& library);
 
-    std::unique_ptr<LibraryBase> deregister_library(std::string_view name);
+    std::shared_ptr<LibraryBase> deregister_library(std::string_view name);
 
-    LibraryBase* get_library(std::string_view name) const;
+    // Lookups share ownership with the registry, so that a result stays valid if it is deregistered from another thread
+    std::shared_ptr<LibraryBase> get_library(std::string_view name) const;
 
     std::vector<std::string> get_library_names() const;
 
@@ -46,26 +53,38 @@ public:
 
     void dict_close(std::string_view name);
 
-    DataDictionary* get_data(std::string_view name) const;
+    std::shared_ptr<DataDictionary> get_data(std::string_view name) const;
+
+    std::shared_ptr<const ModelValue> get_dictionary_value(std::string_view name) const;
 
-    ModelValue* get_dictionary_value(std::string_view name) const;
+    std::shared_ptr<TunableParameters> get_tunable_parameters() const;
 
 private:
+    using library_map_t = std::unordered_map<Symbol, std::shared_ptr<LibraryBase>, Symbol::Hasher>;
+    using dictionary_map_t = std::unordered_map<Symbol, std::shared_ptr<DataDictionary>, Symbol::Hasher>;
+
     template <typename T> T* register_library_type(std::string_view name, std::unique_ptr<T>&& library) {
-        const auto sname = std::string(name);
+        const auto sname = Symbol(name);
         auto ptr = library.get();
 
-        if (const auto it = libraries.find(sname); it != libraries.end()) {
+        std::lock_guard lock(write_mutex);
+        auto updated = std::make_shared<library_map_t>(*libraries.load());
+
+        if (const auto it = updated->find(sname); it != updated->end()) {
             throw ModelException("library name already exists in manager");
         }
 
-        libraries.emplace(std::make_pair(sname, std::move(library)));
+        updated->emplace(std::make_pair(sname, std::shared_ptr<LibraryBase>(std::move(library))));
+        libraries.store(std::move(updated));
         return ptr;
     }
 
-private:
-    std::unordered_map<std::string, std::unique_ptr<LibraryBase>> libraries;
-    std::unordered_map<std::string, std::unique_ptr<DataDictionary>> dictionaries;
+    // Registries are immutable snapshots, which are copied and replaced on update so that lookups never take a lock
+    std::atomic<std::shared_ptr<const library_map_t>> libraries{std::make_shared<const library_map_t>()};
+    std::atomic<std::shared_ptr<const dictionary_map_t>> dictionaries{std::make_shared<const dictionary_map_t>()};
+    std::mutex write_mutex;
+
+    std::shared_ptr<TunableParameters> tunable_parameters;
     ModelLibrary* model_library;
 };
 
@@ -6,6 +6,7 @@
 #include "data_type.hpp"
 #include "value.hpp"
 
+#include <functional>
 #include <string>
 
 namespace mtea {
@@ -24,10 +25,17 @@ public:
     virtual std::string get_value_string() const = 0;
     virtual void set_value_string(std::string_view val) = 0;
 
+    // Called after each change to the value, so that the model owning the block can mark it as changed
+    void set_change_callback(std::function<void()> callback);
+
+protected:
+    void notify_changed() const;
+
 private:
     const std::string id;
     std::string name;
     bool enabled{true};
+    std::function<void()> change_callback;
 };
 
 class ParameterDataType : public Parameter {
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNSYMBOL_HPP
+#define MTEA_DYNSYMBOL_HPP
+
+#include <cstdint>
+
+#include <deque>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace mtea {
+
+class SymbolTable;
+
+// Handle to an interned string. Symbols for the same string always refer to the same table entry, so that comparison is a
+// pointer comparison and the hash is computed once when the string is first interned
+class Symbol {
+public:
+    Symbol();
+
+    explicit Symbol(std::string_view s);
+
+    bool operator==(const Symbol& other) const { return entry == other.entry; }
+
+    const std::string& str() const { return entry->value; }
+
+    size_t hash() const { return entry->hash; }
+
+    uint32_t id() const { return entry->id; }
+
+    bool empty() const { return entry->value.empty(); }
+
+    struct Hasher {
+        size_t operator()(const Symbol& s) const { return s.hash(); }
+    };
+
+    // Orders by the interned string, rather than the symbol id, so that sorted output does not depend on interning order
+    struct Less {
+        bool operator()(const Symbol& a, const Symbol& b) const { return a.str() < b.str(); }
+    };
+
+private:
+    struct Entry {
+        std::string value;
+        size_t hash;
+        uint32_t id;
+    };
+
+    explicit Symbol(const Entry* entry) : entry(entry) {}
+
+    const Entry* entry;
+
+    friend class SymbolTable;
+};
+
+// Process-wide thread-safe interner for identifiers and library-qualified names
+class SymbolTable {
+public:
+    static SymbolTable& get_instance();
+
+    SymbolTable(const SymbolTable&) = delete;
+
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    Symbol intern(std::string_view s);
+
+    std::optional<Symbol> find(std::string_view s) const;
+
+    Symbol qualify(const Symbol& scope, const Symbol& name);
+
+    size_t size() const;
+
+    static constexpr std::string_view SCOPE_SEPARATOR = "::";
+
+private:
+    SymbolTable();
+
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    mutable std::shared_mutex mutex;
+    std::deque<Symbol::Entry> storage; // Entries are never removed, and a deque keeps their addresses stable
+    std::unordered_map<std::string_view, const Symbol::Entry*, StringHash, std::equal_to<>> lookup;
+    std::map<std::pair<uint32_t, uint32_t>, const Symbol::Entry*> qualified;
+};
+
+}
+
+#endif // MTEA_DYNSYMBOL_HPP
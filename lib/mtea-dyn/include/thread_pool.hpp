@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNTHREAD_POOL_HPP
+#define MTEA_DYNTHREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mtea {
+
+// Fixed set of worker threads that take submitted tasks in order, used to parallelise model loading and code generation
+class ThreadPool {
+public:
+    explicit ThreadPool(const size_t num_threads) {
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+
+        cv.notify_all();
+
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    template <typename F> auto submit(F&& func) {
+        using result_t = std::invoke_result_t<F>;
+
+        auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(func));
+        auto result = task->get_future();
+
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace_back([task]() { (*task)(); });
+        }
+
+        cv.notify_one();
+        return result;
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                // Remaining tasks are abandoned on shutdown, as their results are no longer wanted
+                if (stopping) {
+                    return;
+                }
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping{false};
+};
+
+}
+
+#endif // MTEA_DYNTHREAD_POOL_HPP
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNTUNABLE_PARAMETERS_HPP
+#define MTEA_DYNTUNABLE_PARAMETERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "data_type.hpp"
+#include "identifier.hpp"
+#include "value.hpp"
+
+namespace mtea {
+
+class DataDictionary;
+
+// Session-wide values for tunable parameters. Edits may be made from any thread, and are published as a new version that each
+// executor copies into its own storage at its next step boundary, so that a step never observes a partially applied edit
+class TunableParameters {
+public:
+    using resolver_t = std::function<std::shared_ptr<const ModelValue>(const Identifier&)>;
+
+    // Storage owned by a single executor, which running blocks read through stable pointers
+    class Bindings {
+    public:
+        explicit Bindings(std::shared_ptr<TunableParameters> parameters);
+
+        Bindings(const Bindings&) = delete;
+
+        Bindings& operator=(const Bindings&) = delete;
+
+        std::shared_ptr<ModelValue> get_storage(const Identifier& name, const DataType dtype);
+
+        // Only called by the owning executor, between its steps
+        void apply_pending();
+
+    private:
+        std::shared_ptr<TunableParameters> parameters;
+        std::unordered_map<Identifier, std::vector<std::shared_ptr<ModelValue>>, Identifier::Hasher> storage;
+        uint64_t applied_version{0};
+    };
+
+    // Binds the blocks created on this thread to the given storage while the scope is alive
+    class BindScope {
+    public:
+        explicit BindScope(Bindings& bindings);
+
+        BindScope(const BindScope&) = delete;
+
+        BindScope& operator=(const BindScope&) = delete;
+
+        ~BindScope();
+
+    private:
+        Bindings* previous;
+    };
+
+    explicit TunableParameters(resolver_t resolver);
+
+    TunableParameters(const TunableParameters&) = delete;
+
+    TunableParameters& operator=(const TunableParameters&) = delete;
+
+    // Returns storage from the bindings of the executor under construction on this thread
+    std::shared_ptr<ModelValue> get_storage(const Identifier& name, const DataType dtype);
+
+    std::vector<Identifier> get_names() const;
+
+    void set_value(const Identifier& name, const ModelValue* value);
+
+    // Merges the dictionary values into the published set, keeping any other values already set
+    void set_values(const DataDictionary& dict);
+
+    uint64_t get_version() const;
+
+private:
+    using value_map_t = std::unordered_map<Identifier, std::unique_ptr<ModelValue>, Identifier::Hasher>;
+
+    std::unique_ptr<ModelValue> get_initial_value(const Identifier& name, const DataType dtype);
+
+    resolver_t resolver;
+
+    mutable std::mutex mutex;
+    value_map_t values;
+    std::unordered_set<Identifier, Identifier::Hasher> bound_names;
+    std::atomic<uint64_t> version{0};
+};
+
+}
+
+#endif // MTEA_DYNTUNABLE_PARAMETERS_HPP
@@ -38,8 +38,22 @@ struct ModelValue {
 
     static std::unique_ptr<ModelValue> make_default(const DataType dtype);
 
+    static size_t storage_size(const DataType dtype);
+
+    static size_t storage_alignment(const DataType dtype);
+
+    static ModelValue* make_default_at(void* ptr, const DataType dtype);
+
     static std::unique_ptr<ModelValue> from_string(std::string_view s, const DataType dt);
 
+    static constexpr size_t RAW_VALUE_SIZE = 8;
+
+    static size_t raw_size(const DataType dtype);
+
+    static void to_raw(const ModelValue* val, void* dst);
+
+    static std::unique_ptr<ModelValue> from_raw(const void* src, const DataType dt);
+
     static std::unique_ptr<ModelValue> convert_type(const ModelValue* val, const DataType dt);
 
     template <DataType DT> static const typename data_type_t<DT>::type_t& get_inner_value(const ModelValue* value) {
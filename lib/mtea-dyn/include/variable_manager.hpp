@@ -6,7 +6,12 @@
 #include "connection.hpp"
 #include "value.hpp"
 
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace mtea {
 
@@ -31,8 +36,53 @@ template <> struct hash<mtea::VariableIdentifier> {
 
 namespace mtea {
 
+class SignalLayout {
+public:
+    struct Entry {
+        VariableIdentifier id;
+        DataType data_type;
+        size_t offset;
+    };
+
+    void add_variable(const VariableIdentifier id, const DataType data_type);
+
+    std::optional<size_t> find(const VariableIdentifier& id) const;
+
+    const std::vector<Entry>& get_entries() const;
+
+    size_t get_size() const;
+
+private:
+    static constexpr size_t NO_SLOT = std::numeric_limits<size_t>::max();
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<size_t>> index; // Defines block id -> output port -> entry slot
+    size_t size{0};
+};
+
+class SignalSlab {
+public:
+    explicit SignalSlab(std::shared_ptr<const SignalLayout> layout);
+
+    SignalSlab(const SignalSlab&) = delete;
+    SignalSlab& operator=(const SignalSlab&) = delete;
+
+    ~SignalSlab();
+
+    ModelValue* get_value(const size_t slot) const;
+
+private:
+    std::shared_ptr<const SignalLayout> layout;
+    std::unique_ptr<std::max_align_t[]> data;
+    std::vector<ModelValue*> values;
+};
+
 class VariableManager {
 public:
+    VariableManager() = default;
+
+    explicit VariableManager(std::shared_ptr<const SignalLayout> layout);
+
     void add_variable(const VariableIdentifier id, const std::shared_ptr<ModelValue> value);
 
     std::shared_ptr<ModelValue> get_ptr(const VariableIdentifier& id) const;
@@ -45,6 +95,8 @@ public:
 
 private:
     std::unordered_map<VariableIdentifier, std::shared_ptr<ModelValue>> variables;
+    std::shared_ptr<const SignalLayout> layout;
+    std::shared_ptr<SignalSlab> slab;
 };
 
 }
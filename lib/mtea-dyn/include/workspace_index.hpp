@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNWORKSPACE_INDEX_HPP
+#define MTEA_DYNWORKSPACE_INDEX_HPP
+
+#include <cstdint>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace mtea {
+
+// Persistent index of the model files within a workspace directory tree, caching the name, port signature, description and
+// submodel dependencies of each model so that models can be browsed and dependencies resolved without reading model files.
+// Files are only parsed again when their modification time, size and content hash change
+class WorkspaceIndex {
+public:
+    struct Entry {
+        std::filesystem::path path; // Relative to the workspace root
+        std::string name;
+        std::string description;
+        size_t num_inputs{0};
+        size_t num_outputs{0};
+        std::vector<std::string> dependencies; // Names of the submodels referenced by the model
+        int64_t mtime{0};
+        uint64_t size{0};
+        uint64_t content_hash{0};
+    };
+
+    static const std::string FILE_NAME;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    explicit WorkspaceIndex(const std::filesystem::path& root);
+
+    const std::filesystem::path& get_root() const;
+
+    std::filesystem::path get_index_path() const;
+
+    bool contains(const std::filesystem::path& path) const;
+
+    size_t scan();
+
+    void save() const;
+
+    std::vector<Entry> get_entries() const;
+
+    std::optional<Entry> get_entry(const std::filesystem::path& path) const;
+
+    std::optional<std::filesystem::path> find_model(std::string_view name) const;
+
+    std::optional<std::filesystem::path> find_submodel(const std::filesystem::path& parent, std::string_view name) const;
+
+    std::vector<std::filesystem::path> get_users(const std::filesystem::path& path) const;
+
+    std::vector<std::filesystem::path> get_load_closure(const std::filesystem::path& path) const;
+
+    static std::shared_ptr<WorkspaceIndex> open(const std::filesystem::path& root);
+
+private:
+    std::optional<std::filesystem::path> get_relative_path(const std::filesystem::path& path) const;
+
+    const Entry* find_relative_submodel(const Entry& parent, std::string_view name) const;
+
+    void load_cache();
+
+    void rebuild_name_map();
+
+    std::filesystem::path root;
+    std::map<std::string, Entry> entries;
+    std::unordered_map<std::string, std::vector<std::string>> entries_by_name;
+};
+
+void to_json(nlohmann::json& j, const WorkspaceIndex::Entry& e);
+void from_json(const nlohmann::json& j, WorkspaceIndex::Entry& e);
+
+}
+
+#endif // MTEA_DYNWORKSPACE_INDEX_HPP
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "atomic_file.hpp"
+
+#include "model_exception.hpp"
+
+#include <fstream>
+
+#include <fmt/format.h>
+
+void mtea::write_file_atomic(const std::filesystem::path& path, const std::function<void(std::ostream&)>& write) {
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream oss(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!oss) {
+            throw ModelException(fmt::format("unable to open '{}' for writing", tmp_path.string()));
+        }
+
+        write(oss);
+
+        oss.flush();
+        if (!oss) {
+            throw ModelException(fmt::format("unable to write '{}'", tmp_path.string()));
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path);
+}
@@ -2,6 +2,8 @@
 
 #include "block_interface.hpp"
 
+#include "model_exception.hpp"
+
 #include <fmt/format.h>
 
 mtea::BlockError::BlockError(const size_t id, const std::string& message) : id{id}, message{message} {
@@ -40,6 +42,11 @@ std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> mtea::CompiledBlockIn
 
 std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> mtea::CompiledBlockInterface::get_codegen_other() const { return {}; }
 
+void mtea::CompiledBlockInterface::add_to_artifact(const ConnectionManager&, const std::unordered_map<VariableIdentifier, size_t>&,
+                                                   ExecutionArtifact&) const {
+    throw ModelException("block does not support execution artifacts");
+}
+
 mtea::BlockInterface::ModelInfo::ModelInfo(const double dt) : dt(dt) {
     // Empty Constructor
 }
@@ -66,7 +73,13 @@ std::unique_ptr<const mtea::BlockError> mtea::BlockInterface::make_error(const s
     return std::make_unique<BlockError>(get_id(), msg);
 }
 
-std::string mtea::BlockInterface::get_full_name() const { return fmt::format("{}::{}", get_library(), get_name()); }
+std::string mtea::BlockInterface::get_full_name() const { return get_full_symbol().str(); }
+
+mtea::Symbol mtea::BlockInterface::get_full_symbol() const {
+    std::call_once(full_symbol_flag,
+                   [this] { full_symbol = SymbolTable::get_instance().qualify(Symbol(get_library()), Symbol(get_name())); });
+    return *full_symbol;
+}
 
 void mtea::BlockExecutionInterface::reset() {
     update_inputs();
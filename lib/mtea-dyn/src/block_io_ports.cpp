@@ -6,6 +6,7 @@
 
 #include "model_exception.hpp"
 #include "block_interface.hpp"
+#include "execution_artifact.hpp"
 
 using namespace mtea;
 
@@ -30,7 +31,7 @@ public:
     }
 
 protected:
-    std::vector<std::string> write_code(mtea::codegen::CodeSection) const override {
+    std::vector<std::string> write_code(mtea::codegen::CodeSection, const mtea::codegen::CodegenOptions&) const override {
         throw mtea::codegen::CodegenError(fmt::format("unable to generate code for {}", get_name_base()));
     }
 };
@@ -48,6 +49,10 @@ public:
     }
 
     std::unique_ptr<codegen::CodeComponent> get_codegen_self() const override { return std::make_unique<IoPortComponent>(); }
+
+    void add_to_artifact(const ConnectionManager&, const ExecutionArtifact::SlotMap&, ExecutionArtifact&) const override {
+        // Ports alias the signals of the outer model, and so add nothing
+    }
 };
 
 /* ========== INPUT PORT ========== */
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "block_store.hpp"
+
+#include "block_interface.hpp"
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
+mtea::BlockStore::const_iterator::const_iterator(const std::vector<value_type>* slots, const size_t index) : slots(slots), index(index) {
+    skip_empty();
+}
+
+mtea::BlockStore::const_iterator::reference mtea::BlockStore::const_iterator::operator*() const { return (*slots)[index]; }
+
+mtea::BlockStore::const_iterator::pointer mtea::BlockStore::const_iterator::operator->() const { return &(*slots)[index]; }
+
+mtea::BlockStore::const_iterator& mtea::BlockStore::const_iterator::operator++() {
+    index += 1;
+    skip_empty();
+    return *this;
+}
+
+mtea::BlockStore::const_iterator mtea::BlockStore::const_iterator::operator++(int) {
+    auto tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+void mtea::BlockStore::const_iterator::skip_empty() {
+    while (slots != nullptr && index < slots->size() && (*slots)[index].second == nullptr) {
+        index += 1;
+    }
+}
+
+bool mtea::BlockStore::contains(const size_t id) const { return id < slots.size() && slots[id].second != nullptr; }
+
+mtea::BlockStore::const_iterator mtea::BlockStore::find(const size_t id) const {
+    if (contains(id)) {
+        return const_iterator(&slots, id);
+    } else {
+        return end();
+    }
+}
+
+const std::shared_ptr<mtea::BlockInterface>& mtea::BlockStore::at(const size_t id) const {
+    if (!contains(id)) {
+        throw ModelException(fmt::format("no block found with ID {}", id));
+    }
+
+    return slots[id].second;
+}
+
+mtea::BlockStore::Handle mtea::BlockStore::get_handle(const size_t id) const {
+    if (!contains(id)) {
+        throw ModelException(fmt::format("no block found with ID {}", id));
+    }
+
+    return Handle{.id = id, .generation = generations[id]};
+}
+
+bool mtea::BlockStore::contains(const Handle& handle) const { return contains(handle.id) && generations[handle.id] == handle.generation; }
+
+mtea::BlockStore::const_iterator mtea::BlockStore::find(const Handle& handle) const {
+    if (contains(handle)) {
+        return const_iterator(&slots, handle.id);
+    } else {
+        return end();
+    }
+}
+
+bool mtea::BlockStore::try_emplace(const size_t id, std::shared_ptr<BlockInterface> block) {
+    if (block == nullptr) {
+        throw ModelException("cannot store a null block");
+    } else if (contains(id)) {
+        return false;
+    } else if (id > slots.size() + MAX_ID_GAP) {
+        throw ModelException(fmt::format("block ID {} is too far beyond the {} allocated block slots", id, slots.size()));
+    }
+
+    // Grow the slot list, marking any skipped slots as free
+    while (slots.size() <= id) {
+        const size_t new_id = slots.size();
+        slots.emplace_back(new_id, nullptr);
+
+        if (new_id != id) {
+            free_ids.push_back(new_id);
+        }
+    }
+
+    if (generations.size() <= id) {
+        generations.resize(id + 1, 0);
+    }
+
+    slots[id].second = std::move(block);
+    count += 1;
+
+    return true;
+}
+
+void mtea::BlockStore::erase(const const_iterator it) {
+    if (it == end()) {
+        throw ModelException("cannot erase invalid block iterator");
+    }
+
+    erase(it->first);
+}
+
+bool mtea::BlockStore::erase(const size_t id) {
+    if (!contains(id)) {
+        return false;
+    }
+
+    slots[id].second = nullptr;
+    generations[id] += 1;
+    free_ids.push_back(id);
+    count -= 1;
+
+    // Trim trailing empty slots so that the slot list stays dense
+    while (!slots.empty() && slots.back().second == nullptr) {
+        slots.pop_back();
+    }
+
+    return true;
+}
+
+void mtea::BlockStore::clear() {
+    // Generations are kept, so that handles from before the store was cleared don't resolve
+    for (const auto& [id, blk] : slots) {
+        if (blk != nullptr) {
+            generations[id] += 1;
+        }
+    }
+
+    slots.clear();
+    free_ids.clear();
+    count = 0;
+}
+
+size_t mtea::BlockStore::next_id() {
+    // Discard free entries that have since been filled by an explicit ID or trimmed from the end
+    while (!free_ids.empty() && (free_ids.back() >= slots.size() || slots[free_ids.back()].second != nullptr)) {
+        free_ids.pop_back();
+    }
+
+    if (free_ids.empty()) {
+        return slots.size();
+    } else {
+        return free_ids.back();
+    }
+}
+
+size_t mtea::BlockStore::size() const { return count; }
+
+size_t mtea::BlockStore::capacity() const { return slots.size(); }
+
+bool mtea::BlockStore::empty() const { return count == 0; }
+
+mtea::BlockStore::const_iterator mtea::BlockStore::begin() const { return const_iterator(&slots, 0); }
+
+mtea::BlockStore::const_iterator mtea::BlockStore::end() const { return const_iterator(&slots, slots.size()); }
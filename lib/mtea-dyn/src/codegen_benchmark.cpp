@@ -0,0 +1,689 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "codegen_benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+#include <fmt/format.h>
+
+#include "atomic_file.hpp"
+#include "codegen_component.hpp"
+#include "connection_manager.hpp"
+#include "execution_state.hpp"
+#include "model.hpp"
+#include "model_manager.hpp"
+
+/* ==================== TIMING ==================== */
+
+namespace {
+
+const std::string TIMING_PREFIX = "# timing";
+
+mtea::codegen::BenchmarkTiming summarise_timing(std::vector<double>& step_ns, const double reset_ns) {
+    mtea::codegen::BenchmarkTiming timing{.reset_ns = reset_ns};
+    if (step_ns.empty()) {
+        return timing;
+    }
+
+    std::ranges::sort(step_ns);
+
+    // Nearest-rank percentiles over the individual step times
+    const auto percentile = [&step_ns](const double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(step_ns.size())));
+        return step_ns[std::clamp<size_t>(rank, 1, step_ns.size()) - 1];
+    };
+
+    timing.mean_ns = std::accumulate(step_ns.begin(), step_ns.end(), 0.0) / static_cast<double>(step_ns.size());
+    timing.p50_ns = percentile(0.5);
+    timing.p90_ns = percentile(0.9);
+    timing.p99_ns = percentile(0.99);
+
+    return timing;
+}
+
+mtea::codegen::BenchmarkTiming parse_timing(const std::string& line) {
+    mtea::codegen::BenchmarkTiming timing;
+    std::istringstream iss(line.substr(TIMING_PREFIX.size()));
+
+    std::string item;
+    while (iss >> item) {
+        const auto eq = item.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+
+        const auto key = item.substr(0, eq);
+        const auto value = std::stod(item.substr(eq + 1));
+
+        if (key == "reset_ns") {
+            timing.reset_ns = value;
+        } else if (key == "mean_ns") {
+            timing.mean_ns = value;
+        } else if (key == "p50_ns") {
+            timing.p50_ns = value;
+        } else if (key == "p90_ns") {
+            timing.p90_ns = value;
+        } else if (key == "p99_ns") {
+            timing.p99_ns = value;
+        }
+    }
+
+    return timing;
+}
+
+}
+
+/* ==================== SIGNAL TRACE ==================== */
+
+size_t mtea::codegen::SignalTrace::get_num_steps() const { return times.size(); }
+
+mtea::codegen::SignalTrace mtea::codegen::SignalTrace::read_csv(const std::filesystem::path& path) {
+    std::ifstream iss(path);
+    if (!iss) {
+        throw CodegenError(fmt::format("unable to read signal file '{}'", path.string()));
+    }
+
+    SignalTrace trace;
+    std::string line;
+    size_t line_num = 0;
+
+    while (std::getline(iss, line)) {
+        line_num += 1;
+
+        if (line.starts_with(TIMING_PREFIX)) {
+            trace.timing = parse_timing(line);
+            continue;
+        } else if (line.empty() || line.starts_with('#')) {
+            continue;
+        }
+
+        std::vector<double> row;
+        std::istringstream row_stream(line);
+        std::string cell;
+
+        while (std::getline(row_stream, cell, ',')) {
+            try {
+                row.push_back(std::stod(cell));
+            } catch (const std::exception&) {
+                throw CodegenError(fmt::format("invalid value '{}' on line {} of '{}'", cell, line_num, path.string()));
+            }
+        }
+
+        if (row.empty()) {
+            continue;
+        } else if (!trace.values.empty() && row.size() - 1 != trace.values.front().size()) {
+            throw CodegenError(fmt::format("line {} of '{}' has {} columns, expected {}", line_num, path.string(), row.size(),
+                                           trace.values.front().size() + 1));
+        }
+
+        trace.times.push_back(row.front());
+        trace.values.emplace_back(row.begin() + 1, row.end());
+    }
+
+    return trace;
+}
+
+void mtea::codegen::SignalTrace::write_csv(const std::filesystem::path& path) const {
+    write_file_atomic(path, [this](std::ostream& os) {
+        if (timing.has_value()) {
+            os << fmt::format("{} reset_ns={} mean_ns={} p50_ns={} p90_ns={} p99_ns={}\n", TIMING_PREFIX, timing->reset_ns, timing->mean_ns,
+                              timing->p50_ns, timing->p90_ns, timing->p99_ns);
+        }
+
+        for (size_t i = 0; i < times.size(); ++i) {
+            os << fmt::format("{}", times[i]);
+            for (const auto v : values[i]) {
+                os << fmt::format(",{}", v);
+            }
+            os << '\n';
+        }
+    });
+}
+
+/* ==================== COMPARISON ==================== */
+
+double mtea::codegen::BenchmarkComparison::get_speedup() const {
+    return generated.mean_ns > 0.0 ? interpreted.mean_ns / generated.mean_ns : 0.0;
+}
+
+mtea::codegen::BenchmarkComparison mtea::codegen::compare_outputs(const SignalTrace& generated, const SignalTrace& interpreted) {
+    if (generated.get_num_steps() != interpreted.get_num_steps()) {
+        throw CodegenError(fmt::format("generated output has {} steps, but the interpreter has {}", generated.get_num_steps(),
+                                       interpreted.get_num_steps()));
+    }
+
+    BenchmarkComparison result;
+    result.generated = generated.timing.value_or(BenchmarkTiming{});
+    result.interpreted = interpreted.timing.value_or(BenchmarkTiming{});
+
+    for (size_t step = 0; step < generated.get_num_steps(); ++step) {
+        const auto& gen_row = generated.values[step];
+        const auto& int_row = interpreted.values[step];
+
+        if (gen_row.size() != int_row.size()) {
+            throw CodegenError(fmt::format("generated output has {} ports, but the interpreter has {}", gen_row.size(), int_row.size()));
+        }
+
+        for (size_t port = 0; port < gen_row.size(); ++port) {
+            // Values that are both NaN match, while a NaN in only one of the runs is an unbounded deviation
+            double deviation = 0.0;
+            if (std::isnan(gen_row[port]) || std::isnan(int_row[port])) {
+                deviation = std::isnan(gen_row[port]) && std::isnan(int_row[port]) ? 0.0 : INFINITY;
+            } else {
+                deviation = std::abs(gen_row[port] - int_row[port]);
+            }
+
+            if (deviation > result.max_deviation) {
+                result.max_deviation = deviation;
+                result.max_deviation_step = step;
+                result.max_deviation_port = port;
+            }
+        }
+    }
+
+    return result;
+}
+
+/* ==================== INTERPRETER ==================== */
+
+namespace {
+
+// Model run in the interpreter with its inputs driven from stimulus variables, connected to the model as though from an outer block
+class StimulusRun {
+public:
+    StimulusRun(const std::shared_ptr<mtea::Model>& model, const mtea::codegen::SignalTrace& stimulus, const double dt) : model(model) {
+        model->update_block();
+
+        for (size_t i = 0; i < model->get_num_outputs(); ++i) {
+            manager->add_variable(mtea::VariableIdentifier{.block_id = 0, .output_port_num = i},
+                                  std::shared_ptr<mtea::ModelValue>(mtea::ModelValue::make_default(model->get_output_datatype(i))));
+        }
+
+        for (size_t i = 0; i < model->get_num_inputs(); ++i) {
+            inputs.push_back(std::shared_ptr<mtea::ModelValue>(mtea::ModelValue::make_default(model->get_input_datatype(i))));
+            manager->add_variable(mtea::VariableIdentifier{.block_id = STIMULUS_BLOCK_ID, .output_port_num = i}, inputs.back());
+            connections.add_connection(std::make_shared<mtea::Connection>(STIMULUS_BLOCK_ID, i, 0, i));
+        }
+
+        // Convert the stimulus to the input types up front, so that conversion is not included in the step times
+        for (size_t step = 0; step < stimulus.get_num_steps(); ++step) {
+            if (stimulus.values[step].size() != inputs.size()) {
+                throw mtea::codegen::CodegenError(
+                    fmt::format("stimulus has {} inputs, but the model has {}", stimulus.values[step].size(), inputs.size()));
+            }
+
+            auto& row = rows.emplace_back();
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                const auto value = mtea::ModelValue::make_default(mtea::DataType::F64);
+                mtea::ModelValue::get_inner_value<mtea::DataType::F64>(value.get()) = stimulus.values[step][i];
+                row.push_back(mtea::ModelValue::convert_type(value.get(), inputs[i]->data_type()));
+            }
+        }
+
+        const auto parameters = std::make_shared<mtea::TunableParameters::Bindings>(model->get_manager().get_tunable_parameters());
+        const mtea::TunableParameters::BindScope scope(*parameters);
+
+        state = std::make_unique<mtea::ExecutionState>(
+            model->get_execution_interface(0, connections, *manager, mtea::BlockInterface::ModelInfo(dt)), manager, parameters, dt);
+    }
+
+    size_t get_num_steps() const { return rows.size(); }
+
+    void set_inputs(const size_t step) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            inputs[i]->copy_from(rows[step][i].get());
+        }
+    }
+
+    std::vector<double> get_outputs() const {
+        std::vector<double> outputs;
+        for (size_t i = 0; i < model->get_num_outputs(); ++i) {
+            const auto value = manager->get_ptr(mtea::VariableIdentifier{.block_id = 0, .output_port_num = i});
+            outputs.push_back(to_double(value.get()));
+        }
+        return outputs;
+    }
+
+    static double to_double(const mtea::ModelValue* value) {
+        const auto converted = mtea::ModelValue::convert_type(value, mtea::DataType::F64);
+        return mtea::ModelValue::get_inner_value<mtea::DataType::F64>(converted.get());
+    }
+
+    mtea::ExecutionState& get_state() { return *state; }
+
+private:
+    static constexpr size_t STIMULUS_BLOCK_ID = 1;
+
+    std::shared_ptr<mtea::Model> model;
+    mtea::ConnectionManager connections;
+    std::shared_ptr<mtea::VariableManager> manager{std::make_shared<mtea::VariableManager>()};
+    std::vector<std::shared_ptr<mtea::ModelValue>> inputs;
+    std::vector<std::vector<std::unique_ptr<mtea::ModelValue>>> rows;
+    std::unique_ptr<mtea::ExecutionState> state;
+};
+
+}
+
+mtea::codegen::SignalTrace mtea::codegen::run_interpreter(const std::shared_ptr<Model>& model, const SignalTrace& stimulus, const double dt,
+                                                          const size_t passes) {
+    StimulusRun run(model, stimulus, dt);
+    auto& state = run.get_state();
+
+    SignalTrace result;
+    std::vector<double> step_ns;
+    step_ns.reserve(passes * run.get_num_steps());
+    double reset_ns = 0.0;
+
+    using clock_t = std::chrono::steady_clock;
+
+    for (size_t pass = 0; pass < passes; ++pass) {
+        const auto reset_start = clock_t::now();
+        state.init();
+        reset_ns += std::chrono::duration<double, std::nano>(clock_t::now() - reset_start).count();
+
+        for (size_t step = 0; step < run.get_num_steps(); ++step) {
+            run.set_inputs(step);
+
+            const auto step_start = clock_t::now();
+            state.step();
+            step_ns.push_back(std::chrono::duration<double, std::nano>(clock_t::now() - step_start).count());
+
+            if (pass == 0) {
+                result.times.push_back(stimulus.times[step]);
+                result.values.push_back(run.get_outputs());
+            }
+        }
+    }
+
+    result.timing = summarise_timing(step_ns, passes > 0 ? reset_ns / static_cast<double>(passes) : 0.0);
+    return result;
+}
+
+std::vector<mtea::codegen::SignalRange> mtea::codegen::record_signal_ranges(const std::shared_ptr<Model>& model,
+                                                                             const SignalTrace& stimulus, const double dt) {
+    StimulusRun run(model, stimulus, dt);
+    auto& state = run.get_state();
+
+    // Every output of the blocks in the model is recorded, including the values held by any input ports
+    std::vector<SignalRange> ranges;
+    std::vector<std::shared_ptr<const ModelValue>> values;
+
+    for (const auto& blk : model->get_blocks()) {
+        for (size_t port = 0; port < blk->get_num_outputs(); ++port) {
+            const VariableIdentifier id{.block_id = blk->get_id(), .output_port_num = port};
+            const auto name = id.to_string();
+            state.add_name_to_interior_variable(name, id);
+            values.push_back(state.get_variable_for_name(name));
+            ranges.push_back(SignalRange{.id = id, .min = INFINITY, .max = -INFINITY});
+        }
+    }
+
+    state.init();
+
+    for (size_t step = 0; step < run.get_num_steps(); ++step) {
+        run.set_inputs(step);
+        state.step();
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            const auto v = StimulusRun::to_double(values[i].get());
+            ranges[i].min = std::min(ranges[i].min, v);
+            ranges[i].max = std::max(ranges[i].max, v);
+        }
+    }
+
+    return ranges;
+}
+
+/* ==================== BENCHMARK WRITER ==================== */
+
+std::vector<std::string> mtea::codegen::BenchmarkWriter::write_main(const CodeComponent& root, const CodegenOptions& options) {
+    const auto input_def = *root.get_input_type();
+    const auto output_def = *root.get_output_type();
+    const bool bound = root.get_interface_binding(options) == InterfaceBinding::POINTER;
+    const auto type_name = root.get_type_name();
+    const bool batched = options.batch_size > 0;
+    const bool partitioned = root.get_num_partitions(options) > 1;
+
+    std::vector<std::string> lines;
+
+    lines.push_back(fmt::format("// Benchmark for {}, generated alongside the model code", type_name));
+    lines.push_back(fmt::format("// Usage: benchmark <stimulus.csv> <outputs.csv> [passes]"));
+    lines.emplace_back("");
+    lines.push_back(fmt::format("#include \"{}\"", root.get_module_name()));
+    lines.emplace_back("");
+
+    for (const auto& h : {"algorithm", "chrono", "cmath", "cstdio", "cstdlib", "fstream", "memory", "numeric", "sstream", "string",
+                          "type_traits", "vector"}) {
+        lines.push_back(fmt::format("#include <{}>", h));
+    }
+
+    if (partitioned) {
+        for (const auto& h : {"atomic", "barrier", "cstring", "thread"}) {
+            lines.push_back(fmt::format("#include <{}>", h));
+        }
+    }
+
+    lines.emplace_back("");
+    lines.emplace_back("namespace {");
+    lines.emplace_back("");
+    lines.push_back(fmt::format("constexpr size_t NUM_INPUTS = {};", input_def.get_size()));
+    lines.push_back(fmt::format("constexpr size_t NUM_OUTPUTS = {};", output_def.get_size()));
+    lines.push_back(fmt::format("constexpr size_t INSTANCES = {};", batched ? options.batch_size : 1));
+    lines.emplace_back("");
+    lines.emplace_back("struct StimulusRow");
+    lines.emplace_back("{");
+    lines.emplace_back("    double time;");
+    lines.emplace_back("    std::vector<double> values;");
+    lines.emplace_back("};");
+    lines.emplace_back("");
+    lines.emplace_back("bool read_stimulus(const char* path, std::vector<StimulusRow>& rows)");
+    lines.emplace_back("{");
+    lines.emplace_back("    std::ifstream iss(path);");
+    lines.emplace_back("    std::string line;");
+    lines.emplace_back("    while (std::getline(iss, line))");
+    lines.emplace_back("    {");
+    lines.emplace_back("        if (line.empty() || line[0] == '#')");
+    lines.emplace_back("        {");
+    lines.emplace_back("            continue;");
+    lines.emplace_back("        }");
+    lines.emplace_back("");
+    lines.emplace_back("        std::istringstream row_stream(line);");
+    lines.emplace_back("        std::string cell;");
+    lines.emplace_back("        std::vector<double> cells;");
+    lines.emplace_back("        while (std::getline(row_stream, cell, ','))");
+    lines.emplace_back("        {");
+    lines.emplace_back("            cells.push_back(std::strtod(cell.c_str(), nullptr));");
+    lines.emplace_back("        }");
+    lines.emplace_back("");
+    lines.emplace_back("        if (cells.size() != NUM_INPUTS + 1)");
+    lines.emplace_back("        {");
+    lines.emplace_back("            std::fprintf(stderr, \"expected %zu stimulus columns, found %zu\\n\", NUM_INPUTS + 1, cells.size());");
+    lines.emplace_back("            return false;");
+    lines.emplace_back("        }");
+    lines.emplace_back("");
+    lines.emplace_back("        rows.push_back(StimulusRow{cells[0], std::vector<double>(cells.begin() + 1, cells.end())});");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+    lines.emplace_back("    return static_cast<bool>(iss.eof());");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("template <typename T> void set_input(T& field, const double value) { field = static_cast<T>(value); }");
+    lines.emplace_back("");
+    lines.emplace_back("template <typename T> double get_output(const T& value) { return static_cast<double>(value); }");
+    lines.emplace_back("");
+    lines.emplace_back("template <typename T> double get_output(const T* value) { return static_cast<double>(*value); }");
+    lines.emplace_back("");
+    lines.emplace_back("double percentile(const std::vector<double>& sorted, const double p)");
+    lines.emplace_back("{");
+    lines.emplace_back("    const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));");
+    lines.emplace_back("    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("int main(int argc, char** argv)");
+    lines.emplace_back("{");
+    lines.emplace_back("    if (argc < 3)");
+    lines.emplace_back("    {");
+    lines.emplace_back("        std::fprintf(stderr, \"usage: %s <stimulus.csv> <outputs.csv> [passes]\\n\", argv[0]);");
+    lines.emplace_back("        return 1;");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+    lines.emplace_back("    std::vector<StimulusRow> stimulus;");
+    lines.emplace_back("    if (!read_stimulus(argv[1], stimulus))");
+    lines.emplace_back("    {");
+    lines.emplace_back("        std::fprintf(stderr, \"unable to read stimulus '%s'\\n\", argv[1]);");
+    lines.emplace_back("        return 1;");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+    lines.emplace_back("    const size_t passes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100;");
+    lines.push_back(fmt::format("    const auto model = std::make_unique<{}>();", type_name));
+
+    // Models generated with bound interfaces read their inputs through pointers, and so need storage for the stimulus values
+    if (bound) {
+        lines.emplace_back("");
+        for (size_t i = 0; i < input_def.get_size(); ++i) {
+            const auto field = fmt::format("model->{}.{}", input_def.get_name(), input_def.get_field(i));
+            lines.push_back(fmt::format("    std::remove_cvref_t<decltype(*{})> input_{}{{}};", field, i));
+            lines.push_back(fmt::format("    {} = &input_{};", field, i));
+        }
+        lines.emplace_back("    model->bind();");
+    }
+
+    lines.emplace_back("");
+    lines.emplace_back("    std::vector<double> step_ns;");
+    lines.emplace_back("    step_ns.reserve(passes * stimulus.size());");
+    lines.emplace_back("    std::vector<std::vector<double>> outputs;");
+    lines.emplace_back("    double reset_ns = 0.0;");
+    lines.emplace_back("");
+    lines.emplace_back("    using clock_t = std::chrono::steady_clock;");
+    lines.emplace_back("");
+    lines.emplace_back("    for (size_t pass = 0; pass < passes; ++pass)");
+    lines.emplace_back("    {");
+    lines.emplace_back("        const auto reset_start = clock_t::now();");
+    lines.emplace_back("        model->reset();");
+    lines.emplace_back("        reset_ns += std::chrono::duration<double, std::nano>(clock_t::now() - reset_start).count() / INSTANCES;");
+    lines.emplace_back("");
+    lines.emplace_back("        for (const auto& row : stimulus)");
+    lines.emplace_back("        {");
+
+    // Every instance of a batched model is driven with the same stimulus, with the step time given per instance
+    if (batched && input_def.get_size() > 0) {
+        lines.emplace_back("            for (size_t b = 0; b < INSTANCES; ++b)");
+        lines.emplace_back("            {");
+        for (size_t i = 0; i < input_def.get_size(); ++i) {
+            const auto field = fmt::format("model->{}.{}", input_def.get_name(), input_def.get_field(i));
+            lines.push_back(fmt::format("                set_input({}[b], row.values[{}]);", field, i));
+        }
+        lines.emplace_back("            }");
+    }
+
+    for (size_t i = 0; i < input_def.get_size() && !batched; ++i) {
+        if (bound) {
+            lines.push_back(fmt::format("            set_input(input_{}, row.values[{}]);", i, i));
+        } else {
+            lines.push_back(
+                fmt::format("            set_input(model->{}.{}, row.values[{}]);", input_def.get_name(), input_def.get_field(i), i));
+        }
+    }
+
+    lines.emplace_back("");
+    lines.emplace_back("            const auto step_start = clock_t::now();");
+    lines.emplace_back("            model->step();");
+    lines.emplace_back("            const auto step_time = std::chrono::duration<double, std::nano>(clock_t::now() - step_start);");
+    lines.emplace_back("            step_ns.push_back(step_time.count() / INSTANCES);");
+    lines.emplace_back("");
+    lines.emplace_back("            if (pass == 0)");
+    lines.emplace_back("            {");
+    lines.emplace_back("                outputs.push_back({");
+    lines.emplace_back("                    row.time,");
+    for (size_t i = 0; i < output_def.get_size(); ++i) {
+        const auto field = fmt::format("model->{}.{}{}", output_def.get_name(), output_def.get_field(i), batched ? "[0]" : "");
+        lines.push_back(fmt::format("                    get_output({}),", field));
+    }
+    lines.emplace_back("                });");
+    lines.emplace_back("            }");
+    lines.emplace_back("        }");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+    lines.emplace_back("    std::sort(step_ns.begin(), step_ns.end());");
+    lines.emplace_back("    const double total_ns = std::accumulate(step_ns.begin(), step_ns.end(), 0.0);");
+    lines.emplace_back("    const double mean_ns = step_ns.empty() ? 0.0 : total_ns / step_ns.size();");
+    lines.emplace_back("    const double p50_ns = step_ns.empty() ? 0.0 : percentile(step_ns, 0.5);");
+    lines.emplace_back("    const double p90_ns = step_ns.empty() ? 0.0 : percentile(step_ns, 0.9);");
+    lines.emplace_back("    const double p99_ns = step_ns.empty() ? 0.0 : percentile(step_ns, 0.99);");
+    lines.emplace_back("    const double mean_reset_ns = passes > 0 ? reset_ns / passes : 0.0;");
+    lines.emplace_back("");
+    lines.emplace_back("    FILE* output_file = std::fopen(argv[2], \"w\");");
+    lines.emplace_back("    if (output_file == nullptr)");
+    lines.emplace_back("    {");
+    lines.emplace_back("        std::fprintf(stderr, \"unable to write outputs '%s'\\n\", argv[2]);");
+    lines.emplace_back("        return 1;");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+    lines.emplace_back("    std::fprintf(output_file,");
+    lines.push_back(
+        fmt::format("                 \"{} reset_ns=%.17g mean_ns=%.17g p50_ns=%.17g p90_ns=%.17g p99_ns=%.17g\\n\",", TIMING_PREFIX));
+    lines.emplace_back("                 mean_reset_ns, mean_ns, p50_ns, p90_ns, p99_ns);");
+    lines.emplace_back("    for (const auto& row : outputs)");
+    lines.emplace_back("    {");
+    lines.emplace_back("        for (size_t i = 0; i < row.size(); ++i)");
+    lines.emplace_back("        {");
+    lines.emplace_back("            std::fprintf(output_file, i == 0 ? \"%.17g\" : \",%.17g\", row[i]);");
+    lines.emplace_back("        }");
+    lines.emplace_back("        std::fputc('\\n', output_file);");
+    lines.emplace_back("    }");
+    lines.emplace_back("    std::fclose(output_file);");
+    lines.emplace_back("");
+    lines.emplace_back("    std::printf(\"steps: %zu, reset: %.1f ns, step mean: %.1f ns, p50: %.1f ns, p90: %.1f ns, p99: %.1f ns\\n\", "
+                       "step_ns.size(), mean_reset_ns, mean_ns, p50_ns, p90_ns, p99_ns);");
+
+    if (partitioned) {
+        for (const auto& l : write_partitioned_run(root)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+    }
+
+    lines.emplace_back("    return 0;");
+    lines.emplace_back("}");
+
+    return lines;
+}
+
+std::vector<std::string> mtea::codegen::BenchmarkWriter::write_partitioned_run(const CodeComponent& root) {
+    const auto input_def = *root.get_input_type();
+    const auto output_def = *root.get_output_type();
+
+    std::vector<std::string> lines;
+
+    // Partitioned models are stepped by one thread per partition, with the inputs and outputs exchanged between steps at a barrier,
+    // and must produce bit-identical outputs to the serial step
+    lines.emplace_back("");
+    lines.push_back(fmt::format("const auto parallel = std::make_unique<{}>();", root.get_type_name()));
+    lines.push_back(fmt::format("constexpr size_t NUM_PARTITIONS = {}::NUM_PARTITIONS;", root.get_type_name()));
+    lines.emplace_back("std::barrier sync(static_cast<std::ptrdiff_t>(NUM_PARTITIONS));");
+    lines.emplace_back("std::atomic<bool> running{true};");
+    lines.emplace_back("");
+    lines.emplace_back("std::vector<std::thread> workers;");
+    lines.emplace_back("for (size_t k = 1; k < NUM_PARTITIONS; ++k)");
+    lines.emplace_back("{");
+    lines.emplace_back("    workers.emplace_back([&parallel, &sync, &running, k]() {");
+    lines.emplace_back("        while (true)");
+    lines.emplace_back("        {");
+    lines.emplace_back("            sync.arrive_and_wait();");
+    lines.emplace_back("            if (!running.load())");
+    lines.emplace_back("            {");
+    lines.emplace_back("                break;");
+    lines.emplace_back("            }");
+    lines.emplace_back("");
+    lines.emplace_back("            parallel->step_partition(k);");
+    lines.emplace_back("            sync.arrive_and_wait();");
+    lines.emplace_back("        }");
+    lines.emplace_back("    });");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("std::vector<double> parallel_ns;");
+    lines.emplace_back("parallel_ns.reserve(passes * stimulus.size());");
+    lines.emplace_back("size_t mismatches = 0;");
+    lines.emplace_back("");
+    lines.emplace_back("for (size_t pass = 0; pass < passes; ++pass)");
+    lines.emplace_back("{");
+    lines.emplace_back("    parallel->reset();");
+    lines.emplace_back("");
+    lines.emplace_back("    for (size_t step = 0; step < stimulus.size(); ++step)");
+    lines.emplace_back("    {");
+    lines.emplace_back("        const auto& row = stimulus[step];");
+    for (size_t i = 0; i < input_def.get_size(); ++i) {
+        const auto field = fmt::format("parallel->{}.{}", input_def.get_name(), input_def.get_field(i));
+        lines.push_back(fmt::format("        set_input({}, row.values[{}]);", field, i));
+    }
+    lines.emplace_back("");
+    lines.emplace_back("        const auto step_start = clock_t::now();");
+    lines.emplace_back("        sync.arrive_and_wait();");
+    lines.emplace_back("        parallel->step_partition(0);");
+    lines.emplace_back("        sync.arrive_and_wait();");
+    lines.emplace_back("        parallel_ns.push_back(std::chrono::duration<double, std::nano>(clock_t::now() - step_start).count());");
+    lines.emplace_back("");
+    lines.emplace_back("        if (pass == 0)");
+    lines.emplace_back("        {");
+    lines.emplace_back("            const double values[] = {");
+    lines.emplace_back("                row.time,");
+    for (size_t i = 0; i < output_def.get_size(); ++i) {
+        lines.push_back(fmt::format("                get_output(parallel->{}.{}),", output_def.get_name(), output_def.get_field(i)));
+    }
+    lines.emplace_back("            };");
+    lines.emplace_back("            mismatches += std::memcmp(values, outputs[step].data(), sizeof(values)) != 0 ? 1 : 0;");
+    lines.emplace_back("        }");
+    lines.emplace_back("    }");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("running.store(false);");
+    lines.emplace_back("sync.arrive_and_wait();");
+    lines.emplace_back("for (auto& w : workers)");
+    lines.emplace_back("{");
+    lines.emplace_back("    w.join();");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+    lines.emplace_back("const double parallel_total_ns = std::accumulate(parallel_ns.begin(), parallel_ns.end(), 0.0);");
+    lines.emplace_back("const double parallel_mean_ns = parallel_ns.empty() ? 0.0 : parallel_total_ns / parallel_ns.size();");
+    lines.emplace_back("const double speedup = parallel_mean_ns > 0.0 ? mean_ns / parallel_mean_ns : 0.0;");
+    lines.emplace_back("std::printf(\"partitions: %zu, step mean: %.1f ns, serial: %.1f ns, speedup: %.2fx, mismatched steps: %zu\\n\", "
+                       "NUM_PARTITIONS, parallel_mean_ns, mean_ns, speedup, mismatches);");
+    lines.emplace_back("");
+    lines.emplace_back("if (mismatches > 0)");
+    lines.emplace_back("{");
+    lines.emplace_back("    std::fprintf(stderr, \"partitioned outputs differ from the serial step\\n\");");
+    lines.emplace_back("    return 1;");
+    lines.emplace_back("}");
+
+    return lines;
+}
+
+std::vector<std::string> mtea::codegen::BenchmarkWriter::write_cmake(const CodeComponent& root, const CodegenOptions& options) {
+    const auto target = fmt::format("{}_benchmark", root.get_name_base());
+
+    std::vector<std::string> lines = {
+        "cmake_minimum_required(VERSION 3.18)",
+        "",
+        fmt::format("project({} LANGUAGES CXX)", target),
+        "",
+        "# Path to the mtea library source, which provides mtea.hpp for the generated model code",
+        "set(MTEA_DIR \"\" CACHE PATH \"Path to the mtea library source\")",
+        "",
+        "if(NOT CMAKE_BUILD_TYPE)",
+        "    set(CMAKE_BUILD_TYPE Release)",
+        "endif()",
+        "",
+        "add_subdirectory(${MTEA_DIR} mtea)",
+        "",
+        fmt::format("add_executable({} {})", target, MAIN_FILE_NAME),
+        "",
+        fmt::format("set_property(TARGET {} PROPERTY CXX_STANDARD 20)", target),
+        fmt::format("set_property(TARGET {} PROPERTY CXX_STANDARD_REQUIRED ON)", target),
+        "",
+        fmt::format("target_include_directories({} PRIVATE ${{CMAKE_CURRENT_SOURCE_DIR}})", target),
+        fmt::format("target_link_libraries({} PRIVATE mtea)", target),
+    };
+
+    // Size-optimised code defines large functions in the source file of each model type
+    if (options.optimise_size) {
+        lines.emplace_back("");
+        lines.emplace_back("file(GLOB MODEL_SOURCES CONFIGURE_DEPENDS \"${CMAKE_CURRENT_SOURCE_DIR}/*.cpp\")");
+        lines.push_back(fmt::format("list(FILTER MODEL_SOURCES EXCLUDE REGEX \"{}$\")", MAIN_FILE_NAME));
+        lines.push_back(fmt::format("target_sources({} PRIVATE ${{MODEL_SOURCES}})", target));
+    }
+
+    // Partitioned models are stepped from worker threads
+    if (root.get_num_partitions(options) > 1) {
+        lines.emplace_back("");
+        lines.emplace_back("find_package(Threads REQUIRED)");
+        lines.push_back(fmt::format("target_link_libraries({} PRIVATE Threads::Threads)", target));
+    }
+
+    return lines;
+}
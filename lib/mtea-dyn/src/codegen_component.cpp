@@ -10,8 +10,20 @@ std::string mtea::codegen::CodeComponent::get_module_name() const { return fmt::
 
 std::string mtea::codegen::CodeComponent::get_type_name() const { return get_name_base(); }
 
-std::vector<std::string> mtea::codegen::CodeComponent::constructor_arguments() const { return {}; }
+std::vector<mtea::codegen::ConstructorArgument> mtea::codegen::CodeComponent::constructor_arguments() const { return {}; }
 
-std::vector<std::string> mtea::codegen::CodeComponent::write_code(CodeSection section) const {
+std::vector<mtea::codegen::ParameterReport> mtea::codegen::CodeComponent::get_parameter_report(const CodegenOptions&) const { return {}; }
+
+std::optional<std::string> mtea::codegen::CodeComponent::get_structure_key(const CodegenOptions&) const { return {}; }
+
+std::optional<mtea::codegen::ComponentSize> mtea::codegen::CodeComponent::get_size_estimate(const CodegenOptions&) const { return {}; }
+
+std::vector<std::string> mtea::codegen::CodeComponent::write_code(CodeSection, const CodegenOptions&) const {
     return {};
 }
+
+mtea::codegen::InterfaceBinding mtea::codegen::CodeComponent::get_interface_binding(const CodegenOptions&) const {
+    return InterfaceBinding::VALUE;
+}
+
+size_t mtea::codegen::CodeComponent::get_num_partitions(const CodegenOptions&) const { return 1; }
@@ -2,43 +2,395 @@
 
 #include "codegen_generator.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <future>
+#include <map>
+#include <sstream>
+#include <ranges>
+#include <thread>
 
 #include <fmt/format.h>
+#include <nlohmann/json.hpp>
 
-mtea::codegen::CodeGenerator::CodeGenerator(std::unique_ptr<CompiledBlockInterface>&& comp) : compiled(std::move(comp)) {
-    // Empty Constructor
+#include "atomic_file.hpp"
+#include "codegen_benchmark.hpp"
+#include "codegen_component.hpp"
+#include "thread_pool.hpp"
+
+const std::string mtea::codegen::CodeGenerator::MANIFEST_FILE_NAME = ".mtea_codegen";
+
+const std::string mtea::codegen::CodeGenerator::PARAMETER_REPORT_FILE_NAME = "parameters.json";
+
+const std::string mtea::codegen::CodeGenerator::SIZE_REPORT_FILE_NAME = "size_report.json";
+
+/* ==================== MANIFEST ==================== */
+
+namespace {
+
+constexpr int MANIFEST_VERSION = 1;
+
+struct GeneratedFile {
+    std::string name;
+    std::string contents;
+    size_t lines{0};
+};
+
+struct ManifestEntry {
+    uint64_t hash;
+    uint64_t size;
+};
+
+using manifest_t = std::map<std::string, ManifestEntry>;
+
+GeneratedFile make_file(std::string name, const std::vector<std::string>& code) {
+    GeneratedFile file{.name = std::move(name), .contents = {}, .lines = code.size()};
+    for (const auto& l : code) {
+        file.contents.append(l);
+        file.contents.push_back('\n');
+    }
+
+    return file;
+}
+
+uint64_t hash_contents(const std::string_view contents) {
+    // FNV-1a over the generated file contents
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t hash = FNV_OFFSET;
+    for (const auto c : contents) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+manifest_t read_manifest(const std::filesystem::path& path) {
+    // A missing or unreadable manifest only means that every file is written again
+    std::ifstream iss(path);
+    if (!iss) {
+        return {};
+    }
+
+    const auto j = nlohmann::json::parse(iss, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || j.value("version", 0) != MANIFEST_VERSION || !j.contains("files")) {
+        return {};
+    }
+
+    manifest_t manifest;
+    for (const auto& [name, e] : j["files"].items()) {
+        if (e.is_object() && e.contains("hash") && e.contains("size")) {
+            manifest.emplace(name, ManifestEntry{.hash = e["hash"].get<uint64_t>(), .size = e["size"].get<uint64_t>()});
+        }
+    }
+
+    return manifest;
+}
+
+void write_manifest(const std::filesystem::path& path, const manifest_t& manifest) {
+    nlohmann::json files = nlohmann::json::object();
+    for (const auto& [name, e] : manifest) {
+        files[name] = {{"hash", e.hash}, {"size", e.size}};
+    }
+
+    const nlohmann::json j{{"version", MANIFEST_VERSION}, {"files", files}};
+    mtea::write_file_atomic(path, [&j](std::ostream& os) { os << j.dump(2) << '\n'; });
+}
+
+bool is_unchanged(const std::filesystem::path& path, const manifest_t& manifest, const std::string& name, const ManifestEntry& entry) {
+    // The file size is checked as well, so that a file removed or edited by hand is regenerated
+    const auto it = manifest.find(name);
+    if (it == manifest.end() || it->second.hash != entry.hash || it->second.size != entry.size) {
+        return false;
+    }
+
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path / name, ec);
+    return !ec && size == entry.size;
+}
+
+/* ==================== PARAMETER REPORT ==================== */
+
+std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream iss(text);
+    for (std::string l; std::getline(iss, l);) {
+        lines.push_back(std::move(l));
+    }
+
+    return lines;
+}
+
+using component_list_t = std::vector<std::unique_ptr<mtea::codegen::CodeComponent>>;
+
+std::vector<mtea::codegen::ParameterReport> get_parameter_report(const component_list_t& components,
+                                                                 const mtea::codegen::CodegenOptions& options) {
+    // Types used by several models appear once for each, but hold the same arguments each time
+    std::vector<mtea::codegen::ParameterReport> report;
+    for (const auto& c : components) {
+        for (auto& p : c->get_parameter_report(options)) {
+            if (std::ranges::none_of(report, [&p](const auto& r) { return r.name == p.name; })) {
+                report.push_back(std::move(p));
+            }
+        }
+    }
+
+    // Every override must name a generated argument, so that a misspelt name is not silently ignored
+    for (const auto& name : options.parameter_bindings | std::views::keys) {
+        if (std::ranges::none_of(report, [&name](const auto& r) { return r.name == name; })) {
+            throw mtea::codegen::CodegenError(fmt::format("no block constructor argument named '{}' to bind", name));
+        }
+    }
+
+    return report;
+}
+
+std::vector<std::string> write_parameter_report(const std::vector<mtea::codegen::ParameterReport>& report) {
+    nlohmann::json parameters = nlohmann::json::array();
+    for (const auto& p : report) {
+        parameters.push_back({{"name", p.name},
+                              {"type", p.type_name},
+                              {"value", p.value},
+                              {"binding", p.binding == mtea::codegen::ParameterBinding::CONSTRUCTOR ? "constructor" : "constant"}});
+    }
+
+    return split_lines(nlohmann::json{{"parameters", parameters}}.dump(2));
+}
+
+/* ==================== SHARED TYPES ==================== */
+
+// Index of the component holding the implementation for each component, which is the first by name of those with the same structure
+std::vector<size_t> get_shared_types(const component_list_t& components, const mtea::codegen::CodegenOptions& options) {
+    std::vector<std::optional<std::string>> keys;
+    std::map<std::string, size_t> by_key;
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        keys.push_back(options.optimise_size ? components[i]->get_structure_key(options) : std::nullopt);
+        if (!keys[i].has_value()) {
+            continue;
+        }
+
+        const auto [it, inserted] = by_key.emplace(*keys[i], i);
+        if (!inserted && components[i]->get_name_base() < components[it->second]->get_name_base()) {
+            it->second = i;
+        }
+    }
+
+    // Components of the same name are the same type, and so are never an alias of each other
+    std::vector<size_t> shared(components.size());
+    for (size_t i = 0; i < components.size(); ++i) {
+        const auto s = keys[i].has_value() ? by_key.at(*keys[i]) : i;
+        shared[i] = components[s]->get_name_base() == components[i]->get_name_base() ? i : s;
+    }
+
+    return shared;
+}
+
+std::vector<std::string> write_alias_header(const mtea::codegen::CodeComponent& alias, const mtea::codegen::CodeComponent& shared) {
+    std::string name_upper = alias.get_name_base();
+    for (auto& c : name_upper) {
+        c = static_cast<char>(std::toupper(c));
+    }
+
+    const auto guard = fmt::format("GEN_MDL_ALIAS_{}_GUARD", name_upper);
+
+    return {
+        fmt::format("#ifndef {}", guard),
+        fmt::format("#define {}", guard),
+        "",
+        fmt::format("#include \"{}\"", shared.get_module_name()),
+        "",
+        fmt::format("// Structurally identical to {}, which holds the shared implementation", shared.get_type_name()),
+        fmt::format("using {} = {};", alias.get_type_name(), shared.get_type_name()),
+        "",
+        fmt::format("#endif // {}", guard),
+    };
+}
+
+std::vector<std::string> write_size_report(const component_list_t& components, const std::vector<size_t>& shared,
+                                           const mtea::codegen::CodegenOptions& options) {
+    nlohmann::json sizes = nlohmann::json::array();
+    for (size_t i = 0; i < components.size(); ++i) {
+        auto size = components[i]->get_size_estimate(options);
+        if (!size.has_value()) {
+            continue;
+        }
+
+        if (shared[i] != i) {
+            size->shared_with = components[shared[i]]->get_type_name();
+        }
+
+        sizes.push_back({{"name", size->name},
+                         {"shared_with", size->shared_with},
+                         {"estimated_inline_statements", size->estimated_inline_statements},
+                         {"estimated_out_of_line_statements", size->estimated_out_of_line_statements},
+                         {"estimated_data_members", size->estimated_data_members}});
+    }
+
+    // Sizes are counted from the generated source, and so only estimate the size of the compiled code and data
+    return split_lines(nlohmann::json{{"inline_budget", options.inline_budget},
+                                      {"units", "estimated statements and data members, not bytes"},
+                                      {"components", sizes}}
+                           .dump(2));
 }
 
-void mtea::codegen::CodeGenerator::write_in_folder(const std::filesystem::path& path) const {
+}
+
+/* ==================== CODE GENERATOR ==================== */
+
+mtea::codegen::CodeGenerator::CodeGenerator(std::unique_ptr<CompiledBlockInterface>&& comp, const CodegenOptions& options)
+    : compiled(std::move(comp)), options(options) {
+    if (options.batch_size > 0 && options.layout != CodeLayout::AMALGAMATED) {
+        throw CodegenError("batched code requires the amalgamated layout");
+    } else if (options.num_partitions > 1 && options.layout != CodeLayout::AMALGAMATED) {
+        throw CodegenError("partitioned code requires the amalgamated layout");
+    } else if (options.num_partitions > 1 && options.batch_size > 0) {
+        throw CodegenError("partitioned code cannot also be batched");
+    } else if (options.multi_rate && (options.layout != CodeLayout::AMALGAMATED || options.batch_size > 0 || options.num_partitions > 1)) {
+        throw CodegenError("multi-rate code requires the amalgamated layout, without batching or partitions");
+    } else if (options.optimise_size && options.layout != CodeLayout::HIERARCHICAL) {
+        throw CodegenError("size-optimised code requires the hierarchical layout");
+    }
+}
+
+mtea::codegen::CodegenSummary mtea::codegen::CodeGenerator::write_in_folder(const std::filesystem::path& path) const {
     const std::vector<mtea::codegen::CodeSection> sections{
         mtea::codegen::CodeSection::DEFINITION,
         mtea::codegen::CodeSection::DECLARATION,
     };
 
-    const std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> components = compiled->get_codegen_components();
+    // The amalgamated layout inlines every nested model into the root component, which is then the only one written
+    std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> components;
+    if (options.layout == mtea::codegen::CodeLayout::AMALGAMATED) {
+        components.push_back(compiled->get_codegen_self());
+    } else {
+        components = compiled->get_codegen_components();
+    }
 
-    for (const auto& c : components) {
-        for (const auto& sec : sections) {
-            const auto code = c->write_code(sec);
-            if (code.empty()) {
-                continue;
-            }
+    const auto parameters = get_parameter_report(components, options);
+    const auto shared = get_shared_types(components, options);
 
-            std::string file_ext;
-            if (sec == mtea::codegen::CodeSection::DEFINITION) {
-                file_ext = "cpp";
-            } else if (sec == mtea::codegen::CodeSection::DECLARATION) {
-                file_ext = "h";
-            } else {
-                continue;
-            }
+    // Generate the code for each component in parallel, with each file built up in memory
+    std::vector<std::future<std::vector<GeneratedFile>>> pending;
+
+    {
+        const auto num_threads = options.num_threads > 0 ? options.num_threads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        ThreadPool pool(std::min(num_threads, std::max<size_t>(components.size(), 1)));
+
+        for (size_t i = 0; i < components.size(); ++i) {
+            pending.push_back(pool.submit([this, &c = components[i], &s = components[shared[i]], &sections]() {
+                std::vector<GeneratedFile> files;
 
-            std::ofstream output(path / fmt::format("{}.{}", c->get_name_base(), file_ext));
+                // Types sharing the implementation of another are only written as an alias, which keeps their headers for includers
+                if (c != s) {
+                    files.push_back(make_file(fmt::format("{}.h", c->get_name_base()), write_alias_header(*c, *s)));
+                    return files;
+                }
 
-            for (const auto& l : code) {
-                output << l << std::endl;
+                for (const auto& sec : sections) {
+                    const auto code = c->write_code(sec, options);
+                    if (code.empty()) {
+                        continue;
+                    }
+
+                    std::string file_ext;
+                    if (sec == mtea::codegen::CodeSection::DEFINITION) {
+                        file_ext = "cpp";
+                    } else if (sec == mtea::codegen::CodeSection::DECLARATION) {
+                        file_ext = "h";
+                    } else {
+                        continue;
+                    }
+
+                    files.push_back(make_file(fmt::format("{}.{}", c->get_name_base(), file_ext), code));
+                }
+
+                return files;
+            }));
+        }
+
+        for (auto& f : pending) {
+            f.wait();
+        }
+    }
+
+    std::vector<GeneratedFile> files;
+    for (auto& f : pending) {
+        for (auto& g : f.get()) {
+            files.push_back(std::move(g));
+        }
+    }
+
+    if (options.write_parameter_report) {
+        files.push_back(make_file(PARAMETER_REPORT_FILE_NAME, write_parameter_report(parameters)));
+    }
+
+    if (options.optimise_size) {
+        files.push_back(make_file(SIZE_REPORT_FILE_NAME, write_size_report(components, shared, options)));
+    }
+
+    if (options.write_benchmark) {
+        const auto root = compiled->get_codegen_self();
+        files.push_back(make_file(std::string(BenchmarkWriter::MAIN_FILE_NAME), BenchmarkWriter::write_main(*root, options)));
+        files.push_back(make_file(std::string(BenchmarkWriter::CMAKE_FILE_NAME), BenchmarkWriter::write_cmake(*root, options)));
+    }
+
+    // Only rewrite files whose contents have changed, so that downstream builds only rebuild what was affected
+    const auto manifest_path = path / MANIFEST_FILE_NAME;
+    const auto previous = read_manifest(manifest_path);
+    manifest_t current;
+
+    CodegenSummary summary;
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        if (shared[i] != i) {
+            summary.types_shared += 1;
+        }
+    }
+
+    for (const auto& p : parameters) {
+        if (p.binding == ParameterBinding::CONSTRUCTOR) {
+            summary.parameters_constructor += 1;
+        } else {
+            summary.parameters_constant += 1;
+        }
+    }
+
+    for (const auto& f : files) {
+        const ManifestEntry entry{.hash = hash_contents(f.contents), .size = f.contents.size()};
+
+        if (!current.emplace(f.name, entry).second) {
+            throw CodegenError(fmt::format("multiple components generate the file '{}'", f.name));
+        }
+
+        if (!is_unchanged(path, previous, f.name, entry)) {
+            write_file_atomic(path / f.name, [&f](std::ostream& os) {
+                os.write(f.contents.data(), static_cast<std::streamsize>(f.contents.size()));
+            });
+            summary.files_written += 1;
+        }
+
+        summary.files += 1;
+        summary.lines += f.lines;
+        summary.bytes += f.contents.size();
+    }
+
+    // Remove files generated by a previous run that are no longer produced, leaving any other files in the folder untouched
+    for (const auto& name : previous | std::views::keys) {
+        if (!current.contains(name)) {
+            std::error_code ec;
+            if (std::filesystem::remove(path / name, ec)) {
+                summary.files_removed += 1;
             }
         }
     }
+
+    if (summary.files_written > 0 || summary.files_removed > 0 || previous.size() != current.size()) {
+        write_manifest(manifest_path, current);
+    }
+
+    return summary;
 }
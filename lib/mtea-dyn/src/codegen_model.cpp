@@ -0,0 +1,1265 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "codegen_model.hpp"
+
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <ranges>
+
+#include "model_compiled_data.hpp"
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
+using namespace mtea::codegen;
+
+/* ==================== MODEL COMPONENT ==================== */
+
+bool ModelCodeComponent::has_component(const std::optional<ComponentVariable>& v) { return v.has_value(); }
+
+const ModelCodeComponent::ComponentVariable& ModelCodeComponent::get_component(const std::optional<ComponentVariable>& v) { return *v; }
+
+ModelCodeComponent::ModelCodeComponent(const mtea::Identifier& model_name, const double base_dt, const double rate_dt,
+                                       std::shared_ptr<const mtea::Model::CompiledModelData> exec_data,
+                                       std::vector<std::unique_ptr<const codegen::CodeComponent>>&& components,
+                                       std::vector<std::shared_ptr<const BlockInterface>>&& sources)
+    : _model_name(model_name), _base_dt(base_dt), _rate_dt(rate_dt), _model_data(exec_data), _input_types(exec_data->input_types),
+      _output_types(exec_data->output_types), _blocks(exec_data->block_ids.size()), _sources(std::move(sources)) {
+    if (components.size() != _blocks.size() || _sources.size() != _blocks.size()) {
+        throw ModelException("component count must match the compiled block count");
+    }
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        if (components[i] != nullptr) {
+            _blocks[i].emplace(fmt::format("_block_{}", exec_data->block_ids[i]), std::move(components[i]));
+        }
+    }
+    components.clear();
+
+    for (size_t i = 0; i < _input_types.size(); ++i) {
+        _input_names.push_back(fmt::format("value_{}", i));
+    }
+
+    for (size_t i = 0; i < _output_types.size(); ++i) {
+        _output_names.push_back(fmt::format("value_{}", i));
+    }
+}
+
+std::optional<mtea::codegen::InterfaceDefinition> ModelCodeComponent::get_input_type() const {
+    return mtea::codegen::InterfaceDefinition("s_in", _input_names);
+}
+
+std::optional<mtea::codegen::InterfaceDefinition> ModelCodeComponent::get_output_type() const {
+    return mtea::codegen::InterfaceDefinition("s_out", _output_names);
+}
+
+std::string ModelCodeComponent::get_name_base() const { return _model_name.get(); }
+
+std::optional<std::string> ModelCodeComponent::get_function_name(mtea::codegen::BlockFunction ft) const {
+    switch (ft) {
+        using enum mtea::codegen::BlockFunction;
+    case STEP:
+        return "step";
+    case RESET:
+        return "reset";
+    default:
+        return {};
+    }
+}
+
+mtea::codegen::InterfaceBinding ModelCodeComponent::get_interface_binding(const mtea::codegen::CodegenOptions& options) const {
+    if (options.signal_storage == mtea::codegen::SignalStorage::FLAT) {
+        return mtea::codegen::InterfaceBinding::POINTER;
+    } else {
+        return mtea::codegen::InterfaceBinding::VALUE;
+    }
+}
+
+size_t ModelCodeComponent::get_num_partitions(const mtea::codegen::CodegenOptions& options) const {
+    if (options.layout != mtea::codegen::CodeLayout::AMALGAMATED || options.num_partitions <= 1) {
+        return 1;
+    }
+
+    return get_flat_schedule(get_flat_program(options), options).num_partitions;
+}
+
+std::vector<std::string> ModelCodeComponent::write_code(mtea::codegen::CodeSection section,
+                                                        const mtea::codegen::CodegenOptions& options) const {
+    if (section == mtea::codegen::CodeSection::DEFINITION) {
+        return options.layout == mtea::codegen::CodeLayout::AMALGAMATED ? std::vector<std::string>{} : write_cpp_definitions(options);
+    } else if (section != mtea::codegen::CodeSection::DECLARATION) {
+        return {};
+    } else if (options.layout == mtea::codegen::CodeLayout::AMALGAMATED) {
+        return write_amalgamated_implementation(options);
+    } else {
+        return write_cpp_implementation(options);
+    }
+}
+
+std::vector<std::string> ModelCodeComponent::write_cpp_implementation(const mtea::codegen::CodegenOptions& options) const {
+    const bool flat = options.signal_storage == mtea::codegen::SignalStorage::FLAT;
+
+    std::string name_base_upper = get_name_base();
+    for (auto& c : name_base_upper) {
+        c = static_cast<char>(std::toupper(c));
+    }
+
+    const std::string HDR_GUARD = fmt::format("GEN_MDL_BLOCK_{}_GUARD", name_base_upper);
+
+    std::vector<std::string> lines;
+    lines.emplace_back(fmt::format("#ifndef {}", HDR_GUARD));
+    lines.emplace_back(fmt::format("#define {}", HDR_GUARD));
+    lines.emplace_back("");
+
+    std::vector<std::string> include_files;
+    for (const auto& [varname, comp] : _blocks | std::views::filter(has_component) | std::views::transform(get_component)) {
+        const auto fcn_name = comp->get_module_name();
+        if (fcn_name.empty()) {
+            continue;
+        }
+
+        if (std::ranges::find(include_files, fcn_name) == include_files.end()) {
+            include_files.emplace_back(fcn_name);
+        }
+    }
+
+    std::ranges::sort(include_files);
+
+    for (const auto& f : include_files) {
+        lines.emplace_back(fmt::format("#include \"{}\"", f));
+    }
+
+    lines.emplace_back("");
+
+    if (flat) {
+        lines.emplace_back("// Ports point at the storage of their source signals - set each input and call bind() before use");
+    }
+
+    lines.emplace_back(fmt::format("struct {}", get_name_base()));
+    lines.emplace_back("{");
+
+    lines.emplace_back("    struct input_t");
+    lines.emplace_back("    {");
+
+    for (size_t i = 0; i < _input_types.size(); ++i) {
+        lines.emplace_back(fmt::format("        {};", get_port_declaration(_input_types[i], _input_names[i], flat)));
+    }
+
+    lines.emplace_back("    };");
+    lines.emplace_back("");
+
+    lines.emplace_back("    struct output_t");
+    lines.emplace_back("    {");
+
+    for (size_t i = 0; i < _output_types.size(); ++i) {
+        lines.emplace_back(fmt::format("        {};", get_port_declaration(_output_types[i], _output_names[i], flat)));
+    }
+
+    lines.emplace_back("    };");
+    lines.emplace_back("");
+
+    const auto members = get_members();
+
+    lines.emplace_back(fmt::format("    {}()", get_name_base()));
+    lines.emplace_back("    {");
+    lines.emplace_back("    }");
+
+    lines.emplace_back("");
+
+    for (const auto& l : get_parameter_declarations(members, options)) {
+        lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+    }
+
+    lines.push_back(fmt::format("    {}(const {}&) = delete;", get_name_base(), get_name_base()));
+    lines.push_back(fmt::format("    {}& operator=(const {}&) = delete;", get_name_base(), get_name_base()));
+
+    if (flat) {
+        lines.emplace_back("");
+        for (const auto& l : get_model_bind_function(options)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+    }
+
+    for (const auto fcn : {mtea::codegen::BlockFunction::RESET, mtea::codegen::BlockFunction::STEP}) {
+        lines.emplace_back("");
+
+        const auto fcn_lines = get_model_function_calls(fcn, options);
+        if (is_out_of_line(fcn_lines, options)) {
+            lines.push_back(fmt::format("    {};", fcn_lines.front()));
+            continue;
+        }
+
+        for (const auto& l : fcn_lines) {
+            lines.emplace_back(fmt::format("    {}", l));
+        }
+    }
+
+    lines.emplace_back("");
+    lines.push_back(fmt::format("    input_t {};", get_input_type()->get_name()));
+    lines.push_back(fmt::format("    output_t {};", get_output_type()->get_name()));
+
+    // Blocks copy their arguments when constructed, and so the parameters are fixed for the lifetime of the model
+    if (has_constructor_parameters(members, options)) {
+        lines.emplace_back("    const parameters_t parameters{};");
+    }
+
+    if (!members.empty()) {
+        lines.emplace_back("");
+        lines.emplace_back("private:");
+        for (const auto& l : get_constant_declarations(members, options)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+
+        for (const auto& [varname, comp] : members) {
+            lines.push_back(fmt::format("    {}", get_member_declaration(*comp, varname, options)));
+        }
+    }
+
+    lines.emplace_back("};");
+
+    lines.emplace_back("");
+    lines.push_back(fmt::format("#endif // {}", HDR_GUARD));
+
+    return lines;
+}
+
+/* ==================== CODE SIZE ==================== */
+
+size_t ModelCodeComponent::count_statements(const std::vector<std::string>& fcn_lines) {
+    return std::ranges::count_if(fcn_lines, [](const std::string& l) { return l.ends_with(';'); });
+}
+
+bool ModelCodeComponent::is_out_of_line(const std::vector<std::string>& fcn_lines, const mtea::codegen::CodegenOptions& options) {
+    return options.optimise_size && count_statements(fcn_lines) > options.inline_budget;
+}
+
+std::vector<std::string> ModelCodeComponent::write_cpp_definitions(const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> lines;
+    if (!options.optimise_size) {
+        return lines;
+    }
+
+    for (const auto fcn : {mtea::codegen::BlockFunction::RESET, mtea::codegen::BlockFunction::STEP}) {
+        const auto fcn_lines = get_model_function_calls(fcn, options);
+        if (!is_out_of_line(fcn_lines, options)) {
+            continue;
+        }
+
+        lines.emplace_back("");
+        lines.push_back(fmt::format("void {}::{}()", get_name_base(), *get_function_name(fcn)));
+        lines.insert(lines.end(), fcn_lines.begin() + 1, fcn_lines.end());
+    }
+
+    if (!lines.empty()) {
+        lines.insert(lines.begin(), fmt::format("#include \"{}\"", get_module_name()));
+    }
+
+    return lines;
+}
+
+std::optional<std::string> ModelCodeComponent::get_structure_key(const mtea::codegen::CodegenOptions& options) const {
+    // Models are keyed by everything that is written into their code apart from names, with nested models keyed by structure
+    std::string key = "in";
+    for (const auto dt : _input_types) {
+        key += fmt::format(" {}", mtea::codegen::get_datatype_name(dt));
+    }
+
+    key += ";out";
+    for (const auto dt : _output_types) {
+        key += fmt::format(" {}", mtea::codegen::get_datatype_name(dt));
+    }
+
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        key += fmt::format(";{}:", _model_data->block_ids[i]);
+        if (!_blocks[i].has_value()) {
+            continue;
+        }
+
+        const auto& comp = *_blocks[i]->component;
+        if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(&comp)) {
+            key += fmt::format("model({})", *mdl->get_structure_key(options));
+        } else {
+            key += fmt::format("{}@{}", comp.get_type_name(), comp.get_module_name());
+            for (const auto& a : get_bound_arguments(comp, _blocks[i]->name, options)) {
+                key += fmt::format(",{}{{{}}}{}", a.argument.type_name, a.argument.value, is_from_constructor(a) ? "p" : "c");
+            }
+        }
+    }
+
+    key += ";order";
+    for (const auto bid : _model_data->execution_order) {
+        key += fmt::format(" {}", bid);
+    }
+
+    key += ";links";
+    for (const auto& dests : _model_data->links.input_port_links) {
+        key += " |";
+        for (const auto& d : dests) {
+            key += fmt::format(" {}.{}", d.block_id, d.port_num);
+        }
+    }
+
+    for (const auto& src : _model_data->links.output_port_links) {
+        key += fmt::format(" <{}.{}", src.block_id, src.port_num);
+    }
+
+    for (const auto& ports : _model_data->links.component_links) {
+        key += " #";
+        for (const auto& dests : ports) {
+            key += " |";
+            for (const auto& d : dests) {
+                key += fmt::format(" {}.{}", d.block_id, d.port_num);
+            }
+        }
+    }
+
+    return key;
+}
+
+std::optional<mtea::codegen::ComponentSize> ModelCodeComponent::get_size_estimate(const mtea::codegen::CodegenOptions& options) const {
+    mtea::codegen::ComponentSize size;
+    size.name = get_name_base();
+
+    for (const auto fcn : {mtea::codegen::BlockFunction::RESET, mtea::codegen::BlockFunction::STEP}) {
+        const auto fcn_lines = get_model_function_calls(fcn, options);
+        if (is_out_of_line(fcn_lines, options)) {
+            size.estimated_out_of_line_statements += count_statements(fcn_lines);
+        } else {
+            size.estimated_inline_statements += count_statements(fcn_lines);
+        }
+    }
+
+    size.estimated_data_members = _input_types.size() + _output_types.size() + get_members().size();
+    return size;
+}
+
+/* ==================== PARAMETERS ==================== */
+
+ModelCodeComponent::MemberList ModelCodeComponent::get_members() const {
+    MemberList members;
+    for (const auto& [varname, comp] : _blocks | std::views::filter(has_component) | std::views::transform(get_component)) {
+        members.emplace_back(varname, comp.get());
+    }
+    return members;
+}
+
+bool ModelCodeComponent::is_from_constructor(const BoundArgument& arg) {
+    return arg.binding == mtea::codegen::ParameterBinding::CONSTRUCTOR;
+}
+
+bool ModelCodeComponent::is_constant(const BoundArgument& arg) { return arg.binding == mtea::codegen::ParameterBinding::CONSTANT; }
+
+std::vector<ModelCodeComponent::BoundArgument> ModelCodeComponent::get_bound_arguments(const mtea::codegen::CodeComponent& comp,
+                                                                                       const std::string_view varname,
+                                                                                       const mtea::codegen::CodegenOptions& options) const {
+    const auto args = comp.constructor_arguments();
+
+    std::vector<BoundArgument> bound;
+    for (size_t i = 0; i < args.size(); ++i) {
+        auto name = args.size() == 1 ? fmt::format("{}_arg", varname) : fmt::format("{}_arg_{}", varname, i);
+        const auto it = options.parameter_bindings.find(fmt::format("{}::{}", get_name_base(), name));
+        const auto binding = it != options.parameter_bindings.end() ? it->second : options.parameter_binding;
+        bound.push_back(BoundArgument{.name = std::move(name), .argument = args[i], .binding = binding});
+    }
+
+    return bound;
+}
+
+bool ModelCodeComponent::has_constructor_parameters(const MemberList& members, const mtea::codegen::CodegenOptions& options) const {
+    for (const auto& [varname, comp] : members) {
+        if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(comp)) {
+            if (mdl->has_constructor_parameters(mdl->get_members(), options)) {
+                return true;
+            }
+        } else if (std::ranges::any_of(get_bound_arguments(*comp, varname, options), is_from_constructor)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string ModelCodeComponent::get_argument_list(const mtea::codegen::CodeComponent& comp, const std::string_view varname,
+                                                  const mtea::codegen::CodegenOptions& options) const {
+    // Nested models with constructor parameters are constructed from their own part of the parameters
+    if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(&comp)) {
+        return mdl->has_constructor_parameters(mdl->get_members(), options) ? fmt::format("parameters.{}", varname) : "";
+    }
+
+    std::string args = "";
+    for (const auto& a : get_bound_arguments(comp, varname, options)) {
+        const auto value = is_from_constructor(a) ? fmt::format("parameters.{}", a.name) : a.name;
+        args = args.empty() ? value : fmt::format("{}, {}", args, value);
+    }
+
+    return args;
+}
+
+std::string ModelCodeComponent::get_member_declaration(const mtea::codegen::CodeComponent& comp, const std::string_view varname,
+                                                       const mtea::codegen::CodegenOptions& options) const {
+    auto args = get_argument_list(comp, varname, options);
+
+    if (!args.empty()) {
+        args = fmt::format(" {} ", args);
+    }
+
+    return fmt::format("{} {}{{{}}};", comp.get_type_name(), varname, args);
+}
+
+std::vector<std::string> ModelCodeComponent::get_parameter_declarations(const MemberList& members,
+                                                                        const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> lines;
+    if (!has_constructor_parameters(members, options)) {
+        return lines;
+    }
+
+    lines.emplace_back("struct parameters_t");
+    lines.emplace_back("{");
+
+    for (const auto& [varname, comp] : members) {
+        if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(comp)) {
+            if (mdl->has_constructor_parameters(mdl->get_members(), options)) {
+                lines.push_back(fmt::format("    {}::parameters_t {}{{}};", mdl->get_type_name(), varname));
+            }
+            continue;
+        }
+
+        for (const auto& a : get_bound_arguments(*comp, varname, options) | std::views::filter(is_from_constructor)) {
+            lines.push_back(fmt::format("    {} {}{{ {} }};", a.argument.type_name, a.name, a.argument.value));
+        }
+    }
+
+    lines.emplace_back("};");
+    lines.emplace_back("");
+    lines.push_back(fmt::format("explicit {}(const parameters_t& parameters) : parameters(parameters)", get_name_base()));
+    lines.emplace_back("{");
+    lines.emplace_back("}");
+    lines.emplace_back("");
+
+    return lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_constant_declarations(const MemberList& members,
+                                                                      const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> lines;
+
+    for (const auto& [varname, comp] : members) {
+        for (const auto& a : get_bound_arguments(*comp, varname, options) | std::views::filter(is_constant)) {
+            lines.push_back(fmt::format("static constexpr {} {}{{ {} }};", a.argument.type_name, a.name, a.argument.value));
+        }
+    }
+
+    if (!lines.empty()) {
+        lines.emplace_back("");
+    }
+
+    return lines;
+}
+
+std::vector<mtea::codegen::ParameterReport> ModelCodeComponent::get_parameter_report(const mtea::codegen::CodegenOptions& options) const {
+    // Amalgamated code holds the arguments of every nested block, where the hierarchical layout reports each type separately
+    const bool amalgamated = options.layout == mtea::codegen::CodeLayout::AMALGAMATED;
+    const auto members = amalgamated ? get_members(get_flat_program(options)) : get_members();
+
+    std::vector<mtea::codegen::ParameterReport> report;
+    for (const auto& [varname, comp] : members) {
+        for (const auto& a : get_bound_arguments(*comp, varname, options)) {
+            report.push_back(mtea::codegen::ParameterReport{.name = fmt::format("{}::{}", get_name_base(), a.name),
+                                                            .type_name = a.argument.type_name,
+                                                            .value = a.argument.value,
+                                                            .binding = a.binding});
+        }
+    }
+
+    return report;
+}
+
+std::string ModelCodeComponent::get_port_declaration(const mtea::DataType dt, const std::string_view name, const bool flat) {
+    if (flat) {
+        return fmt::format("const {}* {}{{nullptr}}", mtea::codegen::get_datatype_name(dt), name);
+    } else {
+        return fmt::format("{} {}{{}}", mtea::codegen::get_datatype_name(dt), name);
+    }
+}
+
+std::optional<ModelCodeComponent::SignalSource> ModelCodeComponent::find_signal_source(const size_t block_id, const size_t port_num) const {
+    for (size_t i = 0; i < _model_data->links.input_port_links.size(); ++i) {
+        for (const auto& dest : _model_data->links.input_port_links[i]) {
+            if (dest.block_id == block_id && dest.port_num == port_num) {
+                return SignalSource{.input_port = i, .block_id = 0, .port_num = 0};
+            }
+        }
+    }
+
+    for (size_t src_dense = 0; src_dense < _model_data->links.component_links.size(); ++src_dense) {
+        const auto& vals = _model_data->links.component_links[src_dense];
+        for (size_t src_port = 0; src_port < vals.size(); ++src_port) {
+            for (const auto& dest : vals[src_port]) {
+                if (dest.block_id == block_id && dest.port_num == port_num) {
+                    return SignalSource{
+                        .input_port = std::nullopt, .block_id = _model_data->block_ids[src_dense], .port_num = src_port};
+                }
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::string ModelCodeComponent::get_source_pointer(const SignalSource& src, const mtea::codegen::CodegenOptions& options) const {
+    if (src.input_port.has_value()) {
+        return fmt::format("{}.{}", get_input_type()->get_name(), get_input_type()->get_field(*src.input_port));
+    }
+
+    const auto& blk = block_at(src.block_id);
+    const auto comp = *blk.component->get_output_type();
+    const auto field = fmt::format("{}.{}.{}", blk.name, comp.get_name(), comp.get_field(src.port_num));
+
+    if (blk.component->get_interface_binding(options) == mtea::codegen::InterfaceBinding::POINTER) {
+        return field;
+    } else {
+        return fmt::format("&{}", field);
+    }
+}
+
+std::string ModelCodeComponent::get_source_value(const SignalSource& src, const mtea::codegen::CodegenOptions& options) const {
+    const auto ptr = get_source_pointer(src, options);
+    if (ptr.starts_with('&')) {
+        return ptr.substr(1);
+    } else {
+        return fmt::format("*{}", ptr);
+    }
+}
+
+std::vector<std::string> ModelCodeComponent::get_model_bind_function(const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> output_lines;
+    std::vector<std::string> input_lines;
+
+    for (const auto& bid : _model_data->execution_order) {
+        const auto* current = find_block(bid);
+        if (current == nullptr || current->component->get_interface_binding(options) != mtea::codegen::InterfaceBinding::POINTER) {
+            continue;
+        }
+
+        output_lines.push_back(fmt::format("{}.bind_outputs();", current->name));
+
+        if (!input_lines.empty()) {
+            input_lines.emplace_back("");
+        }
+
+        input_lines.emplace_back(fmt::format("// Block {} - {}", bid, current->name));
+
+        if (const auto input_def = current->component->get_input_type()) {
+            for (size_t port_num = 0; port_num < input_def->get_size(); ++port_num) {
+                if (const auto src = find_signal_source(bid, port_num)) {
+                    input_lines.push_back(fmt::format("{}.{}.{} = {};", current->name, input_def->get_name(),
+                                                      input_def->get_field(port_num), get_source_pointer(*src, options)));
+                }
+            }
+        }
+
+        input_lines.push_back(fmt::format("{}.bind_inputs();", current->name));
+    }
+
+    const auto output_def = get_output_type();
+    for (size_t port_num = 0; port_num < _model_data->links.output_port_links.size(); ++port_num) {
+        const auto& link = _model_data->links.output_port_links[port_num];
+        const SignalSource src{.input_port = std::nullopt, .block_id = link.block_id, .port_num = link.port_num};
+        output_lines.push_back(
+            fmt::format("{}.{} = {};", output_def->get_name(), output_def->get_field(port_num), get_source_pointer(src, options)));
+    }
+
+    const auto add_function = [](std::vector<std::string>& lines, const std::string_view name, const std::vector<std::string>& body) {
+        lines.push_back(fmt::format("void {}()", name));
+        lines.emplace_back("{");
+        for (const auto& l : body) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+        lines.emplace_back("}");
+    };
+
+    // Output pointers only depend on the blocks of a model and never on its inputs, and so binding every output before any input
+    // means that each source is bound before it is read, whatever the execution order and through any delayed feedback
+    std::vector<std::string> lines;
+    add_function(lines, "bind_outputs", output_lines);
+    lines.emplace_back("");
+    add_function(lines, "bind_inputs", input_lines);
+    lines.emplace_back("");
+    add_function(lines, "bind", {"bind_outputs();", "bind_inputs();"});
+
+    return lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_model_function_calls(const mtea::codegen::BlockFunction fcn,
+                                                                      const mtea::codegen::CodegenOptions& options) const {
+    if (options.signal_storage == mtea::codegen::SignalStorage::FLAT) {
+        return get_flat_model_function_calls(fcn, options);
+    }
+
+    std::vector<std::string> fcn_lines;
+
+    for (const auto& bid : _model_data->execution_order) {
+        const auto* current = find_block(bid);
+        if (current == nullptr) {
+            continue;
+        }
+
+        std::vector<std::string> block_lines;
+
+        // Copy Input Values
+        const auto input_def = get_input_type();
+        for (size_t port_num = 0; port_num < _model_data->links.input_port_links.size(); ++port_num) {
+            for (const auto& dest : _model_data->links.input_port_links[port_num]) {
+                if (dest.block_id != bid) {
+                    continue;
+                }
+
+                const auto& blk = block_at(dest.block_id);
+                const auto comp = *blk.component->get_input_type();
+                block_lines.push_back(fmt::format("{}.{}.{} = {}.{};", blk.name, comp.get_name(), comp.get_field(dest.port_num),
+                                                  input_def->get_name(), input_def->get_field(port_num)));
+            }
+        }
+
+        for (size_t src_dense = 0; src_dense < _model_data->links.component_links.size(); ++src_dense) {
+            const auto& vals = _model_data->links.component_links[src_dense];
+            if (vals.empty()) {
+                continue;
+            }
+
+            const auto& src_blk = block_at(_model_data->block_ids[src_dense]);
+            const auto src_comp = *src_blk.component->get_output_type();
+
+            for (size_t src_port = 0; src_port < vals.size(); ++src_port) {
+                for (const auto& dest_i : vals[src_port]) {
+                    if (dest_i.block_id != bid) {
+                        continue;
+                    }
+
+                    const auto& dst_blk = block_at(dest_i.block_id);
+                    const auto dst_comp = *dst_blk.component->get_input_type();
+
+                    block_lines.push_back(fmt::format("{}.{}.{} = {}.{}.{};", dst_blk.name, dst_comp.get_name(),
+                                                      dst_comp.get_field(dest_i.port_num), src_blk.name, src_comp.get_name(),
+                                                      src_comp.get_field(src_port)));
+                }
+            }
+        }
+
+        // Call the resulting function name if present
+        const auto& [varname, comp] = *current;
+        const auto fcn_name = comp->get_function_name(fcn);
+        if (fcn_name) {
+            block_lines.push_back(fmt::format("{}.{}();", varname, *fcn_name));
+        }
+
+        // Add the lines to the block if needed
+        if (!block_lines.empty()) {
+            if (!fcn_lines.empty()) {
+                fcn_lines.emplace_back("");
+            }
+
+            fcn_lines.emplace_back(fmt::format("// Block {} - {}", bid, current->name));
+            for (const auto& bl : block_lines) {
+                fcn_lines.emplace_back(fmt::format("{}", bl));
+            }
+        }
+    }
+
+    if (fcn == mtea::codegen::BlockFunction::STEP || fcn == mtea::codegen::BlockFunction::RESET) {
+        const auto output_def = get_output_type();
+        std::vector<std::string> output_lines;
+
+        for (size_t port_num = 0; port_num < _model_data->links.output_port_links.size(); ++port_num) {
+            const auto& src = _model_data->links.output_port_links[port_num];
+            const auto& blk = block_at(src.block_id);
+            const auto comp = *blk.component->get_output_type();
+            output_lines.push_back(fmt::format("{}.{} = {}.{}.{};", output_def->get_name(), output_def->get_field(port_num), blk.name,
+                                               comp.get_name(), comp.get_field(src.port_num)));
+        }
+
+        if (!output_lines.empty()) {
+            if (!fcn_lines.empty()) {
+                fcn_lines.emplace_back("");
+            }
+            fcn_lines.emplace_back("// Copy Output Values");
+            for (const auto& ol : output_lines) {
+                fcn_lines.emplace_back(fmt::format("{}", ol));
+            }
+        }
+    }
+
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("void {}()", *get_function_name(fcn)));
+    lines.emplace_back("{");
+
+    for (const auto& l : fcn_lines) {
+        lines.emplace_back(fmt::format("    {}", l));
+    }
+
+    lines.emplace_back("}");
+
+    return lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_flat_model_function_calls(const mtea::codegen::BlockFunction fcn,
+                                                                           const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> fcn_lines;
+
+    for (const auto& bid : _model_data->execution_order) {
+        const auto* current = find_block(bid);
+        if (current == nullptr) {
+            continue;
+        }
+
+        std::vector<std::string> block_lines;
+
+        // Blocks with value interfaces load each input directly from the storage of its source, while generated models
+        // already refer to their sources
+        const auto input_def = current->component->get_input_type();
+        if (input_def && current->component->get_interface_binding(options) == mtea::codegen::InterfaceBinding::VALUE) {
+            for (size_t port_num = 0; port_num < input_def->get_size(); ++port_num) {
+                if (const auto src = find_signal_source(bid, port_num)) {
+                    block_lines.push_back(fmt::format("{}.{}.{} = {};", current->name, input_def->get_name(),
+                                                      input_def->get_field(port_num), get_source_value(*src, options)));
+                }
+            }
+        }
+
+        if (const auto fcn_name = current->component->get_function_name(fcn)) {
+            block_lines.push_back(fmt::format("{}.{}();", current->name, *fcn_name));
+        }
+
+        if (!block_lines.empty()) {
+            if (!fcn_lines.empty()) {
+                fcn_lines.emplace_back("");
+            }
+
+            fcn_lines.emplace_back(fmt::format("// Block {} - {}", bid, current->name));
+            fcn_lines.insert(fcn_lines.end(), block_lines.begin(), block_lines.end());
+        }
+    }
+
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("void {}()", *get_function_name(fcn)));
+    lines.emplace_back("{");
+
+    for (const auto& l : fcn_lines) {
+        lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+    }
+
+    lines.emplace_back("}");
+
+    return lines;
+}
+
+const ModelCodeComponent::ComponentVariable* ModelCodeComponent::find_block(const size_t block_id) const {
+    const size_t index = _model_data->get_dense_index(block_id);
+    if (index < _blocks.size() && _blocks[index].has_value()) {
+        return &*_blocks[index];
+    } else {
+        return nullptr;
+    }
+}
+
+const ModelCodeComponent::ComponentVariable& ModelCodeComponent::block_at(const size_t block_id) const {
+    if (const auto* blk = find_block(block_id)) {
+        return *blk;
+    } else {
+        throw ModelException(fmt::format("no code component found for block {}", block_id));
+    }
+}
+
+/* ==================== AMALGAMATED LAYOUT ==================== */
+
+ModelCodeComponent::MemberList ModelCodeComponent::get_members(const FlatProgram& program) {
+    MemberList members;
+    for (const auto& blk : program.blocks) {
+        members.emplace_back(blk.varname, blk.component);
+    }
+    return members;
+}
+
+ModelCodeComponent::FlatContext ModelCodeComponent::get_child_context(const FlatContext& ctx, const size_t block_id) const {
+    return FlatContext{
+        .prefix = fmt::format("{}_{}", ctx.prefix, block_id),
+        .input_signal = [this, ctx, block_id](const size_t port_num) {
+            if (const auto src = find_signal_source(block_id, port_num)) {
+                return get_flat_signal(ctx, *src);
+            } else {
+                throw mtea::codegen::CodegenError(
+                    fmt::format("no source for block {} input {} in {}", block_id, port_num, get_name_base()));
+            }
+        },
+        .rate_ticks = ctx.rate_ticks,
+    };
+}
+
+size_t ModelCodeComponent::get_rate_ticks(const size_t parent_ticks) const {
+    const double ratio = _rate_dt / _base_dt;
+    const auto ticks = static_cast<size_t>(std::llround(ratio));
+
+    if (ratio <= static_cast<double>(parent_ticks) * (1.0 + 1e-9)) {
+        return parent_ticks;
+    } else if (std::abs(ratio - static_cast<double>(ticks)) > 1e-9 * ratio || ticks % parent_ticks != 0) {
+        throw mtea::codegen::CodegenError(fmt::format("step {} of {} is not a multiple of the parent period of {}", _rate_dt,
+                                                      get_name_base(), _base_dt * static_cast<double>(parent_ticks)));
+    } else {
+        return ticks;
+    }
+}
+
+const mtea::codegen::CodeComponent& ModelCodeComponent::get_rate_component(const size_t block_id, const size_t rate_ticks) const {
+    const auto& source = _sources.at(_model_data->get_dense_index(block_id));
+    if (rate_ticks == 1 || source == nullptr) {
+        return *block_at(block_id).component;
+    }
+
+    std::lock_guard lock(_rate_mutex);
+
+    auto& comp = _rate_components[{block_id, rate_ticks}];
+    if (comp == nullptr) {
+        const mtea::BlockInterface::ModelInfo info(_base_dt * static_cast<double>(rate_ticks));
+        comp = source->get_compiled(info)->get_codegen_self();
+    }
+
+    return *comp;
+}
+
+ModelCodeComponent::FlatSignal ModelCodeComponent::get_flat_signal(const FlatContext& ctx, const SignalSource& src) const {
+    if (src.input_port.has_value()) {
+        return ctx.input_signal(*src.input_port);
+    }
+
+    const auto& blk = block_at(src.block_id);
+    if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(blk.component.get())) {
+        const auto& link = mdl->_model_data->links.output_port_links.at(src.port_num);
+        return mdl->get_flat_signal(get_child_context(ctx, src.block_id),
+                                    SignalSource{.input_port = std::nullopt, .block_id = link.block_id, .port_num = link.port_num});
+    }
+
+    const auto comp = *blk.component->get_output_type();
+    return FlatSignal{
+        .input_port = std::nullopt,
+        .block_var = fmt::format("{}_{}", ctx.prefix, src.block_id),
+        .output_field = fmt::format("{}.{}", comp.get_name(), comp.get_field(src.port_num)),
+        .port_num = src.port_num,
+    };
+}
+
+void ModelCodeComponent::add_flat_blocks(const FlatContext& ctx, FlatProgram& program, const bool multi_rate) const {
+    for (const auto& bid : _model_data->execution_order) {
+        const auto* current = find_block(bid);
+        if (current == nullptr) {
+            continue;
+        }
+
+        if (const auto mdl = dynamic_cast<const ModelCodeComponent*>(current->component.get())) {
+            auto child_ctx = get_child_context(ctx, bid);
+            if (multi_rate) {
+                child_ctx.rate_ticks = mdl->get_rate_ticks(ctx.rate_ticks);
+            }
+
+            mdl->add_flat_blocks(child_ctx, program, multi_rate);
+            continue;
+        }
+
+        const auto& comp = multi_rate ? get_rate_component(bid, ctx.rate_ticks) : *current->component;
+
+        const auto module = comp.get_module_name();
+        if (!module.empty() && std::ranges::find(program.include_files, module) == program.include_files.end()) {
+            program.include_files.push_back(module);
+        }
+
+        FlatBlock blk{.varname = fmt::format("{}_{}", ctx.prefix, bid), .component = &comp, .inputs = {}, .rate_ticks = ctx.rate_ticks};
+
+        if (const auto input_def = comp.get_input_type()) {
+            for (size_t port_num = 0; port_num < input_def->get_size(); ++port_num) {
+                if (const auto src = find_signal_source(bid, port_num)) {
+                    blk.inputs.emplace_back(fmt::format("{}.{}", input_def->get_name(), input_def->get_field(port_num)),
+                                            get_flat_signal(ctx, *src));
+                }
+            }
+        }
+
+        program.blocks.push_back(std::move(blk));
+    }
+}
+
+ModelCodeComponent::FlatProgram ModelCodeComponent::get_flat_program(const mtea::codegen::CodegenOptions& options) const {
+    const FlatContext root_ctx{
+        .prefix = "_block",
+        .input_signal = [](const size_t port_num) {
+            return FlatSignal{.input_port = port_num, .block_var = {}, .output_field = {}, .port_num = port_num};
+        },
+        .rate_ticks = 1,
+    };
+
+    FlatProgram program;
+    add_flat_blocks(root_ctx, program, options.multi_rate);
+
+    for (const auto& link : _model_data->links.output_port_links) {
+        program.outputs.push_back(
+            get_flat_signal(root_ctx, SignalSource{.input_port = std::nullopt, .block_id = link.block_id, .port_num = link.port_num}));
+    }
+
+    std::ranges::sort(program.include_files);
+    return program;
+}
+
+std::string ModelCodeComponent::get_signal_storage_name(const FlatSignal& sig) {
+    return fmt::format("{}_out_{}", sig.block_var, sig.port_num);
+}
+
+std::string ModelCodeComponent::get_flat_signal_value(const FlatSignal& sig, const size_t batch_size) const {
+    if (sig.input_port.has_value()) {
+        const auto field = fmt::format("{}.{}", get_input_type()->get_name(), get_input_type()->get_field(*sig.input_port));
+        return batch_size > 0 ? fmt::format("{}[i]", field) : field;
+    } else if (batch_size > 0) {
+        return fmt::format("{}[i]", get_signal_storage_name(sig));
+    } else {
+        return fmt::format("{}.{}", sig.block_var, sig.output_field);
+    }
+}
+
+std::vector<std::string> ModelCodeComponent::write_amalgamated_implementation(const mtea::codegen::CodegenOptions& options) const {
+    const auto input_def = *get_input_type();
+    const auto output_def = *get_output_type();
+    const auto batch_size = options.batch_size;
+    const auto program = get_flat_program(options);
+    const auto schedule = get_flat_schedule(program, options);
+    const bool partitioned = schedule.num_partitions > 1;
+    const auto rates = get_flat_rates(program);
+    const bool multi_rate = options.multi_rate;
+
+    std::string name_base_upper = get_name_base();
+    for (auto& c : name_base_upper) {
+        c = static_cast<char>(std::toupper(c));
+    }
+
+    const std::string HDR_GUARD = fmt::format("GEN_MDL_FLAT_{}_GUARD", name_base_upper);
+
+    std::vector<std::string> lines;
+    lines.emplace_back(fmt::format("#ifndef {}", HDR_GUARD));
+    lines.emplace_back(fmt::format("#define {}", HDR_GUARD));
+    lines.emplace_back("");
+
+    for (const auto& f : program.include_files) {
+        lines.emplace_back(fmt::format("#include \"{}\"", f));
+    }
+
+    if (batch_size > 0) {
+        lines.emplace_back("");
+        lines.emplace_back("#include <array>");
+        lines.emplace_back("#include <cstddef>");
+        lines.emplace_back("#include <type_traits>");
+        lines.emplace_back("#include <utility>");
+    } else if (partitioned) {
+        lines.emplace_back("");
+        lines.emplace_back("#include <atomic>");
+        lines.emplace_back("#include <cstddef>");
+        lines.emplace_back("#include <cstdint>");
+        lines.emplace_back("#include <type_traits>");
+    } else if (multi_rate) {
+        lines.emplace_back("");
+        lines.emplace_back("#include <cstddef>");
+        lines.emplace_back("#include <type_traits>");
+    }
+
+    lines.emplace_back("");
+    if (batch_size > 0) {
+        lines.emplace_back("// Whole model hierarchy flattened into a single structure for a batch of instances, with signals");
+        lines.emplace_back("// stored as arrays over the instances and each block stepped for every instance in turn");
+    } else if (multi_rate) {
+        lines.emplace_back("// Whole model hierarchy flattened into a single structure, with blocks grouped by the period of their");
+        lines.emplace_back("// model and each group stepped by its own function, exchanging signals through rate transition buffers");
+    } else {
+        lines.emplace_back("// Whole model hierarchy flattened into a single structure, with every block called in execution order");
+    }
+
+    if (options.num_partitions > schedule.num_partitions) {
+        lines.push_back(fmt::format("// Stepped in {} of the {} partitions requested, as the model has too little work per step to share",
+                                    schedule.num_partitions, options.num_partitions));
+    }
+    lines.emplace_back(fmt::format("struct {}", get_name_base()));
+    lines.emplace_back("{");
+
+    std::string port_suffix;
+    if (partitioned) {
+        lines.push_back(fmt::format("    static constexpr size_t NUM_PARTITIONS = {};", schedule.num_partitions));
+        lines.emplace_back("");
+    } else if (multi_rate) {
+        std::string ticks;
+        for (const auto t : rates.ticks) {
+            ticks += ticks.empty() ? std::to_string(t) : fmt::format(", {}", t);
+        }
+
+        lines.push_back(fmt::format("    static constexpr double BASE_DT = {};", _base_dt));
+        lines.push_back(fmt::format("    static constexpr size_t NUM_RATES = {};", rates.ticks.size()));
+        lines.push_back(fmt::format("    static constexpr size_t RATE_TICKS[NUM_RATES] = {{{}}};", ticks));
+        lines.emplace_back("");
+    } else if (batch_size > 0) {
+        lines.push_back(fmt::format("    static constexpr size_t CAPACITY = {};", batch_size));
+        lines.emplace_back("");
+        port_suffix = "[CAPACITY]";
+    }
+
+    lines.emplace_back("    struct input_t");
+    lines.emplace_back("    {");
+    for (size_t i = 0; i < _input_types.size(); ++i) {
+        lines.emplace_back(
+            fmt::format("        {} {}{}{{}};", mtea::codegen::get_datatype_name(_input_types[i]), _input_names[i], port_suffix));
+    }
+    lines.emplace_back("    };");
+    lines.emplace_back("");
+
+    lines.emplace_back("    struct output_t");
+    lines.emplace_back("    {");
+    for (size_t i = 0; i < _output_types.size(); ++i) {
+        lines.emplace_back(
+            fmt::format("        {} {}{}{{}};", mtea::codegen::get_datatype_name(_output_types[i]), _output_names[i], port_suffix));
+    }
+    lines.emplace_back("    };");
+    lines.emplace_back("");
+
+    const auto members = get_members(program);
+
+    lines.emplace_back(fmt::format("    {}()", get_name_base()));
+    lines.emplace_back("    {");
+    lines.emplace_back("    }");
+    lines.emplace_back("");
+
+    for (const auto& l : get_parameter_declarations(members, options)) {
+        lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+    }
+
+    lines.push_back(fmt::format("    {}(const {}&) = delete;", get_name_base(), get_name_base()));
+    lines.push_back(fmt::format("    {}& operator=(const {}&) = delete;", get_name_base(), get_name_base()));
+
+    for (const auto fcn : {mtea::codegen::BlockFunction::RESET, mtea::codegen::BlockFunction::STEP}) {
+        lines.emplace_back("");
+
+        if (batch_size > 0) {
+            lines.push_back(fmt::format("    void {}(size_t n = CAPACITY)", *get_function_name(fcn)));
+            lines.emplace_back("    {");
+            lines.emplace_back("        n = n < CAPACITY ? n : CAPACITY;");
+            for (const auto& l : get_batched_function_lines(program, fcn, options)) {
+                lines.push_back(l.empty() ? l : fmt::format("        {}", l));
+            }
+        } else {
+            lines.push_back(fmt::format("    void {}()", *get_function_name(fcn)));
+            lines.emplace_back("    {");
+
+            const auto fcn_lines = multi_rate && fcn == mtea::codegen::BlockFunction::STEP ? get_rate_step_lines(rates, options)
+                                                                                           : get_flat_function_lines(program, fcn);
+            for (const auto& l : fcn_lines) {
+                lines.push_back(fmt::format("        {}", l));
+            }
+
+            if (multi_rate && fcn == mtea::codegen::BlockFunction::RESET) {
+                for (const auto& l : get_rate_reset_lines(rates)) {
+                    lines.push_back(l.empty() ? l : fmt::format("        {}", l));
+                }
+            }
+
+            if (partitioned && fcn == mtea::codegen::BlockFunction::RESET) {
+                for (const auto& l : get_partition_reset_lines(program, schedule)) {
+                    lines.push_back(l.empty() ? l : fmt::format("        {}", l));
+                }
+            }
+        }
+
+        lines.emplace_back("    }");
+    }
+
+    if (partitioned) {
+        for (const auto& l : get_partition_functions(program, schedule)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+    } else if (multi_rate) {
+        for (const auto& l : get_rate_functions(program, rates, options)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+    }
+
+    lines.emplace_back("");
+    lines.push_back(fmt::format("    input_t {};", input_def.get_name()));
+    lines.push_back(fmt::format("    output_t {};", output_def.get_name()));
+
+    // Blocks copy their arguments when constructed, and so the parameters are fixed for the lifetime of the model
+    if (has_constructor_parameters(members, options)) {
+        lines.emplace_back("    const parameters_t parameters{};");
+    }
+
+    if (!program.blocks.empty()) {
+        lines.emplace_back("");
+        lines.emplace_back("private:");
+        for (const auto& l : get_constant_declarations(members, options)) {
+            lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+        }
+
+        if (batch_size > 0) {
+            for (const auto& l : get_batched_members(program, options)) {
+                lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+            }
+        } else {
+            for (const auto& blk : program.blocks) {
+                lines.push_back(fmt::format("    {}", get_member_declaration(*blk.component, blk.varname, options)));
+            }
+        }
+
+        if (partitioned) {
+            for (const auto& l : get_partition_members(program, schedule)) {
+                lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+            }
+        } else if (multi_rate) {
+            for (const auto& l : get_rate_members(rates)) {
+                lines.push_back(l.empty() ? l : fmt::format("    {}", l));
+            }
+        }
+    }
+
+    lines.emplace_back("};");
+    lines.emplace_back("");
+    lines.push_back(fmt::format("#endif // {}", HDR_GUARD));
+
+    return lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_flat_function_lines(const FlatProgram& program,
+                                                                     const mtea::codegen::BlockFunction fcn) const {
+    std::vector<std::string> fcn_lines;
+
+    for (const auto& blk : program.blocks) {
+        for (const auto& [field, sig] : blk.inputs) {
+            fcn_lines.push_back(fmt::format("{}.{} = {};", blk.varname, field, get_flat_signal_value(sig, 0)));
+        }
+
+        if (const auto fcn_name = blk.component->get_function_name(fcn)) {
+            fcn_lines.push_back(fmt::format("{}.{}();", blk.varname, *fcn_name));
+        }
+    }
+
+    // Outputs are copied once at the end of each function, as the only copy across the original model boundaries
+    const auto output_def = *get_output_type();
+    for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+        fcn_lines.push_back(fmt::format("{}.{} = {};", output_def.get_name(), output_def.get_field(port_num),
+                                        get_flat_signal_value(program.outputs[port_num], 0)));
+    }
+
+    return fcn_lines;
+}
+
+std::vector<ModelCodeComponent::FlatSignal> ModelCodeComponent::get_batched_signals(const FlatProgram& program) {
+    // Only block outputs that are read by another block or a model output are given array storage
+    std::vector<FlatSignal> signals;
+    const auto add_signal = [&signals](const FlatSignal& sig) {
+        const auto matches = [&sig](const FlatSignal& s) { return s.block_var == sig.block_var && s.port_num == sig.port_num; };
+        if (!sig.input_port.has_value() && std::ranges::none_of(signals, matches)) {
+            signals.push_back(sig);
+        }
+    };
+
+    for (const auto& blk : program.blocks) {
+        for (const auto& sig : blk.inputs | std::views::values) {
+            add_signal(sig);
+        }
+    }
+
+    for (const auto& sig : program.outputs) {
+        add_signal(sig);
+    }
+
+    return signals;
+}
+
+std::vector<std::string> ModelCodeComponent::get_batched_function_lines(const FlatProgram& program, const mtea::codegen::BlockFunction fcn,
+                                                                        const mtea::codegen::CodegenOptions& options) const {
+    const auto signals = get_batched_signals(program);
+    std::vector<std::string> fcn_lines;
+
+    // Each block is run over every instance before the next block, so that each loop only touches one block type
+    for (const auto& blk : program.blocks) {
+        const auto fcn_name = blk.component->get_function_name(fcn);
+        const auto is_stored = [&blk](const FlatSignal& s) { return s.block_var == blk.varname; };
+
+        if (blk.inputs.empty() && !fcn_name.has_value() && std::ranges::none_of(signals, is_stored)) {
+            continue;
+        }
+
+        fcn_lines.emplace_back("");
+        fcn_lines.emplace_back("for (size_t i = 0; i < n; ++i)");
+        fcn_lines.emplace_back("{");
+
+        for (const auto& [field, sig] : blk.inputs) {
+            fcn_lines.push_back(fmt::format("    {}[i].{} = {};", blk.varname, field, get_flat_signal_value(sig, options.batch_size)));
+        }
+
+        if (fcn_name.has_value()) {
+            fcn_lines.push_back(fmt::format("    {}[i].{}();", blk.varname, *fcn_name));
+        }
+
+        for (const auto& sig : signals | std::views::filter(is_stored)) {
+            fcn_lines.push_back(fmt::format("    {}[i] = {}[i].{};", get_signal_storage_name(sig), blk.varname, sig.output_field));
+        }
+
+        fcn_lines.emplace_back("}");
+    }
+
+    if (!program.outputs.empty()) {
+        const auto output_def = *get_output_type();
+
+        fcn_lines.emplace_back("");
+        fcn_lines.emplace_back("for (size_t i = 0; i < n; ++i)");
+        fcn_lines.emplace_back("{");
+        for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+            fcn_lines.push_back(fmt::format("    {}.{}[i] = {};", output_def.get_name(), output_def.get_field(port_num),
+                                            get_flat_signal_value(program.outputs[port_num], options.batch_size)));
+        }
+        fcn_lines.emplace_back("}");
+    }
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_batched_members(const FlatProgram& program,
+                                                                 const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> members;
+
+    // Blocks with constructor arguments are built for each instance, as an array cannot otherwise pass them to every element
+    const auto has_arguments = [](const FlatBlock& blk) { return !blk.component->constructor_arguments().empty(); };
+    if (std::ranges::any_of(program.blocks, has_arguments)) {
+        members.emplace_back("template <typename T, typename... Args>");
+        members.emplace_back("static std::array<T, CAPACITY> make_instances(const Args&... args)");
+        members.emplace_back("{");
+        members.emplace_back("    return [&]<size_t... I>(std::index_sequence<I...>) {");
+        members.emplace_back("        return std::array<T, CAPACITY>{((void)I, T{args...})...};");
+        members.emplace_back("    }(std::make_index_sequence<CAPACITY>{});");
+        members.emplace_back("}");
+        members.emplace_back("");
+    }
+
+    for (const auto& blk : program.blocks) {
+        const auto& comp = *blk.component;
+        const auto args = get_argument_list(comp, blk.varname, options);
+
+        if (args.empty()) {
+            members.push_back(fmt::format("std::array<{}, CAPACITY> {}{{}};", comp.get_type_name(), blk.varname));
+        } else {
+            members.push_back(fmt::format("std::array<{}, CAPACITY> {} = make_instances<{}>({});", comp.get_type_name(), blk.varname,
+                                          comp.get_type_name(), args));
+        }
+    }
+
+    const auto signals = get_batched_signals(program);
+    if (!signals.empty()) {
+        members.emplace_back("");
+        for (const auto& sig : signals) {
+            members.push_back(fmt::format("std::remove_cvref_t<decltype({}[0].{})> {}[CAPACITY]{{}};", sig.block_var, sig.output_field,
+                                          get_signal_storage_name(sig)));
+        }
+    }
+
+    return members;
+}
@@ -0,0 +1,582 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "codegen_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ranges>
+
+#include <fmt/format.h>
+
+using namespace mtea::codegen;
+
+/* ==================== PARTITIONED SCHEDULE ==================== */
+
+std::unordered_map<std::string, size_t> ModelCodeComponent::get_flat_block_indices(const FlatProgram& program) {
+    std::unordered_map<std::string, size_t> indices;
+    for (size_t i = 0; i < program.blocks.size(); ++i) {
+        indices.emplace(program.blocks[i].varname, i);
+    }
+    return indices;
+}
+
+ModelCodeComponent::FlatSchedule ModelCodeComponent::get_flat_schedule(const FlatProgram& program,
+                                                                       const mtea::codegen::CodegenOptions& options) {
+    const auto n = program.blocks.size();
+    const auto indices = get_flat_block_indices(program);
+
+    const auto get_cost = [&options](const FlatBlock& blk) {
+        const auto it = options.block_costs.find(blk.component->get_type_name());
+        return it != options.block_costs.end() ? it->second : 1.0;
+    };
+
+    // Partitions wait on each other every step, which costs far more than a simple block, and so each partition must be given
+    // enough work to outweigh that wait, falling back to fewer partitions or to serial code for models with little work
+    double total_cost = 0.0;
+    for (const auto& blk : program.blocks) {
+        total_cost += get_cost(blk);
+    }
+
+    const auto affordable = options.min_partition_cost > 0.0 ? static_cast<size_t>(total_cost / options.min_partition_cost) : n;
+    const auto k = std::clamp<size_t>(affordable, 1, std::max<size_t>(options.num_partitions, 1));
+
+    FlatSchedule schedule{
+        .num_partitions = k,
+        .partition = std::vector<size_t>(n, 0),
+        .is_read_across = std::vector<bool>(n, false),
+        .reads_across = std::vector<bool>(n, false),
+        .consumers = std::vector<std::vector<size_t>>(n),
+        .buffered = {},
+    };
+
+    if (k == 1) {
+        return schedule;
+    }
+
+    // Cost of waiting on another partition, relative to a block with the default cost of one
+    constexpr double SYNC_COST = 1.0;
+
+    // List scheduling in the serial execution order, placing each block on the partition where it would finish first
+    std::vector<double> finish(n, 0.0);
+    std::vector<double> partition_time(k, 0.0);
+
+    for (size_t j = 0; j < n; ++j) {
+        const double cost = get_cost(program.blocks[j]);
+
+        size_t best_partition = 0;
+        double best_finish = std::numeric_limits<double>::infinity();
+
+        for (size_t p = 0; p < k; ++p) {
+            double start = partition_time[p];
+            for (const auto& sig : program.blocks[j].inputs | std::views::values) {
+                if (sig.input_port.has_value()) {
+                    continue;
+                }
+
+                // Only earlier blocks are dependencies, as later blocks are read from the previous step
+                if (const auto i = indices.at(sig.block_var); i < j) {
+                    start = std::max(start, finish[i] + (schedule.partition[i] != p ? SYNC_COST : 0.0));
+                }
+            }
+
+            if (start + cost < best_finish) {
+                best_finish = start + cost;
+                best_partition = p;
+            }
+        }
+
+        schedule.partition[j] = best_partition;
+        finish[j] = best_finish;
+        partition_time[best_partition] = best_finish;
+    }
+
+    // Record the edges between partitions, which are the only places that partitions synchronise
+    for (size_t j = 0; j < n; ++j) {
+        for (const auto& sig : program.blocks[j].inputs | std::views::values) {
+            if (sig.input_port.has_value()) {
+                continue;
+            }
+
+            const auto i = indices.at(sig.block_var);
+            if (schedule.partition[i] == schedule.partition[j]) {
+                continue;
+            }
+
+            schedule.is_read_across[i] = true;
+            schedule.reads_across[j] = true;
+            if (std::ranges::find(schedule.consumers[i], j) == schedule.consumers[i].end()) {
+                schedule.consumers[i].push_back(j);
+            }
+
+            const auto matches = [&sig](const FlatSignal& s) { return s.block_var == sig.block_var && s.port_num == sig.port_num; };
+            if (i > j && std::ranges::none_of(schedule.buffered, matches)) {
+                schedule.buffered.push_back(sig);
+            }
+        }
+    }
+
+    return schedule;
+}
+
+std::string ModelCodeComponent::get_buffer_name(const FlatSignal& sig) { return fmt::format("{}_buf", get_signal_storage_name(sig)); }
+
+bool ModelCodeComponent::is_buffered(const FlatSchedule& schedule, const FlatSignal& sig) {
+    return std::ranges::any_of(schedule.buffered,
+                               [&sig](const FlatSignal& s) { return s.block_var == sig.block_var && s.port_num == sig.port_num; });
+}
+
+std::vector<std::string> ModelCodeComponent::get_partition_reset_lines(const FlatProgram& program, const FlatSchedule& schedule) {
+    std::vector<std::string> fcn_lines;
+    fcn_lines.emplace_back("");
+
+    // Delayed signals read by another partition are read from the buffer of the previous step
+    for (const auto& sig : schedule.buffered) {
+        fcn_lines.push_back(fmt::format("{}[0] = {}.{};", get_buffer_name(sig), sig.block_var, sig.output_field));
+    }
+
+    for (size_t p = 0; p < schedule.num_partitions; ++p) {
+        fcn_lines.push_back(fmt::format("_epoch_{} = 0;", p));
+    }
+
+    for (size_t i = 0; i < program.blocks.size(); ++i) {
+        if (schedule.is_read_across[i]) {
+            fcn_lines.push_back(fmt::format("{}_ready.store(0, std::memory_order_relaxed);", program.blocks[i].varname));
+        }
+        if (schedule.reads_across[i]) {
+            fcn_lines.push_back(fmt::format("{}_ack.store(0, std::memory_order_relaxed);", program.blocks[i].varname));
+        }
+    }
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_partition_functions(const FlatProgram& program, const FlatSchedule& schedule) const {
+    const auto indices = get_flat_block_indices(program);
+    const auto output_def = *get_output_type();
+
+    std::vector<std::string> fcn_lines;
+
+    for (size_t p = 0; p < schedule.num_partitions; ++p) {
+        fcn_lines.emplace_back("");
+        fcn_lines.push_back(fmt::format("// Partition {} of step, called once per step from its own thread", p));
+        fcn_lines.push_back(fmt::format("void step_{}()", p));
+        fcn_lines.emplace_back("{");
+
+        // Partitions that share no signals with another partition run without synchronisation
+        const auto synchronised = std::ranges::any_of(std::views::iota(size_t{0}, program.blocks.size()), [&](const size_t j) {
+            return schedule.partition[j] == p && (schedule.reads_across[j] || schedule.is_read_across[j]);
+        });
+
+        if (synchronised) {
+            fcn_lines.push_back(fmt::format("    const uint64_t epoch = ++_epoch_{};", p));
+        }
+
+        for (size_t j = 0; j < program.blocks.size(); ++j) {
+            if (schedule.partition[j] != p) {
+                continue;
+            }
+
+            const auto& blk = program.blocks[j];
+            if (fcn_lines.back() != "{") {
+                fcn_lines.emplace_back("");
+            }
+
+            // Wait for inputs from other partitions, where later blocks only need to have completed the previous step
+            std::vector<size_t> waited;
+            for (const auto& sig : blk.inputs | std::views::values) {
+                if (sig.input_port.has_value()) {
+                    continue;
+                }
+
+                const auto i = indices.at(sig.block_var);
+                if (schedule.partition[i] == p || std::ranges::find(waited, i) != waited.end()) {
+                    continue;
+                }
+
+                waited.push_back(i);
+                fcn_lines.push_back(fmt::format("    while ({}_ready.load(std::memory_order_acquire){} < epoch) {{}}", sig.block_var,
+                                                i < j ? "" : " + 1"));
+            }
+
+            for (const auto& [field, sig] : blk.inputs) {
+                std::string value;
+                if (!sig.input_port.has_value() && schedule.partition[indices.at(sig.block_var)] != p && is_buffered(schedule, sig)) {
+                    value = fmt::format("{}[(epoch - 1) & 1]", get_buffer_name(sig));
+                } else {
+                    value = get_flat_signal_value(sig, 0);
+                }
+
+                fcn_lines.push_back(fmt::format("    {}.{} = {};", blk.varname, field, value));
+            }
+
+            if (schedule.reads_across[j]) {
+                fcn_lines.push_back(fmt::format("    {}_ack.store(epoch, std::memory_order_release);", blk.varname));
+            }
+
+            // Outputs read by another partition are not overwritten until every reader has taken the previous value
+            for (const auto c : schedule.consumers[j]) {
+                fcn_lines.push_back(
+                    fmt::format("    while ({}_ack.load(std::memory_order_acquire) + 1 < epoch) {{}}", program.blocks[c].varname));
+            }
+
+            if (const auto fcn_name = blk.component->get_function_name(mtea::codegen::BlockFunction::STEP)) {
+                fcn_lines.push_back(fmt::format("    {}.{}();", blk.varname, *fcn_name));
+            }
+
+            for (const auto& sig : schedule.buffered) {
+                if (sig.block_var == blk.varname) {
+                    fcn_lines.push_back(
+                        fmt::format("    {}[epoch & 1] = {}.{};", get_buffer_name(sig), sig.block_var, sig.output_field));
+                }
+            }
+
+            if (schedule.is_read_across[j]) {
+                fcn_lines.push_back(fmt::format("    {}_ready.store(epoch, std::memory_order_release);", blk.varname));
+            }
+
+            for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+                if (program.outputs[port_num].block_var == blk.varname) {
+                    fcn_lines.push_back(fmt::format("    {}.{} = {};", output_def.get_name(), output_def.get_field(port_num),
+                                                    get_flat_signal_value(program.outputs[port_num], 0)));
+                }
+            }
+        }
+
+        // Outputs connected directly to inputs are copied by the first partition
+        if (p == 0) {
+            for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+                if (program.outputs[port_num].input_port.has_value()) {
+                    fcn_lines.push_back(fmt::format("    {}.{} = {};", output_def.get_name(), output_def.get_field(port_num),
+                                                    get_flat_signal_value(program.outputs[port_num], 0)));
+                }
+            }
+        }
+
+        fcn_lines.emplace_back("}");
+    }
+
+    fcn_lines.emplace_back("");
+    fcn_lines.emplace_back("void step_partition(const size_t k)");
+    fcn_lines.emplace_back("{");
+    fcn_lines.emplace_back("    switch (k)");
+    fcn_lines.emplace_back("    {");
+    for (size_t p = 0; p < schedule.num_partitions; ++p) {
+        fcn_lines.push_back(fmt::format("    case {}:", p));
+        fcn_lines.push_back(fmt::format("        step_{}();", p));
+        fcn_lines.emplace_back("        break;");
+    }
+    fcn_lines.emplace_back("    default:");
+    fcn_lines.emplace_back("        break;");
+    fcn_lines.emplace_back("    }");
+    fcn_lines.emplace_back("}");
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_partition_members(const FlatProgram& program, const FlatSchedule& schedule) {
+    std::vector<std::string> members;
+    members.emplace_back("");
+
+    // Each flag is kept on its own cache line, so that partitions spinning on one flag do not contend with writes to another
+    for (size_t p = 0; p < schedule.num_partitions; ++p) {
+        members.push_back(fmt::format("alignas(64) uint64_t _epoch_{}{{0}};", p));
+    }
+
+    for (size_t i = 0; i < program.blocks.size(); ++i) {
+        if (schedule.is_read_across[i]) {
+            members.push_back(fmt::format("alignas(64) std::atomic<uint64_t> {}_ready{{0}};", program.blocks[i].varname));
+        }
+        if (schedule.reads_across[i]) {
+            members.push_back(fmt::format("alignas(64) std::atomic<uint64_t> {}_ack{{0}};", program.blocks[i].varname));
+        }
+    }
+
+    for (const auto& sig : schedule.buffered) {
+        members.push_back(
+            fmt::format("std::remove_cvref_t<decltype({}.{})> {}[2]{{}};", sig.block_var, sig.output_field, get_buffer_name(sig)));
+    }
+
+    return members;
+}
+
+/* ==================== MULTI-RATE GROUPS ==================== */
+
+ModelCodeComponent::FlatRates ModelCodeComponent::get_flat_rates(const FlatProgram& program) {
+    FlatRates rates;
+
+    for (const auto& blk : program.blocks) {
+        if (std::ranges::find(rates.ticks, blk.rate_ticks) == rates.ticks.end()) {
+            rates.ticks.push_back(blk.rate_ticks);
+        }
+    }
+
+    if (rates.ticks.empty()) {
+        rates.ticks.push_back(1);
+    }
+
+    std::ranges::sort(rates.ticks);
+
+    for (const auto& blk : program.blocks) {
+        rates.group.push_back(static_cast<size_t>(std::ranges::find(rates.ticks, blk.rate_ticks) - rates.ticks.begin()));
+    }
+
+    const auto indices = get_flat_block_indices(program);
+    for (size_t j = 0; j < program.blocks.size(); ++j) {
+        for (const auto& sig : program.blocks[j].inputs | std::views::values) {
+            if (sig.input_port.has_value()) {
+                continue;
+            }
+
+            const auto from = rates.group[indices.at(sig.block_var)];
+            const auto to = rates.group[j];
+            if (from == to) {
+                continue;
+            }
+
+            const auto matches = [&sig, to](const RateTransition& t) {
+                return t.signal.block_var == sig.block_var && t.signal.port_num == sig.port_num && t.to_group == to;
+            };
+
+            if (std::ranges::none_of(rates.transitions, matches)) {
+                rates.transitions.push_back(RateTransition{.signal = sig, .from_group = from, .to_group = to});
+            }
+        }
+    }
+
+    // Groups only exchange signals when one period is a whole multiple of the other, so that transitions happen on shared steps
+    for (const auto& t : rates.transitions) {
+        const auto slow = std::max(rates.ticks[t.from_group], rates.ticks[t.to_group]);
+        const auto fast = std::min(rates.ticks[t.from_group], rates.ticks[t.to_group]);
+        if (slow % fast != 0) {
+            throw mtea::codegen::CodegenError(
+                fmt::format("rate transition from {} requires harmonic periods, but has {} and {} base steps", t.signal.block_var,
+                            rates.ticks[t.from_group], rates.ticks[t.to_group]));
+        }
+    }
+
+    return rates;
+}
+
+std::string ModelCodeComponent::get_rate_name(const size_t ticks) const {
+    const double period = _base_dt * static_cast<double>(ticks);
+    for (const auto& [scale, unit] : {std::pair{1e3, "ms"}, std::pair{1e6, "us"}}) {
+        const double value = period * scale;
+        if (value >= 1.0 && std::abs(value - std::round(value)) <= 1e-9 * value) {
+            return fmt::format("{}{}", std::llround(value), unit);
+        }
+    }
+
+    return fmt::format("{}ticks", ticks);
+}
+
+std::string ModelCodeComponent::get_transition_name(const RateTransition& t, const FlatRates& rates) const {
+    return fmt::format("{}_to_{}", get_signal_storage_name(t.signal), get_rate_name(rates.ticks[t.to_group]));
+}
+
+std::vector<std::string> ModelCodeComponent::get_rate_reset_lines(const FlatRates& rates) const {
+    std::vector<std::string> fcn_lines;
+    fcn_lines.emplace_back("");
+
+    // Transition buffers start from the reset outputs of their source blocks
+    for (const auto& t : rates.transitions) {
+        const auto buffer = get_transition_name(t, rates);
+        const auto value = get_flat_signal_value(t.signal, 0);
+        fcn_lines.push_back(fmt::format("{} = {};", buffer, value));
+        if (t.from_group > t.to_group) {
+            fcn_lines.push_back(fmt::format("{}_next = {};", buffer, value));
+        }
+    }
+
+    fcn_lines.emplace_back("_tick = 0;");
+    for (const auto ticks : rates.ticks) {
+        fcn_lines.push_back(fmt::format("_tick_{} = 0;", get_rate_name(ticks)));
+    }
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_rate_step_lines(const FlatRates& rates,
+                                                                 const mtea::codegen::CodegenOptions& options) const {
+    std::vector<std::string> fcn_lines;
+
+    if (options.rate_dispatcher) {
+        fcn_lines.emplace_back("release_rates([this](const size_t k) { step_rate(k); });");
+        return fcn_lines;
+    }
+
+    // Groups due on the same base step are run in rate-monotonic order, so that faster groups always run first
+    if (rates.ticks.back() > 1) {
+        fcn_lines.emplace_back("const size_t tick = _tick++;");
+    } else {
+        fcn_lines.emplace_back("++_tick;");
+    }
+
+    for (const auto ticks : rates.ticks) {
+        if (ticks == 1) {
+            fcn_lines.push_back(fmt::format("step_{}();", get_rate_name(ticks)));
+        } else {
+            fcn_lines.push_back(fmt::format("if (tick % {} == 0)", ticks));
+            fcn_lines.emplace_back("{");
+            fcn_lines.push_back(fmt::format("    step_{}();", get_rate_name(ticks)));
+            fcn_lines.emplace_back("}");
+        }
+    }
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_rate_functions(const FlatProgram& program, const FlatRates& rates,
+                                                                const mtea::codegen::CodegenOptions& options) const {
+    const auto output_def = *get_output_type();
+
+    const auto find_transition = [&rates](const FlatSignal& sig, const size_t to) {
+        return std::ranges::find_if(rates.transitions, [&sig, to](const RateTransition& t) {
+            return t.signal.block_var == sig.block_var && t.signal.port_num == sig.port_num && t.to_group == to;
+        });
+    };
+
+    std::vector<std::string> fcn_lines;
+
+    for (size_t g = 0; g < rates.ticks.size(); ++g) {
+        const auto rate_name = get_rate_name(rates.ticks[g]);
+        const auto uses_tick = std::ranges::any_of(rates.transitions, [g](const RateTransition& t) {
+            return (t.from_group == g && t.to_group > g) || (t.to_group == g && t.from_group > g);
+        });
+
+        fcn_lines.emplace_back("");
+        fcn_lines.push_back(fmt::format("// Rate group with a period of {} base steps", rates.ticks[g]));
+        fcn_lines.push_back(fmt::format("void step_{}()", rate_name));
+        fcn_lines.emplace_back("{");
+
+        if (uses_tick) {
+            fcn_lines.push_back(fmt::format("    const size_t tick = _tick_{}++;", rate_name));
+        } else {
+            fcn_lines.push_back(fmt::format("    ++_tick_{};", rate_name));
+        }
+
+        // Outputs of slower groups are taken once per slower period, at the start of the step where that group is released
+        for (const auto& t : rates.transitions) {
+            if (t.to_group == g && t.from_group > g) {
+                const auto buffer = get_transition_name(t, rates);
+                fcn_lines.push_back(fmt::format("    if (tick % {} == 0)", rates.ticks[t.from_group] / rates.ticks[g]));
+                fcn_lines.emplace_back("    {");
+                fcn_lines.push_back(fmt::format("        {} = {}_next;", buffer, buffer));
+                fcn_lines.emplace_back("    }");
+            }
+        }
+
+        for (size_t j = 0; j < program.blocks.size(); ++j) {
+            if (rates.group[j] != g) {
+                continue;
+            }
+
+            const auto& blk = program.blocks[j];
+            for (const auto& [field, sig] : blk.inputs) {
+                std::string value;
+                if (const auto it = find_transition(sig, g); !sig.input_port.has_value() && it != rates.transitions.end()) {
+                    value = get_transition_name(*it, rates);
+                } else {
+                    value = get_flat_signal_value(sig, 0);
+                }
+
+                fcn_lines.push_back(fmt::format("    {}.{} = {};", blk.varname, field, value));
+            }
+
+            if (const auto fcn_name = blk.component->get_function_name(mtea::codegen::BlockFunction::STEP)) {
+                fcn_lines.push_back(fmt::format("    {}.{}();", blk.varname, *fcn_name));
+            }
+
+            for (const auto& t : rates.transitions) {
+                if (t.signal.block_var != blk.varname) {
+                    continue;
+                }
+
+                // Slower readers are given the value held from the step where they are released
+                const auto buffer = get_transition_name(t, rates);
+                const auto value = get_flat_signal_value(t.signal, 0);
+                if (t.to_group > g) {
+                    fcn_lines.push_back(fmt::format("    if (tick % {} == 0)", rates.ticks[t.to_group] / rates.ticks[g]));
+                    fcn_lines.emplace_back("    {");
+                    fcn_lines.push_back(fmt::format("        {} = {};", buffer, value));
+                    fcn_lines.emplace_back("    }");
+                } else {
+                    fcn_lines.push_back(fmt::format("    {}_next = {};", buffer, value));
+                }
+            }
+
+            for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+                if (program.outputs[port_num].block_var == blk.varname) {
+                    fcn_lines.push_back(fmt::format("    {}.{} = {};", output_def.get_name(), output_def.get_field(port_num),
+                                                    get_flat_signal_value(program.outputs[port_num], 0)));
+                }
+            }
+        }
+
+        // Outputs connected directly to inputs are copied by the fastest group
+        if (g == 0) {
+            for (size_t port_num = 0; port_num < program.outputs.size(); ++port_num) {
+                if (program.outputs[port_num].input_port.has_value()) {
+                    fcn_lines.push_back(fmt::format("    {}.{} = {};", output_def.get_name(), output_def.get_field(port_num),
+                                                    get_flat_signal_value(program.outputs[port_num], 0)));
+                }
+            }
+        }
+
+        fcn_lines.emplace_back("}");
+    }
+
+    if (options.rate_dispatcher) {
+        fcn_lines.emplace_back("");
+        fcn_lines.emplace_back("// Releases the rate groups due on the next base step in rate-monotonic order, for running each group");
+        fcn_lines.emplace_back("// from its own task, which must complete within its period");
+        fcn_lines.emplace_back("template <typename F> void release_rates(F&& release)");
+        fcn_lines.emplace_back("{");
+        fcn_lines.emplace_back("    const size_t tick = _tick++;");
+        fcn_lines.emplace_back("    for (size_t k = 0; k < NUM_RATES; ++k)");
+        fcn_lines.emplace_back("    {");
+        fcn_lines.emplace_back("        if (tick % RATE_TICKS[k] == 0)");
+        fcn_lines.emplace_back("        {");
+        fcn_lines.emplace_back("            release(k);");
+        fcn_lines.emplace_back("        }");
+        fcn_lines.emplace_back("    }");
+        fcn_lines.emplace_back("}");
+        fcn_lines.emplace_back("");
+        fcn_lines.emplace_back("void step_rate(const size_t k)");
+        fcn_lines.emplace_back("{");
+        fcn_lines.emplace_back("    switch (k)");
+        fcn_lines.emplace_back("    {");
+        for (size_t g = 0; g < rates.ticks.size(); ++g) {
+            fcn_lines.push_back(fmt::format("    case {}:", g));
+            fcn_lines.push_back(fmt::format("        step_{}();", get_rate_name(rates.ticks[g])));
+            fcn_lines.emplace_back("        break;");
+        }
+        fcn_lines.emplace_back("    default:");
+        fcn_lines.emplace_back("        break;");
+        fcn_lines.emplace_back("    }");
+        fcn_lines.emplace_back("}");
+    }
+
+    return fcn_lines;
+}
+
+std::vector<std::string> ModelCodeComponent::get_rate_members(const FlatRates& rates) const {
+    std::vector<std::string> members;
+    members.emplace_back("");
+
+    members.emplace_back("size_t _tick{0};");
+    for (const auto ticks : rates.ticks) {
+        members.push_back(fmt::format("size_t _tick_{}{{0}};", get_rate_name(ticks)));
+    }
+
+    for (const auto& t : rates.transitions) {
+        const auto type = fmt::format("std::remove_cvref_t<decltype({}.{})>", t.signal.block_var, t.signal.output_field);
+        const auto buffer = get_transition_name(t, rates);
+        members.push_back(fmt::format("{} {}{{}};", type, buffer));
+        if (t.from_group > t.to_group) {
+            members.push_back(fmt::format("{} {}_next{{}};", type, buffer));
+        }
+    }
+
+    return members;
+}
@@ -6,10 +6,34 @@
 
 #include <algorithm>
 
-std::vector<std::shared_ptr<mtea::Connection>>::const_iterator
-get_iter_for_block(const std::vector<std::shared_ptr<mtea::Connection>>& connections, const size_t to_block, const size_t to_port) {
-    return std::ranges::find_if(connections,
-                                [to_block, to_port](const auto& c) { return c->get_to_id() == to_block && c->get_to_port() == to_port; });
+static std::shared_ptr<mtea::Connection>
+find_in_index(const std::unordered_map<size_t, std::vector<std::shared_ptr<mtea::Connection>>>& to_index, const size_t to_block,
+              const size_t to_port) {
+    const auto blk_it = to_index.find(to_block);
+    if (blk_it == to_index.end()) {
+        return nullptr;
+    }
+
+    const auto it = std::ranges::find_if(blk_it->second, [to_port](const auto& c) { return c->get_to_port() == to_port; });
+    if (it == blk_it->second.end()) {
+        return nullptr;
+    } else {
+        return *it;
+    }
+}
+
+static void erase_from_index(std::unordered_map<size_t, std::vector<std::shared_ptr<mtea::Connection>>>& index, const size_t block_id,
+                             const std::shared_ptr<mtea::Connection>& c) {
+    const auto blk_it = index.find(block_id);
+    if (blk_it == index.end()) {
+        return;
+    }
+
+    std::erase(blk_it->second, c);
+
+    if (blk_it->second.empty()) {
+        index.erase(blk_it);
+    }
 }
 
 void mtea::ConnectionManager::add_connection(const std::shared_ptr<Connection> c) {
@@ -17,12 +41,12 @@ void mtea::ConnectionManager::add_connection(const std::shared_ptr<Connection> c
         throw ModelException("cannot add a null connection");
     }
 
-    const auto it = get_iter_for_block(connections, c->get_to_id(), c->get_to_port());
-
-    if (it != connections.end()) {
+    if (find_in_index(to_index, c->get_to_id(), c->get_to_port()) != nullptr) {
         throw ModelException("duplicate connection provided");
     } else {
         connections.push_back(c);
+        from_index[c->get_from_id()].push_back(c);
+        to_index[c->get_to_id()].push_back(c);
     }
 }
 
@@ -32,6 +56,7 @@ void mtea::ConnectionManager::remove_block(const size_t block_id) {
         const auto& c = connections[i];
 
         if (c->get_to_id() == block_id || c->get_from_id() == block_id) {
+            remove_from_index(c);
             connections.erase(connections.begin() + i);
         } else {
             i += 1;
@@ -40,27 +65,26 @@ void mtea::ConnectionManager::remove_block(const size_t block_id) {
 }
 
 void mtea::ConnectionManager::remove_connection(const size_t to_block, const size_t to_port) {
-    const auto it = get_iter_for_block(connections, to_block, to_port);
+    const auto c = find_in_index(to_index, to_block, to_port);
 
-    if (it != connections.end()) {
-        connections.erase(it);
+    if (c != nullptr) {
+        remove_from_index(c);
+        std::erase(connections, c);
     } else {
         throw ModelException("no connection found for provided block port");
     }
 }
 
 std::shared_ptr<mtea::Connection> mtea::ConnectionManager::get_connection_to(const size_t to_block, const size_t to_port) const {
-    const auto it = get_iter_for_block(connections, to_block, to_port);
-
-    if (it != connections.end()) {
-        return *it;
+    if (auto c = find_in_index(to_index, to_block, to_port)) {
+        return c;
     } else {
         throw ModelException("no connection found for provided block port");
     }
 }
 
 bool mtea::ConnectionManager::has_connection_to(const size_t to_block, const size_t to_port) const {
-    return get_iter_for_block(connections, to_block, to_port) != connections.end();
+    return find_in_index(to_index, to_block, to_port) != nullptr;
 }
 
 std::vector<std::shared_ptr<const mtea::Connection>> mtea::ConnectionManager::get_connections() const {
@@ -68,6 +92,27 @@ std::vector<std::shared_ptr<const mtea::Connection>> mtea::ConnectionManager::ge
     return out;
 }
 
+std::vector<std::shared_ptr<const mtea::Connection>> mtea::ConnectionManager::get_connections_from(const size_t from_block) const {
+    if (const auto it = from_index.find(from_block); it != from_index.end()) {
+        return {it->second.begin(), it->second.end()};
+    } else {
+        return {};
+    }
+}
+
+std::vector<std::shared_ptr<const mtea::Connection>> mtea::ConnectionManager::get_connections_to(const size_t to_block) const {
+    if (const auto it = to_index.find(to_block); it != to_index.end()) {
+        return {it->second.begin(), it->second.end()};
+    } else {
+        return {};
+    }
+}
+
+void mtea::ConnectionManager::remove_from_index(const std::shared_ptr<Connection>& c) {
+    erase_from_index(from_index, c->get_from_id(), c);
+    erase_from_index(to_index, c->get_to_id(), c);
+}
+
 void mtea::to_json(nlohmann::json& j, const ConnectionManager& cm) {
     std::vector<mtea::Connection> conn;
 
@@ -2,6 +2,8 @@
 
 #include "data_dictionary.hpp"
 
+#include "mapped_data_dictionary.hpp"
+
 #include <fstream>
 #include <iomanip>
 
@@ -11,6 +13,10 @@ void mtea::DataDictionary::add_value(const Identifier& i, std::unique_ptr<ModelV
     vals.emplace(std::make_pair(i, std::move(val)));
 }
 
+void mtea::DataDictionary::add_array(const Identifier& i, std::unique_ptr<ValueArray>&& arr) {
+    arrays.emplace(std::make_pair(i, std::move(arr)));
+}
+
 mtea::ModelValue* mtea::DataDictionary::get_value(const Identifier& i) const {
     if (const auto it = vals.find(i); it != vals.end()) {
         return it->second.get();
@@ -19,6 +25,14 @@ mtea::ModelValue* mtea::DataDictionary::get_value(const Identifier& i) const {
     }
 }
 
+mtea::ValueArray* mtea::DataDictionary::get_array(const Identifier& i) const {
+    if (const auto it = arrays.find(i); it != arrays.end()) {
+        return it->second.get();
+    } else {
+        return nullptr;
+    }
+}
+
 std::vector<std::pair<mtea::Identifier, mtea::ModelValue*>> mtea::DataDictionary::get_values() const {
     std::vector<std::pair<Identifier, ModelValue*>> rvals{};
     for (const auto& [k, v] : vals) {
@@ -27,10 +41,72 @@ std::vector<std::pair<mtea::Identifier, mtea::ModelValue*>> mtea::DataDictionary
     return rvals;
 }
 
+std::vector<std::pair<mtea::Identifier, mtea::ValueArray*>> mtea::DataDictionary::get_arrays() const {
+    std::vector<std::pair<Identifier, ValueArray*>> rvals{};
+    for (const auto& [k, v] : arrays) {
+        rvals.emplace_back(std::make_pair(k, v.get()));
+    }
+    return rvals;
+}
+
+std::vector<std::pair<mtea::Identifier, std::unique_ptr<mtea::ModelValue>>> mtea::DataDictionary::copy_values() const {
+    std::vector<std::pair<Identifier, std::unique_ptr<ModelValue>>> rvals{};
+    for (const auto& [k, v] : vals) {
+        rvals.emplace_back(k, v->clone());
+    }
+
+    // Entries held in memory replace those of the mapped file
+    for (size_t i = 0; mapped != nullptr && i < mapped->size(); ++i) {
+        if (const auto e = mapped->get_entry(i); !e.is_array) {
+            if (Identifier id(e.name); !vals.contains(id)) {
+                rvals.emplace_back(std::move(id), e.to_value());
+            }
+        }
+    }
+
+    return rvals;
+}
+
+std::vector<std::pair<mtea::Identifier, std::unique_ptr<mtea::ValueArray>>> mtea::DataDictionary::copy_arrays() const {
+    std::vector<std::pair<Identifier, std::unique_ptr<ValueArray>>> rvals{};
+    for (const auto& [k, v] : arrays) {
+        rvals.emplace_back(k, ValueArray::change_array_type(v.get(), v->data_type()));
+    }
+
+    for (size_t i = 0; mapped != nullptr && i < mapped->size(); ++i) {
+        if (const auto e = mapped->get_entry(i); e.is_array) {
+            if (Identifier id(e.name); !arrays.contains(id)) {
+                rvals.emplace_back(std::move(id), e.to_array());
+            }
+        }
+    }
+
+    return rvals;
+}
+
+const mtea::MappedDataDictionary* mtea::DataDictionary::get_mapped() const { return mapped.get(); }
+
+void mtea::DataDictionary::materialize_all() {
+    if (mapped == nullptr) {
+        return;
+    }
+
+    for (size_t i = 0; i < mapped->size(); ++i) {
+        const auto e = mapped->get_entry(i);
+        const Identifier id(e.name);
+
+        if (e.is_array && !arrays.contains(id)) {
+            arrays.emplace(std::make_pair(id, e.to_array()));
+        } else if (!e.is_array && !vals.contains(id)) {
+            vals.emplace(std::make_pair(id, e.to_value()));
+        }
+    }
+}
+
 std::vector<std::string> mtea::DataDictionary::write_code(const codegen::CodeSection section) const {
     std::vector<std::string> output{};
 
-    for (const auto& [k, v] : vals) {
+    for (const auto& [k, v] : copy_values()) {
         const auto dt = codegen::get_datatype_name(v->data_type());
         const auto i = k.get();
 
@@ -55,7 +131,9 @@ std::optional<std::string> mtea::DataDictionary::name() const {
 }
 
 void mtea::DataDictionary::save() const {
-    if (save_path.has_value()) {
+    if (save_path.has_value() && MappedDataDictionary::is_binary_path(*save_path)) {
+        MappedDataDictionary::write(*this, *save_path);
+    } else if (save_path.has_value()) {
         nlohmann::json j;
         j["dict"] = *this;
 
@@ -73,6 +151,14 @@ void mtea::DataDictionary::save(const std::filesystem::path& path) {
 
 mtea::DataDictionary mtea::DataDictionary::load(const std::filesystem::path& path) {
     DataDictionary d;
+
+    // Binary dictionaries are mapped rather than read, with entries loaded as they are used
+    if (MappedDataDictionary::is_binary_path(path)) {
+        d.mapped = std::make_shared<const MappedDataDictionary>(path);
+        d.save_path = path;
+        return d;
+    }
+
     nlohmann::json j;
 
     std::ifstream iss(path);
@@ -112,14 +198,61 @@ void from_json(const nlohmann::json& j, ValueStorage& s) {
     j.at("dtype").get_to(s.dtype);
 }
 
+struct ArrayStorage {
+    ArrayStorage() = default;
+    ArrayStorage(const mtea::ValueArray* ptr) {
+        cols = ptr->cols();
+        rows = ptr->rows();
+        dtype = ptr->data_type();
+        for (const auto& v : ptr->get_values()) {
+            values.push_back(v->to_string());
+        }
+    }
+
+    std::unique_ptr<mtea::ValueArray> to_array() const {
+        std::vector<std::unique_ptr<const mtea::ModelValue>> vals;
+        for (const auto& v : values) {
+            vals.push_back(mtea::ModelValue::from_string(v, dtype));
+        }
+        return mtea::ValueArray::create_with_type(cols, rows, vals, dtype);
+    }
+
+    size_t cols{0};
+    size_t rows{0};
+    std::vector<std::string> values{}; // Column-major, matching ValueArray
+    mtea::DataType dtype{mtea::DataType::NONE};
+};
+
+void to_json(nlohmann::json& j, const ArrayStorage& s) {
+    j["cols"] = s.cols;
+    j["rows"] = s.rows;
+    j["values"] = s.values;
+    j["dtype"] = s.dtype;
+}
+
+void from_json(const nlohmann::json& j, ArrayStorage& s) {
+    j.at("cols").get_to(s.cols);
+    j.at("rows").get_to(s.rows);
+    j.at("values").get_to(s.values);
+    j.at("dtype").get_to(s.dtype);
+}
+
 void mtea::to_json(nlohmann::json& j, const DataDictionary& d) {
     std::unordered_map<std::string, ValueStorage> vals;
 
-    for (const auto [k, v] : d.get_values()) {
-        vals.emplace(std::make_pair(k.get(), ValueStorage(v)));
+    for (const auto& [k, v] : d.copy_values()) {
+        vals.emplace(std::make_pair(k.get(), ValueStorage(v.get())));
     }
 
     j["parameters"] = vals;
+
+    std::unordered_map<std::string, ArrayStorage> arrays;
+
+    for (const auto& [k, v] : d.copy_arrays()) {
+        arrays.emplace(std::make_pair(k.get(), ArrayStorage(v.get())));
+    }
+
+    j["arrays"] = arrays;
 }
 
 void mtea::from_json(const nlohmann::json& j, DataDictionary& d) {
@@ -129,4 +262,14 @@ void mtea::from_json(const nlohmann::json& j, DataDictionary& d) {
     for (const auto [k, v] : vals) {
         d.add_value(Identifier(k), mtea::ModelValue::from_string(v.value, v.dtype));
     }
+
+    // Arrays are optional, for dictionaries saved before arrays were supported
+    if (j.contains("arrays")) {
+        std::unordered_map<std::string, ArrayStorage> arrays;
+        j.at("arrays").get_to(arrays);
+
+        for (const auto& [k, v] : arrays) {
+            d.add_array(Identifier(k), v.to_array());
+        }
+    }
 }
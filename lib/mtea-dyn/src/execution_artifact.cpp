@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "execution_artifact.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+
+#include "atomic_file.hpp"
+#include "connection_manager.hpp"
+#include "model.hpp"
+#include "model_block.hpp"
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
+const std::string mtea::ExecutionArtifact::FILE_EXTENSION = ".tmex";
+
+static void collect_sources(const mtea::Model& model, std::vector<std::filesystem::path>& sources) {
+    const auto& filename = model.get_filename();
+    if (!filename.has_value()) {
+        throw mtea::ModelException(fmt::format("cannot create an execution artifact for unsaved model '{}'", model.get_name()));
+    }
+
+    if (std::ranges::find(sources, *filename) != sources.end()) {
+        return;
+    }
+
+    sources.push_back(*filename);
+
+    for (const auto& blk : model.get_blocks()) {
+        if (const auto mdl_blk = std::dynamic_pointer_cast<const mtea::ModelBlock>(blk)) {
+            collect_sources(*mdl_blk->get_model(), sources);
+        }
+    }
+}
+
+size_t mtea::ExecutionArtifact::add_signal(const DataType data_type) {
+    signal_types.push_back(data_type);
+    return signal_types.size() - 1;
+}
+
+size_t mtea::ExecutionArtifact::get_slot(const SlotMap& slots, const VariableIdentifier& id) {
+    if (const auto it = slots.find(id); it != slots.end()) {
+        return it->second;
+    } else {
+        throw ModelException(fmt::format("no artifact signal found for variable {}", id.to_string()));
+    }
+}
+
+bool mtea::ExecutionArtifact::is_current() const {
+    if (sources.empty() || !std::ranges::all_of(sources, [](const auto& p) { return std::filesystem::exists(p); })) {
+        return false;
+    }
+
+    return hash_sources(sources) == source_hash;
+}
+
+void mtea::ExecutionArtifact::save(const std::filesystem::path& path) const {
+    nlohmann::json j = *this;
+
+    write_file_atomic(path, [&j](std::ostream& os) { os << j; });
+}
+
+mtea::ExecutionArtifact mtea::ExecutionArtifact::load(const std::filesystem::path& path) {
+    std::ifstream iss(path);
+    if (!iss) {
+        throw ModelException(fmt::format("unable to open execution artifact '{}'", path.string()));
+    }
+
+    ExecutionArtifact artifact;
+
+    try {
+        from_json(nlohmann::json::parse(iss), artifact);
+    } catch (const nlohmann::json::exception& err) {
+        throw ModelException(fmt::format("unable to load execution artifact '{}' - {}", path.string(), err.what()));
+    }
+
+    return artifact;
+}
+
+mtea::ExecutionArtifact mtea::ExecutionArtifact::from_model(const std::shared_ptr<Model> model, const double dt) {
+    ExecutionArtifact artifact;
+    artifact.dt = dt;
+
+    // Ensure that the block is updated
+    model->update_block();
+
+    // Add each output variable as the first signals
+    SlotMap outer_slots;
+    for (size_t i = 0; i < model->get_num_outputs(); ++i) {
+        const auto slot = artifact.add_signal(model->get_output_datatype(i));
+        outer_slots[VariableIdentifier{.block_id = 0, .output_port_num = i}] = slot;
+        artifact.output_slots.push_back(slot);
+    }
+
+    // Flatten the model hierarchy into leaf blocks
+    const ConnectionManager connections;
+    const auto model_slots = model->add_to_artifact(0, connections, outer_slots, BlockInterface::ModelInfo(dt), artifact);
+
+    for (const auto& [id, slot] : model_slots) {
+        artifact.model_signals.push_back(ModelSignal{.id = id, .slot = slot});
+    }
+
+    std::ranges::sort(artifact.model_signals, [](const ModelSignal& a, const ModelSignal& b) {
+        return std::tie(a.id.block_id, a.id.output_port_num) < std::tie(b.id.block_id, b.id.output_port_num);
+    });
+
+    // Key the artifact on the contents of every model file used
+    collect_sources(*model, artifact.sources);
+    artifact.source_hash = hash_sources(artifact.sources);
+
+    return artifact;
+}
+
+uint64_t mtea::ExecutionArtifact::hash_sources(const std::vector<std::filesystem::path>& sources) {
+    // FNV-1a over the size and contents of each file
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t hash = FNV_OFFSET;
+    const auto add_byte = [&hash](const uint8_t b) {
+        hash ^= b;
+        hash *= FNV_PRIME;
+    };
+
+    for (const auto& p : sources) {
+        std::ifstream iss(p, std::ios::binary);
+        if (!iss) {
+            throw ModelException(fmt::format("unable to read model source '{}'", p.string()));
+        }
+
+        const std::vector<char> contents((std::istreambuf_iterator<char>(iss)), std::istreambuf_iterator<char>());
+
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+            add_byte(static_cast<uint8_t>(static_cast<uint64_t>(contents.size()) >> (8 * i)));
+        }
+
+        for (const auto c : contents) {
+            add_byte(static_cast<uint8_t>(c));
+        }
+    }
+
+    return hash;
+}
+
+void mtea::to_json(nlohmann::json& j, const ExecutionArtifact& a) {
+    j["version"] = ExecutionArtifact::FORMAT_VERSION;
+    j["dt"] = a.dt;
+    j["source_hash"] = a.source_hash;
+
+    auto& sources = j["sources"] = nlohmann::json::array();
+    for (const auto& p : a.sources) {
+        sources.push_back(p.string());
+    }
+
+    j["signals"] = a.signal_types;
+    j["outputs"] = a.output_slots;
+
+    auto& model_signals = j["model_signals"] = nlohmann::json::array();
+    for (const auto& s : a.model_signals) {
+        model_signals.push_back({{"block_id", s.id.block_id}, {"port", s.id.output_port_num}, {"slot", s.slot}});
+    }
+
+    auto& blocks = j["blocks"] = nlohmann::json::array();
+    for (const auto& b : a.blocks) {
+        nlohmann::json jb;
+        jb["library"] = b.library;
+        jb["name"] = b.name;
+        jb["data_types"] = b.data_types;
+        jb["inputs"] = b.inputs;
+        jb["outputs"] = b.outputs;
+
+        if (b.argument) {
+            jb["argument"] = {{"dtype", b.argument->data_type()}, {"value", b.argument->to_string()}};
+        } else {
+            jb["argument"] = nullptr;
+        }
+
+        blocks.push_back(std::move(jb));
+    }
+}
+
+void mtea::from_json(const nlohmann::json& j, ExecutionArtifact& a) {
+    if (const auto version = j.at("version").get<uint32_t>(); version != ExecutionArtifact::FORMAT_VERSION) {
+        throw ModelException(fmt::format("unsupported execution artifact version {}", version));
+    }
+
+    j.at("dt").get_to(a.dt);
+    j.at("source_hash").get_to(a.source_hash);
+
+    a.sources.clear();
+    for (const auto& p : j.at("sources")) {
+        a.sources.emplace_back(p.get<std::string>());
+    }
+
+    j.at("signals").get_to(a.signal_types);
+    j.at("outputs").get_to(a.output_slots);
+
+    a.model_signals.clear();
+    for (const auto& s : j.at("model_signals")) {
+        a.model_signals.push_back(ExecutionArtifact::ModelSignal{
+            .id = VariableIdentifier{.block_id = s.at("block_id").get<size_t>(), .output_port_num = s.at("port").get<size_t>()},
+            .slot = s.at("slot").get<size_t>()});
+    }
+
+    a.blocks.clear();
+    for (const auto& jb : j.at("blocks")) {
+        ExecutionArtifact::Block b;
+        jb.at("library").get_to(b.library);
+        jb.at("name").get_to(b.name);
+        jb.at("data_types").get_to(b.data_types);
+        jb.at("inputs").get_to(b.inputs);
+        jb.at("outputs").get_to(b.outputs);
+
+        if (const auto& arg = jb.at("argument"); !arg.is_null()) {
+            b.argument = ModelValue::from_string(arg.at("value").get<std::string>(), arg.at("dtype").get<DataType>());
+        }
+
+        a.blocks.push_back(std::move(b));
+    }
+
+    // Ensure that every slot reference is in range before any executor is constructed
+    const auto check_slot = [&a](const size_t slot) {
+        if (slot >= a.signal_types.size()) {
+            throw ModelException(fmt::format("execution artifact signal {} out of range", slot));
+        }
+    };
+
+    std::ranges::for_each(a.output_slots, check_slot);
+
+    for (const auto& s : a.model_signals) {
+        check_slot(s.slot);
+    }
+
+    for (const auto& b : a.blocks) {
+        std::ranges::for_each(b.inputs, check_slot);
+        std::ranges::for_each(b.outputs, check_slot);
+    }
+}
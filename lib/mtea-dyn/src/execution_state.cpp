@@ -7,21 +7,61 @@
 #include <fmt/format.h>
 
 #include "model_exception.hpp"
+#include "model_manager.hpp"
+
+class ArtifactExecutor final : public mtea::ModelExecutionInterface {
+public:
+    ArtifactExecutor(std::shared_ptr<const mtea::VariableManager> variable_manager,
+                     std::vector<std::unique_ptr<mtea::BlockExecutionInterface>>&& blocks)
+        : variable_manager(variable_manager), blocks(std::move(blocks)) {
+        // Empty Constructor
+    }
+
+    std::shared_ptr<const mtea::VariableManager> get_variable_manager() const override { return variable_manager; }
+
+protected:
+    void blk_reset() override {
+        for (const auto& b : blocks) {
+            b->reset();
+        }
+    }
+
+    void blk_step() override {
+        for (const auto& b : blocks) {
+            b->step();
+        }
+    }
+
+    void update_inputs() override {}
+    void update_outputs() override {}
+
+private:
+    std::shared_ptr<const mtea::VariableManager> variable_manager;
+    std::vector<std::unique_ptr<mtea::BlockExecutionInterface>> blocks;
+};
 
 mtea::ExecutionState::ExecutionState(std::shared_ptr<BlockExecutionInterface> model, std::shared_ptr<VariableManager> variables,
-                                     const double dt)
-    : model{model}, variables{variables}, state{dt} {
+                                     std::shared_ptr<TunableParameters::Bindings> parameters, const double dt)
+    : model{model}, variables{variables}, parameters{parameters}, state{dt} {
     // Empty Constructor
 }
 
-void mtea::ExecutionState::init() { model->reset(); }
+void mtea::ExecutionState::init() {
+    parameters->apply_pending();
+    model->reset();
+}
 
 void mtea::ExecutionState::step() {
+    // Apply tunable parameter edits to the storage of this executor between steps, so that each step sees a consistent set of values
+    parameters->apply_pending();
+
     iterations += 1;
     model->step();
 }
 
 void mtea::ExecutionState::reset() {
+    parameters->apply_pending();
+
     iterations = 0;
     model->reset();
 }
@@ -37,14 +77,15 @@ std::shared_ptr<const mtea::VariableManager> mtea::ExecutionState::get_variable_
 std::vector<std::string> mtea::ExecutionState::get_variable_names() const {
     std::vector<std::string> names;
     for (const auto& k : named_variables | std::views::keys) {
-        names.push_back(k);
+        names.push_back(k.str());
     }
     std::ranges::sort(names);
     return names;
 }
 
 std::shared_ptr<const mtea::ModelValue> mtea::ExecutionState::get_variable_for_name(const std::string& n) const {
-    const auto it = named_variables.find(n);
+    const auto sym = SymbolTable::get_instance().find(n);
+    const auto it = sym.has_value() ? named_variables.find(*sym) : named_variables.end();
     if (it != named_variables.end()) {
         return it->second;
     } else {
@@ -78,11 +119,12 @@ std::shared_ptr<const mtea::ModelExecutionInterface> mtea::ExecutionState::get_m
 }
 
 void mtea::ExecutionState::add_name_to_variable(const std::string& name, std::shared_ptr<const ModelValue> variable) {
-    if (const auto it = named_variables.find(name); it != named_variables.end()) {
+    const Symbol sym(name);
+    if (const auto it = named_variables.find(sym); it != named_variables.end()) {
         throw mtea::ModelException(fmt::format("name '{}' already exists for variable", name));
     }
 
-    named_variables[name] = variable;
+    named_variables[sym] = variable;
 }
 
 mtea::ExecutionState mtea::ExecutionState::from_model(const std::shared_ptr<Model> model, const double dt) {
@@ -104,9 +146,58 @@ mtea::ExecutionState mtea::ExecutionState::from_model(const std::shared_ptr<Mode
     // Ensure that the block is updated
     model->update_block();
 
+    // Bind the tunable parameters of the blocks to storage owned by this executor
+    const auto parameters = std::make_shared<TunableParameters::Bindings>(model->get_manager().get_tunable_parameters());
+    const TunableParameters::BindScope scope(*parameters);
+
     // Construct and return the executor
-    auto exec_state =
-        mtea::ExecutionState(model->get_execution_interface(0, connections, *manager, BlockInterface::ModelInfo(dt)), manager, dt);
+    auto exec_state = mtea::ExecutionState(model->get_execution_interface(0, connections, *manager, BlockInterface::ModelInfo(dt)),
+                                           manager, parameters, dt);
 
     return exec_state;
 }
+
+mtea::ExecutionState mtea::ExecutionState::from_artifact(const ExecutionArtifact& artifact, const ModelManager& session) {
+    // Store every artifact signal in a single slab, identified by slot number
+    auto layout = std::make_shared<SignalLayout>();
+    for (size_t i = 0; i < artifact.signal_types.size(); ++i) {
+        layout->add_variable(VariableIdentifier{.block_id = i, .output_port_num = 0}, artifact.signal_types[i]);
+    }
+
+    const VariableManager signals(layout);
+    const auto get_signal = [&signals](const size_t slot) {
+        return signals.get_ptr(VariableIdentifier{.block_id = slot, .output_port_num = 0});
+    };
+
+    // Add each output variable to the manager
+    const auto manager = std::make_shared<VariableManager>();
+    for (size_t i = 0; i < artifact.output_slots.size(); ++i) {
+        manager->add_variable(VariableIdentifier{.block_id = 0, .output_port_num = i}, get_signal(artifact.output_slots[i]));
+    }
+
+    // Add the root model variables for naming interior values
+    const auto interior = std::make_shared<VariableManager>();
+    for (const auto& s : artifact.model_signals) {
+        interior->add_variable(s.id, get_signal(s.slot));
+    }
+
+    // Construct each leaf block directly from the libraries of the session
+
+    std::vector<std::unique_ptr<BlockExecutionInterface>> blocks;
+    for (const auto& b : artifact.blocks) {
+        std::vector<std::shared_ptr<const ModelValue>> inputs;
+        for (const auto slot : b.inputs) {
+            inputs.push_back(get_signal(slot));
+        }
+
+        std::vector<std::shared_ptr<ModelValue>> outputs;
+        for (const auto slot : b.outputs) {
+            outputs.push_back(get_signal(slot));
+        }
+
+        blocks.push_back(session.get_library(b.library)->create_executor(b, std::move(inputs), std::move(outputs)));
+    }
+
+    return ExecutionState(std::make_shared<ArtifactExecutor>(interior, std::move(blocks)), manager,
+                          std::make_shared<TunableParameters::Bindings>(session.get_tunable_parameters()), artifact.dt);
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "fixed_point.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+#include <fmt/format.h>
+
+#include "model_exception.hpp"
+
+namespace {
+
+int parse_int(const std::string_view s, const std::string_view full) {
+    int value = 0;
+    const auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (s.empty() || ec != std::errc{} || ptr != s.data() + s.size()) {
+        throw mtea::ModelException(fmt::format("invalid fixed-point type '{}'", full));
+    }
+    return value;
+}
+
+}
+
+mtea::FixedPointType::FixedPointType(const bool is_signed, const size_t word_length, const int fraction_length)
+    : _is_signed(is_signed), _word_length(word_length), _fraction_length(fraction_length) {
+    const auto max_word = is_signed ? MAX_WORD_LENGTH : MAX_UNSIGNED_WORD_LENGTH;
+    if (word_length < 2 || word_length > max_word) {
+        throw ModelException(fmt::format("fixed-point word length {} must be between 2 and {}", word_length, max_word));
+    } else if (std::abs(fraction_length) > 62) {
+        throw ModelException(fmt::format("fixed-point fraction length {} is out of range", fraction_length));
+    }
+}
+
+int64_t mtea::FixedPointType::get_min_raw() const { return _is_signed ? -(int64_t{1} << (_word_length - 1)) : 0; }
+
+int64_t mtea::FixedPointType::get_max_raw() const {
+    return _is_signed ? (int64_t{1} << (_word_length - 1)) - 1 : (int64_t{1} << _word_length) - 1;
+}
+
+double mtea::FixedPointType::get_resolution() const { return std::ldexp(1.0, -_fraction_length); }
+
+double mtea::FixedPointType::get_min() const { return to_double(get_min_raw()); }
+
+double mtea::FixedPointType::get_max() const { return to_double(get_max_raw()); }
+
+double mtea::FixedPointType::to_double(const int64_t raw) const { return std::ldexp(static_cast<double>(raw), -_fraction_length); }
+
+std::string mtea::FixedPointType::to_string() const {
+    const auto base = fmt::format("{}fix{}", _is_signed ? 's' : 'u', _word_length);
+    if (_fraction_length > 0) {
+        return fmt::format("{}_En{}", base, _fraction_length);
+    } else if (_fraction_length < 0) {
+        return fmt::format("{}_E{}", base, -_fraction_length);
+    } else {
+        return base;
+    }
+}
+
+mtea::FixedPointType mtea::FixedPointType::from_string(const std::string_view s) {
+    if (s.size() < 5 || (!s.starts_with("sfix") && !s.starts_with("ufix"))) {
+        throw ModelException(fmt::format("invalid fixed-point type '{}'", s));
+    }
+
+    const bool is_signed = s.front() == 's';
+    const auto rest = s.substr(4);
+    const auto sep = rest.find('_');
+
+    const auto word_length = parse_int(rest.substr(0, sep), s);
+
+    int fraction_length = 0;
+    if (sep != std::string_view::npos) {
+        const auto scale = rest.substr(sep + 1);
+        if (scale.starts_with("En")) {
+            fraction_length = parse_int(scale.substr(2), s);
+        } else if (scale.starts_with("E")) {
+            fraction_length = -parse_int(scale.substr(1), s);
+        } else {
+            throw ModelException(fmt::format("invalid fixed-point type '{}'", s));
+        }
+    }
+
+    if (word_length < 0) {
+        throw ModelException(fmt::format("invalid fixed-point type '{}'", s));
+    }
+
+    return FixedPointType(is_signed, static_cast<size_t>(word_length), fraction_length);
+}
+
+mtea::FixedPointType mtea::FixedPointType::propose(const double min, const double max, const size_t word_length) {
+    if (std::isnan(min) || std::isnan(max) || min > max) {
+        throw ModelException(fmt::format("invalid range [{}, {}] for a fixed-point scaling", min, max));
+    }
+
+    const bool is_signed = min < 0.0;
+    const int magnitude_bits = static_cast<int>(word_length) - (is_signed ? 1 : 0);
+
+    if (min == 0.0 && max == 0.0) {
+        return FixedPointType(is_signed, word_length, magnitude_bits);
+    }
+
+    // Start from the binary point that would hold the largest magnitude exactly and move to coarser scalings until nothing saturates
+    const double largest = std::max(std::abs(min), std::abs(max));
+    int fraction = std::clamp(magnitude_bits - static_cast<int>(std::ceil(std::log2(largest))), -62, 62);
+
+    for (; fraction > -62; --fraction) {
+        const FixedPointType candidate(is_signed, word_length, fraction);
+        const double scaled_min = std::floor(std::ldexp(min, fraction) + 0.5);
+        const double scaled_max = std::floor(std::ldexp(max, fraction) + 0.5);
+        if (scaled_min >= static_cast<double>(candidate.get_min_raw()) && scaled_max <= static_cast<double>(candidate.get_max_raw())) {
+            return candidate;
+        }
+    }
+
+    throw ModelException(fmt::format("range [{}, {}] cannot be held by a {}-bit fixed-point word", min, max, word_length));
+}
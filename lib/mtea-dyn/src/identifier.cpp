@@ -7,23 +7,25 @@
 #include <fmt/format.h>
 
 void mtea::to_json(nlohmann::json& j, const Identifier& i) {
-    j["name"] = i._value;
+    j["name"] = i._value.str();
 }
 
 void mtea::from_json(const nlohmann::json& j, Identifier& i) {
-    j.at("name").get_to(i._value);
+    i._value = Symbol(j.at("name").get<std::string>());
 }
 
 mtea::Identifier::Identifier(const std::string_view s) { set(s); }
 
-const std::string& mtea::Identifier::get() const { return _value; }
+const std::string& mtea::Identifier::get() const { return _value.str(); }
+
+const mtea::Symbol& mtea::Identifier::get_symbol() const { return _value; }
 
 void mtea::Identifier::set(const std::string_view s) {
     if (!is_valid_identifier(s)) {
         throw ModelException(fmt::format("'{}' is not a valid identifier", s));
     }
 
-    _value = s;
+    _value = Symbol(s);
 }
 
 bool mtea::Identifier::is_valid_identifier(const std::string_view s) {
@@ -36,4 +38,4 @@ bool mtea::Identifier::is_valid_identifier(const std::string_view s) {
     return !s.empty() && std::isalpha(s[0]);
 }
 
-size_t mtea::Identifier::Hasher::operator()(const Identifier& other) const { return std::hash<std::string>{}(other.get()); }
+size_t mtea::Identifier::Hasher::operator()(const Identifier& other) const { return other._value.hash(); }
@@ -2,6 +2,10 @@
 
 #include "library.hpp"
 
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
 std::unique_ptr<mtea::BlockInterface> mtea::LibraryBase::try_create_block(std::string_view name) const {
     if (has_block(name)) {
         return create_block(name);
@@ -9,3 +13,9 @@ std::unique_ptr<mtea::BlockInterface> mtea::LibraryBase::try_create_block(std::s
         return nullptr;
     }
 }
+
+std::unique_ptr<mtea::BlockExecutionInterface> mtea::LibraryBase::create_executor(const ExecutionArtifact::Block& block,
+                                                                                  std::vector<std::shared_ptr<const ModelValue>>&&,
+                                                                                  std::vector<std::shared_ptr<ModelValue>>&&) const {
+    throw ModelException(fmt::format("library '{}' cannot create executor for artifact block '{}'", get_library_name(), block.name));
+}
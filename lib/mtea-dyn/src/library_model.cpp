@@ -3,10 +3,18 @@
 #include "library_model.hpp"
 
 #include "model_exception.hpp"
+#include "model_loader.hpp"
+#include "model_manager.hpp"
 #include "identifier.hpp"
 
 #include <fmt/format.h>
 
+mtea::ModelLibrary::ModelLibrary(ModelManager& manager) : manager(manager) {
+    // Empty Constructor
+}
+
+mtea::ModelManager& mtea::ModelLibrary::get_manager() const { return manager; }
+
 const std::string mtea::ModelLibrary::get_library_name() const { return library_name; }
 
 std::vector<std::string> mtea::ModelLibrary::get_block_names() const {
@@ -51,16 +59,18 @@ std::shared_ptr<mtea::Model> mtea::ModelLibrary::get_model(const std::string_vie
 }
 
 std::shared_ptr<mtea::Model> mtea::ModelLibrary::create_new_model() {
-    const auto mdl = std::make_shared<mtea::Model>();
+    const auto mdl = std::make_shared<mtea::Model>(manager);
     return add_model(mdl);
 }
 
 std::shared_ptr<mtea::Model> mtea::ModelLibrary::add_model(std::shared_ptr<Model> model) {
     if (try_get_model(model->get_name()) != nullptr || find_model(model.get()) != models.end()) {
         throw ModelException(fmt::format("cannot add model - model with name '{}' already exists", model->get_name()));
+    } else if (&model->get_manager() != &manager) {
+        throw ModelException(fmt::format("cannot add model '{}' - model belongs to a different session", model->get_name()));
     }
 
-    models.insert({model->get_name(), model});
+    models.insert({Symbol(model->get_name()), model});
     return model;
 }
 
@@ -84,7 +94,7 @@ void mtea::ModelLibrary::save_model(const Model* model, const std::filesystem::p
     }
 
     if (const auto it = find_model(model); it != models.end()) {
-        const auto new_it = models.insert({new_name.get(), it->second});
+        const auto new_it = models.insert({new_name.get_symbol(), it->second});
 
         new_it.first->second->set_filename(path);
         new_it.first->second->save_model();
@@ -106,9 +116,7 @@ std::shared_ptr<mtea::Model> mtea::ModelLibrary::load_model(const std::filesyste
         throw ModelException(fmt::format("library already exists a model with the name '{}'", new_name.get()));
     }
 
-    const auto mdl = Model::load_model(path);
-    models.insert({new_name.get(), mdl});
-    return mdl;
+    return ModelLoader(*this).load(path);
 }
 
 void mtea::ModelLibrary::close_model(const mtea::Model* model) {
@@ -129,7 +137,7 @@ void mtea::ModelLibrary::close_model(const mtea::Model* model) {
 }
 
 void mtea::ModelLibrary::close_unused_models() {
-    std::unordered_map<std::string, std::weak_ptr<mtea::Model>> weak_models;
+    std::unordered_map<Symbol, std::weak_ptr<mtea::Model>, Symbol::Hasher> weak_models;
     for (const auto& [n, m] : models) {
         weak_models.insert({n, m});
     }
@@ -145,7 +153,12 @@ void mtea::ModelLibrary::close_unused_models() {
 }
 
 std::shared_ptr<mtea::Model> mtea::ModelLibrary::try_get_model(const std::string_view name) const {
-    const auto it = models.find(std::string(name));
+    const auto sym = SymbolTable::get_instance().find(name);
+    if (!sym.has_value()) {
+        return nullptr;
+    }
+
+    const auto it = models.find(*sym);
     if (it == models.end()) {
         return nullptr;
     }
@@ -158,6 +171,21 @@ std::shared_ptr<mtea::Model> mtea::ModelLibrary::try_get_model(const std::string
     }
 }
 
+void mtea::ModelLibrary::set_workspace_index(std::shared_ptr<WorkspaceIndex> index) { workspace_index = std::move(index); }
+
+std::shared_ptr<mtea::WorkspaceIndex> mtea::ModelLibrary::get_workspace_index() const { return workspace_index; }
+
+std::filesystem::path mtea::ModelLibrary::find_submodel_path(const std::filesystem::path& parent, const std::string_view name) const {
+    // Resolve submodels within the workspace from the index, only probing the filesystem for files outside of it
+    if (workspace_index != nullptr) {
+        if (const auto pth = workspace_index->find_submodel(parent, name); pth.has_value()) {
+            return *pth;
+        }
+    }
+
+    return ModelLoader::find_submodel_path(parent, name);
+}
+
 mtea::ModelLibrary::model_map_t::iterator mtea::ModelLibrary::find_model(const Model* mdl) {
     return std::find_if(models.begin(), models.end(), [mdl](const model_map_t::value_type& m) { return m.second.get() == mdl; });
 }
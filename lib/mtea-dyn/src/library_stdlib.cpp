@@ -9,10 +9,106 @@
 
 #include "mtea_creation.hpp"
 
+#include <mutex>
 #include <ranges>
+#include <unordered_map>
+
+struct StdlibBlockSignature {
+    explicit StdlibBlockSignature(const mtea::block_interface& block)
+        : current_type{block.get_current_type()}, outputs_delayed{block.outputs_are_delayed()} {
+        for (size_t i = 0; i < block.get_input_num(); ++i) {
+            input_types.push_back(block.get_input_type(i));
+            input_settable.push_back(block.get_input_type_settable(i));
+        }
+
+        for (size_t i = 0; i < block.get_output_num(); ++i) {
+            output_types.push_back(block.get_output_type(i));
+        }
+    }
+
+    bool same_interface(const StdlibBlockSignature& other) const {
+        return current_type == other.current_type && input_types.size() == other.input_types.size() &&
+               output_types.size() == other.output_types.size();
+    }
+
+    mtea::DataType current_type;
+    bool outputs_delayed;
+    std::vector<mtea::DataType> input_types;
+    std::vector<bool> input_settable;
+    std::vector<mtea::DataType> output_types;
+};
+
+struct StdlibSignatureKey {
+    std::string name;
+    std::vector<mtea::DataType> dtypes;
+    mtea::BlockInformation::ConstructorOptions constructor;
+    uint32_t size;
+
+    bool operator==(const StdlibSignatureKey&) const = default;
+};
+
+struct StdlibSignatureKeyHash {
+    size_t operator()(const StdlibSignatureKey& k) const {
+        size_t h = std::hash<std::string>{}(k.name);
+        const auto combine = [&h](const size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+
+        for (const auto dt : k.dtypes) {
+            combine(static_cast<size_t>(dt));
+        }
+
+        combine(static_cast<size_t>(k.constructor));
+        combine(k.size);
+
+        return h;
+    }
+};
+
+class StdlibSignatureTable {
+public:
+    static StdlibSignatureTable& get_instance() {
+        static StdlibSignatureTable table;
+        return table;
+    }
+
+    template <typename F> std::shared_ptr<const StdlibBlockSignature> get_or_create(const StdlibSignatureKey& key, F&& make_block) {
+        {
+            std::lock_guard lock(mutex);
+            if (const auto it = signatures.find(key); it != signatures.end()) {
+                return it->second;
+            }
+        }
+
+        // Construct outside of the lock, as creating the block may be expensive or throw
+        const auto block = make_block();
+        auto sig = std::make_shared<const StdlibBlockSignature>(*block);
+
+        std::lock_guard lock(mutex);
+        return signatures.try_emplace(key, std::move(sig)).first->second;
+    }
+
+private:
+    StdlibSignatureTable() = default;
+
+    std::mutex mutex;
+    std::unordered_map<StdlibSignatureKey, std::shared_ptr<const StdlibBlockSignature>, StdlibSignatureKeyHash> signatures;
+};
+
+// Provides values for the pointer arguments of blocks that are only constructed to inspect their interface
+static const mtea::ModelValue* get_placeholder_value(const mtea::DataType dtype) {
+    static std::mutex mutex;
+    static std::unordered_map<mtea::DataType, std::unique_ptr<mtea::ModelValue>> values;
+
+    std::lock_guard lock(mutex);
+    auto& val = values[dtype];
+    if (!val) {
+        val = mtea::ModelValue::make_default(dtype);
+    }
+    return val.get();
+}
 
 struct StdlibBlockConstructor {
-    StdlibBlockConstructor(const mtea::BlockInformation& info) : info{info} {
+    StdlibBlockConstructor(const mtea::BlockInformation& info, std::shared_ptr<mtea::TunableParameters> parameters)
+        : info{info}, parameters{std::move(parameters)} {
         const auto init_dt = info.get_default_data_type();
 
         if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::SIZE) {
@@ -32,26 +128,45 @@ struct StdlibBlockConstructor {
     }
 
     mtea::BlockInformation info;
+    std::shared_ptr<mtea::TunableParameters> parameters;
 
     std::shared_ptr<mtea::ParameterValue> param_size{};
     std::shared_ptr<mtea::ParameterValue> param_value{};
     std::shared_ptr<mtea::ParameterDataType> param_dt{};
     std::shared_ptr<mtea::ParameterIdentifier> param_ident{};
 
-    std::unique_ptr<mtea::block_interface> create_block(mtea::DataType dtype, double dt) const {
-        // Create the argument type
-        std::unique_ptr<const mtea::Argument> arg = nullptr;
+    std::vector<mtea::DataType> get_data_types(mtea::DataType dtype) const {
+        std::vector<mtea::DataType> dtypes{dtype};
+
+        if (info.uses_input_as_type && param_dt) {
+            dtypes.push_back(param_dt->get_type());
+        }
 
+        return dtypes;
+    }
+
+    std::shared_ptr<const StdlibBlockSignature> get_signature(mtea::DataType dtype) const {
+        // Only the size argument can change the port layout, so other argument values are excluded from the key
+        uint32_t size_val = 0;
         if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::SIZE) {
-            const uint32_t size_val = mtea::ModelValue::get_inner_value<mtea::DataType::U32>(param_size->get_value());
-            arg = std::make_unique<mtea::ArgumentBox<mtea::DataType::U32>>(size_val);
+            size_val = mtea::ModelValue::get_inner_value<mtea::DataType::U32>(param_size->get_value());
         } else if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::VALUE) {
             param_value->convert_type(param_dt->get_type());
-            arg = param_value->get_value()->to_argument();
-        } else if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::VALUE_PTR) {
-            const auto varname = param_ident->get_value().get();
-            auto ptr_val = mtea::ModelValue::make_default(mtea::DataType::F64).release();
-            arg = ptr_val->to_argument_ptr();
+        }
+
+        const StdlibSignatureKey key{
+            .name = info.name, .dtypes = get_data_types(dtype), .constructor = info.constructor_dynamic, .size = size_val};
+
+        return StdlibSignatureTable::get_instance().get_or_create(key, [this, dtype]() { return create_block(dtype, 0.0, false); });
+    }
+
+    std::unique_ptr<mtea::ModelValue> create_argument(mtea::DataType dtype, double dt) const {
+        // Create the argument value for constructors that take their argument by value
+        if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::SIZE) {
+            return param_size->get_value()->clone();
+        } else if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::VALUE) {
+            param_value->convert_type(param_dt->get_type());
+            return param_value->get_value()->clone();
         } else if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::TIMESTEP) {
             auto mv = mtea::ModelValue::make_default(dtype);
             if (const auto ptr = dynamic_cast<mtea::ModelValueBox<mtea::DataType::F64>*>(mv.get())) {
@@ -62,19 +177,30 @@ struct StdlibBlockConstructor {
                 throw mtea::ModelException("unable to set timestep for type");
             }
 
-            arg = mv->to_argument();
+            return mv;
+        } else {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<mtea::block_interface> create_block(mtea::DataType dtype, double dt, const bool bind_tunable = true) const {
+        // Create the argument type
+        std::unique_ptr<const mtea::Argument> arg = nullptr;
+
+        if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::VALUE_PTR && bind_tunable) {
+            // Pointer arguments read the tunable storage of the executor being built, so that values may change without a rebuild
+            const auto storage = parameters->get_storage(param_ident->get_value(), dtype);
+            arg = storage->to_argument_ptr();
+        } else if (info.constructor_dynamic == mtea::BlockInformation::ConstructorOptions::VALUE_PTR) {
+            arg = get_placeholder_value(dtype)->to_argument_ptr();
+        } else if (const auto arg_value = create_argument(dtype, dt)) {
+            arg = arg_value->to_argument();
         }
 
         // Create the new block
         std::unique_ptr<mtea::block_interface> new_block = nullptr;
         try {
-            std::vector<mtea::DataType> dtypes{dtype};
-
-            if (info.uses_input_as_type && param_dt) {
-                dtypes.push_back(param_dt->get_type());
-            }
-
-            return mtea::create_block(info, dtypes, arg.get());
+            return mtea::create_block(info, get_data_types(dtype), arg.get());
         } catch (const mtea::block_error& err) {
             throw mtea::ModelException(err);
         }
@@ -164,16 +290,19 @@ public:
 
     std::optional<std::string> get_function_name(mtea::codegen::BlockFunction ft) const override { return {}; }
 
-    std::vector<std::string> constructor_arguments() const override {
+    std::vector<mtea::codegen::ConstructorArgument> constructor_arguments() const override {
         if (arg) {
-            return { fmt::format("{}{{ {} }}", mtea::codegen::get_datatype_name(arg->data_type()), arg->to_string()) };
+            return {mtea::codegen::ConstructorArgument{.type_name = mtea::codegen::get_datatype_name(arg->data_type()),
+                                                       .value = arg->to_string()}};
         } else {
             return {};
         }
     }
 
 protected:
-    std::vector<std::string> write_code(mtea::codegen::CodeSection section) const override { return {}; }
+    std::vector<std::string> write_code(mtea::codegen::CodeSection, const mtea::codegen::CodegenOptions&) const override {
+        return {};
+    }
 
 private:
     std::unique_ptr<mtea::block_interface> block;
@@ -183,8 +312,8 @@ private:
 class StdlibBlockCompiled final : public mtea::CompiledBlockInterface {
 public:
     StdlibBlockCompiled(std::function<std::unique_ptr<mtea::block_interface>()> make_new_interface, size_t current_id,
-                        std::unique_ptr<const mtea::ModelValue>&& arg)
-        : make_new_interface(make_new_interface), current_id(current_id), arg(std::move(arg)) {}
+                        std::unique_ptr<const mtea::ModelValue>&& arg, std::optional<mtea::ExecutionArtifact::Block>&& artifact_block)
+        : make_new_interface(make_new_interface), current_id(current_id), arg(std::move(arg)), artifact_block(std::move(artifact_block)) {}
 
     std::unique_ptr<mtea::BlockExecutionInterface> get_execution_interface(const mtea::ConnectionManager& connections,
                                                                            const mtea::VariableManager& manager) const override {
@@ -210,21 +339,45 @@ public:
         return std::make_unique<StdlibBlockComponent>(make_new_interface(), arg);
     }
 
+    void add_to_artifact(const mtea::ConnectionManager& connections, const mtea::ExecutionArtifact::SlotMap& slots,
+                         mtea::ExecutionArtifact& artifact) const override {
+        if (!artifact_block.has_value()) {
+            throw mtea::ModelException(fmt::format("block {} cannot be stored in an execution artifact", current_id));
+        }
+
+        // Create the block to determine the port counts
+        const auto block = make_new_interface();
+        auto blk = *artifact_block;
+
+        for (size_t i = 0; i < block->get_input_num(); ++i) {
+            const auto c = connections.get_connection_to(current_id, i);
+            blk.inputs.push_back(mtea::ExecutionArtifact::get_slot(
+                slots, mtea::VariableIdentifier{.block_id = c->get_from_id(), .output_port_num = c->get_from_port()}));
+        }
+
+        for (size_t i = 0; i < block->get_output_num(); ++i) {
+            blk.outputs.push_back(mtea::ExecutionArtifact::get_slot(slots, mtea::VariableIdentifier{.block_id = current_id, .output_port_num = i}));
+        }
+
+        artifact.blocks.push_back(std::move(blk));
+    }
+
 private:
     std::function<std::unique_ptr<mtea::block_interface>()> make_new_interface;
     size_t current_id;
     std::shared_ptr<const mtea::ModelValue> arg;
+    std::optional<mtea::ExecutionArtifact::Block> artifact_block;
 };
 
 class StdlibBlock final : public mtea::BlockInterface {
 public:
-    StdlibBlock(const mtea::BlockInformation& info, std::string_view library)
-        : mtea::BlockInterface(library), block_constructor{info} {
+    StdlibBlock(const mtea::BlockInformation& info, std::string_view library, std::shared_ptr<mtea::TunableParameters> parameters)
+        : mtea::BlockInterface(library), block_constructor{info, std::move(parameters)} {
         const auto init_dt = block_constructor.info.get_default_data_type();
 
         update_block(init_dt);
 
-        if (!block) {
+        if (!signature) {
             throw mtea::ModelException(fmt::format("unable to generate block for {}", info.name));
         }
     }
@@ -248,12 +401,16 @@ public:
             params.push_back(block_constructor.param_value);
         }
 
+        if (block_constructor.param_ident) {
+            params.push_back(block_constructor.param_ident);
+        }
+
         return params;
     }
 
     mtea::DataType selected_type() const {
         if (block_constructor.info.uses_input_as_type) {
-            return block->get_current_type();
+            return signature->current_type;
         } else if (block_constructor.param_dt) {
             return block_constructor.param_dt->get_type();
         } else {
@@ -264,25 +421,19 @@ public:
     bool update_block() override { return update_block(selected_type()); }
 
     bool update_block(mtea::DataType new_dtype) {
-        // Create the new block
-        std::unique_ptr<mtea::block_interface> new_block = nullptr;
-        try {
-            new_block = block_constructor.create_block(new_dtype, 0.0);
-        } catch (const mtea::block_error& err) {
-            return false;
-        }
+        // Look up the block signature, only constructing a block for previously unseen configurations, where errors from
+        // the block constructor have already been converted to model exceptions
+        std::shared_ptr<const StdlibBlockSignature> new_signature = block_constructor.get_signature(new_dtype);
 
         // Return whether any interface parameters have changed
-        const bool interface_changed = block == nullptr || block->get_input_num() != new_block->get_input_num() ||
-                                       block->get_output_num() != block->get_output_num() ||
-                                       block->get_current_type() != new_block->get_current_type() ||
-                                       input_types.size() != new_block->get_input_num();
+        const bool interface_changed = signature == nullptr || !signature->same_interface(*new_signature) ||
+                                       input_types.size() != new_signature->input_types.size();
 
         // Resize the input types as needed
-        input_types.resize(new_block->get_input_num(), mtea::DataType::NONE);
+        input_types.resize(new_signature->input_types.size(), mtea::DataType::NONE);
 
-        // Update the block and return
-        block = std::move(new_block);
+        // Update the signature and return
+        signature = std::move(new_signature);
         return interface_changed;
     }
 
@@ -296,19 +447,19 @@ public:
     }
 
     std::unique_ptr<const mtea::BlockError> has_error() const override {
-        if (block_constructor.param_dt != nullptr && block_constructor.param_dt->get_type() != block->get_current_type() && !block_constructor.info.uses_input_as_type) {
+        if (block_constructor.param_dt != nullptr && block_constructor.param_dt->get_type() != signature->current_type && !block_constructor.info.uses_input_as_type) {
             return make_error(fmt::format("unsupported type provided - {} != {}",
                                           get_meta_type_name(block_constructor.param_dt->get_type()),
-                                          get_meta_type_name(block->get_current_type())));
+                                          get_meta_type_name(signature->current_type)));
         }
 
-        if (input_types.size() != block->get_input_num()) {
+        if (input_types.size() != signature->input_types.size()) {
             return make_error("input size doesn't match inner block input size");
         }
 
         for (size_t i = 0; i < get_num_inputs(); ++i) {
             const auto current = input_types[i];
-            const auto expected = block->get_input_type(i);
+            const auto expected = signature->input_types[i];
 
             if (current != expected) {
                 return make_error(fmt::format("port {} with type {} doesn't match expected type {}", i, get_meta_type_name(current),
@@ -321,15 +472,15 @@ public:
 
     size_t get_num_inputs() const override { return input_types.size(); }
 
-    size_t get_num_outputs() const override { return block->get_output_num(); }
+    size_t get_num_outputs() const override { return signature->output_types.size(); }
 
-    bool outputs_are_delayed() const override { return block->outputs_are_delayed(); }
+    bool outputs_are_delayed() const override { return signature->outputs_delayed; }
 
     void set_input_type(const size_t port, const mtea::DataType type) override {
         if (port < input_types.size()) {
             if (input_types[port] != type) {
-                if (block_constructor.param_dt == nullptr && block->get_input_type_settable(port) &&
-                    block_constructor.info.type_supported(type) && block->get_current_type() != type) {
+                if (block_constructor.param_dt == nullptr && signature->input_settable[port] &&
+                    block_constructor.info.type_supported(type) && signature->current_type != type) {
                     update_block(type);
                 }
 
@@ -340,7 +491,7 @@ public:
         }
     }
 
-    mtea::DataType get_output_type(const size_t port) const override { return block->get_output_type(port); }
+    mtea::DataType get_output_type(const size_t port) const override { return signature->output_types.at(port); }
 
     std::unique_ptr<mtea::CompiledBlockInterface> get_compiled(const ModelInfo& s) const override {
         const auto dt = s.get_dt();
@@ -367,22 +518,45 @@ public:
             throw mtea::ModelException("unknown code generation constructor option provided");
         }
 
+        // Pointer arguments refer to runtime storage, and so cannot be stored in an execution artifact
+        std::optional<mtea::ExecutionArtifact::Block> artifact_block{};
+        if (c.info.constructor_dynamic != mtea::BlockInformation::ConstructorOptions::VALUE_PTR) {
+            artifact_block.emplace();
+            artifact_block->library = get_library();
+            artifact_block->name = c.info.name;
+            artifact_block->data_types = c.get_data_types(dtype);
+            artifact_block->argument = c.create_argument(dtype, dt);
+        }
+
         return std::make_unique<StdlibBlockCompiled>([c, dt, dtype]() { return c.create_block(dtype, dt); }, get_id(),
-                                                     std::move(constructor_arg));
+                                                     std::move(constructor_arg), std::move(artifact_block));
     }
 
 private:
     const StdlibBlockConstructor block_constructor;
-    std::unique_ptr<mtea::block_interface> block{nullptr};
+    std::shared_ptr<const StdlibBlockSignature> signature{nullptr};
     std::vector<mtea::DataType> input_types;
 };
 
-mtea::blocks::StandardLibrary::StandardLibrary() {
+mtea::blocks::StandardLibrary::StandardLibrary(std::shared_ptr<TunableParameters> parameters) : parameters(std::move(parameters)) {
     block_map = {{"input", [this]() { return std::make_unique<InputPort>(get_library_name()); }},
                  {"output", [this]() { return std::make_unique<OutputPort>(get_library_name()); }}};
 
     for (const auto& blk : mtea::get_available_blocks()) {
-        block_map[blk.name] = [this, blk]() { return std::make_unique<StdlibBlock>(blk, get_library_name()); };
+        block_map[blk.name] = [this, blk]() { return std::make_unique<StdlibBlock>(blk, get_library_name(), this->parameters); };
+        executor_map[blk.name] = [blk](const ExecutionArtifact::Block& block, std::vector<std::shared_ptr<const ModelValue>>&& inputs,
+                                       std::vector<std::shared_ptr<ModelValue>>&& outputs) {
+            const auto arg = block.argument ? block.argument->to_argument() : nullptr;
+
+            std::unique_ptr<mtea::block_interface> new_block = nullptr;
+            try {
+                new_block = mtea::create_block(blk, block.data_types, arg.get());
+            } catch (const mtea::block_error& err) {
+                throw ModelException(err);
+            }
+
+            return std::make_unique<StdlibBlockExecutor>(std::move(new_block), std::move(inputs), std::move(outputs));
+        };
     }
 }
 
@@ -406,3 +580,13 @@ std::unique_ptr<mtea::BlockInterface> mtea::blocks::StandardLibrary::create_bloc
         throw ModelException("unknown block type provided to library");
     }
 }
+
+std::unique_ptr<mtea::BlockExecutionInterface> mtea::blocks::StandardLibrary::create_executor(
+    const ExecutionArtifact::Block& block, std::vector<std::shared_ptr<const ModelValue>>&& inputs,
+    std::vector<std::shared_ptr<ModelValue>>&& outputs) const {
+    if (auto it = executor_map.find(block.name); it != executor_map.end()) {
+        return it->second(block, std::move(inputs), std::move(outputs));
+    } else {
+        throw ModelException(fmt::format("unknown block type '{}' provided to library for execution", block.name));
+    }
+}
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "mapped_data_dictionary.hpp"
+
+#include "atomic_file.hpp"
+#include "data_dictionary.hpp"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+
+const std::string mtea::MappedDataDictionary::FILE_EXTENSION = ".tmdd";
+
+/* ==================== FILE LAYOUT ==================== */
+
+namespace {
+
+constexpr std::array<char, 4> FILE_MAGIC = {'T', 'M', 'D', 'D'};
+constexpr uint32_t ENDIAN_TAG = 0x01020304;
+constexpr uint64_t SECTION_ALIGNMENT = 8;
+
+struct TableRef {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct DictionaryHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t endian_tag;
+    uint32_t padding;
+    TableRef entries;
+    TableRef string_data;
+    TableRef payload;
+};
+
+// Entries are sorted by name, so that lookups are a binary search over the mapped table
+struct EntryRecord {
+    uint64_t name_offset; // Relative to the start of the string data section
+    uint64_t name_size;
+    uint64_t cols;
+    uint64_t rows;
+    uint64_t data_offset; // Relative to the start of the payload section
+    uint8_t dtype;
+    uint8_t is_array;
+    std::array<uint8_t, 6> padding;
+};
+
+static_assert(std::is_trivially_copyable_v<DictionaryHeader> && std::is_trivially_copyable_v<EntryRecord>);
+
+struct PendingEntry {
+    mtea::DataType dtype;
+    bool is_array;
+    uint64_t cols;
+    uint64_t rows;
+    std::vector<char> data;
+};
+
+uint64_t align_size(const uint64_t size) { return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT; }
+
+void append_raw(std::vector<char>& data, const mtea::ModelValue* value) {
+    std::array<char, mtea::ModelValue::RAW_VALUE_SIZE> raw;
+    mtea::ModelValue::to_raw(value, raw.data());
+    data.insert(data.end(), raw.begin(), raw.begin() + mtea::ModelValue::raw_size(value->data_type()));
+}
+
+std::span<const char> get_section(const std::span<const char> data, const TableRef& table, const uint64_t record_size) {
+    if (table.offset > data.size() || table.count > (data.size() - table.offset) / record_size) {
+        throw mtea::ModelException("binary dictionary table extends past the end of the file");
+    }
+
+    return data.subspan(table.offset, table.count * record_size);
+}
+
+EntryRecord get_record(const std::span<const char> entries, const size_t i) {
+    if (i >= entries.size() / sizeof(EntryRecord)) {
+        throw mtea::ModelException("binary dictionary entry index out of range");
+    }
+
+    EntryRecord rec;
+    std::memcpy(&rec, entries.data() + i * sizeof(EntryRecord), sizeof(rec));
+    return rec;
+}
+
+}
+
+/* ==================== ENTRY ==================== */
+
+std::unique_ptr<mtea::ModelValue> mtea::MappedDataDictionary::Entry::to_value(const size_t i) const {
+    if (i >= size()) {
+        throw ModelException("dictionary entry index out of range");
+    }
+
+    std::array<char, ModelValue::RAW_VALUE_SIZE> raw{};
+    const auto elem_size = ModelValue::raw_size(data_type);
+    std::memcpy(raw.data(), data.data() + i * elem_size, elem_size);
+    return ModelValue::from_raw(raw.data(), data_type);
+}
+
+std::unique_ptr<mtea::ValueArray> mtea::MappedDataDictionary::Entry::to_array() const {
+    std::vector<std::unique_ptr<const ModelValue>> values;
+    values.reserve(size());
+
+    for (size_t i = 0; i < size(); ++i) {
+        values.push_back(to_value(i));
+    }
+
+    return ValueArray::create_with_type(cols, rows, values, data_type);
+}
+
+/* ==================== READER ==================== */
+
+mtea::MappedDataDictionary::MappedDataDictionary(const std::filesystem::path& path) : path(path), file(path) {
+    const auto data = file.get_data();
+    if (data.size() < sizeof(DictionaryHeader)) {
+        throw ModelException(fmt::format("binary dictionary '{}' is too small to contain a header", path.string()));
+    }
+
+    DictionaryHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != FILE_MAGIC) {
+        throw ModelException(fmt::format("binary dictionary '{}' has an invalid file signature", path.string()));
+    } else if (header.endian_tag != ENDIAN_TAG) {
+        throw ModelException(fmt::format("binary dictionary '{}' was written with a different byte order", path.string()));
+    } else if (header.version != FORMAT_VERSION) {
+        throw ModelException(fmt::format("unsupported binary dictionary version {}", header.version));
+    }
+
+    // Only the section bounds are checked up front, with each entry checked as it is read
+    entries = get_section(data, header.entries, sizeof(EntryRecord));
+    string_data = get_section(data, header.string_data, 1);
+    payload = get_section(data, header.payload, 1);
+}
+
+const std::filesystem::path& mtea::MappedDataDictionary::get_path() const { return path; }
+
+size_t mtea::MappedDataDictionary::size() const { return entries.size() / sizeof(EntryRecord); }
+
+mtea::MappedDataDictionary::Entry mtea::MappedDataDictionary::get_entry(const size_t i) const {
+    const auto rec = get_record(entries, i);
+    const auto dtype = static_cast<DataType>(rec.dtype);
+    const auto elem_size = ModelValue::raw_size(dtype);
+
+    if (rec.rows != 0 && rec.cols > std::numeric_limits<uint64_t>::max() / rec.rows) {
+        throw ModelException("binary dictionary entry size out of range");
+    }
+
+    const auto count = rec.cols * rec.rows;
+    if (elem_size != 0 && count > std::numeric_limits<uint64_t>::max() / elem_size) {
+        throw ModelException("binary dictionary entry size out of range");
+    } else if (rec.data_offset > payload.size() || count * elem_size > payload.size() - rec.data_offset) {
+        throw ModelException("binary dictionary entry extends past the end of the payload");
+    }
+
+    return Entry{
+        .name = get_name(i),
+        .data_type = dtype,
+        .is_array = rec.is_array != 0,
+        .cols = static_cast<size_t>(rec.cols),
+        .rows = static_cast<size_t>(rec.rows),
+        .data = payload.subspan(rec.data_offset, count * elem_size),
+    };
+}
+
+std::optional<mtea::MappedDataDictionary::Entry> mtea::MappedDataDictionary::find(const std::string_view name) const {
+    size_t lo = 0;
+    size_t hi = size();
+
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        if (get_name(mid) < name) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < size() && get_name(lo) == name) {
+        return get_entry(lo);
+    } else {
+        return std::nullopt;
+    }
+}
+
+std::string_view mtea::MappedDataDictionary::get_name(const size_t i) const {
+    const auto rec = get_record(entries, i);
+    if (rec.name_offset > string_data.size() || rec.name_size > string_data.size() - rec.name_offset) {
+        throw ModelException("binary dictionary name out of range");
+    }
+
+    return {string_data.data() + rec.name_offset, rec.name_size};
+}
+
+bool mtea::MappedDataDictionary::is_binary_path(const std::filesystem::path& path) { return path.extension() == FILE_EXTENSION; }
+
+/* ==================== WRITER ==================== */
+
+void mtea::MappedDataDictionary::write(const DataDictionary& dict, const std::filesystem::path& path) {
+    // Entries are sorted by name, with values held in memory replacing those of any mapped source file
+    std::map<std::string, PendingEntry> pending;
+
+    if (dict.mapped != nullptr) {
+        for (size_t i = 0; i < dict.mapped->size(); ++i) {
+            const auto e = dict.mapped->get_entry(i);
+            pending.insert_or_assign(std::string(e.name), PendingEntry{.dtype = e.data_type,
+                                                                       .is_array = e.is_array,
+                                                                       .cols = e.cols,
+                                                                       .rows = e.rows,
+                                                                       .data = std::vector<char>(e.data.begin(), e.data.end())});
+        }
+    }
+
+    for (const auto& [k, v] : dict.vals) {
+        PendingEntry entry{.dtype = v->data_type(), .is_array = false, .cols = 1, .rows = 1, .data = {}};
+        append_raw(entry.data, v.get());
+        pending.insert_or_assign(k.get(), std::move(entry));
+    }
+
+    for (const auto& [k, arr] : dict.arrays) {
+        PendingEntry entry{.dtype = arr->data_type(), .is_array = true, .cols = arr->cols(), .rows = arr->rows(), .data = {}};
+        for (const auto& v : arr->get_values()) {
+            append_raw(entry.data, v.get());
+        }
+        pending.insert_or_assign(k.get(), std::move(entry));
+    }
+
+    // Lay out the entry table, names and payloads
+    std::vector<EntryRecord> records;
+    std::string names;
+    std::vector<char> payload_data;
+
+    for (const auto& [name, e] : pending) {
+        payload_data.resize(align_size(payload_data.size()));
+
+        records.push_back(EntryRecord{.name_offset = names.size(),
+                                      .name_size = name.size(),
+                                      .cols = e.cols,
+                                      .rows = e.rows,
+                                      .data_offset = payload_data.size(),
+                                      .dtype = static_cast<uint8_t>(e.dtype),
+                                      .is_array = static_cast<uint8_t>(e.is_array ? 1 : 0),
+                                      .padding = {}});
+
+        names.append(name);
+        payload_data.insert(payload_data.end(), e.data.begin(), e.data.end());
+    }
+
+    DictionaryHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.endian_tag = ENDIAN_TAG;
+
+    header.entries = TableRef{.offset = align_size(sizeof(DictionaryHeader)), .count = records.size()};
+    header.string_data = TableRef{.offset = align_size(header.entries.offset + records.size() * sizeof(EntryRecord)), .count = names.size()};
+    header.payload = TableRef{.offset = align_size(header.string_data.offset + names.size()), .count = payload_data.size()};
+
+    std::vector<char> buffer(header.payload.offset + payload_data.size(), 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        std::memcpy(buffer.data() + header.entries.offset, records.data(), records.size() * sizeof(EntryRecord));
+    }
+    std::ranges::copy(names, buffer.begin() + static_cast<std::ptrdiff_t>(header.string_data.offset));
+    std::ranges::copy(payload_data, buffer.begin() + static_cast<std::ptrdiff_t>(header.payload.offset));
+
+    // Replace the file rather than writing in place, so that any existing mapping of the file remains valid
+    write_file_atomic(path, [&buffer](std::ostream& os) { os.write(buffer.data(), static_cast<std::streamsize>(buffer.size())); });
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "mapped_file.hpp"
+
+#include "model_exception.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MTEA_MAPPED_FILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MTEA_MAPPED_FILE_MMAP 0
+#endif
+
+#include <fmt/format.h>
+
+mtea::MappedFile::MappedFile(const std::filesystem::path& path) {
+#if MTEA_MAPPED_FILE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ModelException(fmt::format("unable to open file '{}'", path.string()));
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw ModelException(fmt::format("unable to read file size for '{}'", path.string()));
+    }
+
+    size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (addr == MAP_FAILED) {
+        addr = nullptr;
+        throw ModelException(fmt::format("unable to map file '{}'", path.string()));
+    }
+#else
+    std::ifstream iss(path, std::ios::binary);
+    if (!iss) {
+        throw ModelException(fmt::format("unable to open file '{}'", path.string()));
+    }
+
+    buffer.assign(std::istreambuf_iterator<char>(iss), std::istreambuf_iterator<char>());
+    size = buffer.size();
+#endif
+}
+
+mtea::MappedFile::~MappedFile() {
+#if MTEA_MAPPED_FILE_MMAP
+    if (addr != nullptr) {
+        ::munmap(addr, size);
+    }
+#endif
+}
+
+std::span<const char> mtea::MappedFile::get_data() const {
+#if MTEA_MAPPED_FILE_MMAP
+    return {static_cast<const char*>(addr), size};
+#else
+    return buffer;
+#endif
+}
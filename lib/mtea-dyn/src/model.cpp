@@ -2,15 +2,28 @@
 
 #include "model.hpp"
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
+#include "atomic_file.hpp"
 #include "block_io_ports.hpp"
 #include "model_exception.hpp"
 
+#include "model_binary.hpp"
 #include "model_block.hpp"
+#include "model_compiled_data.hpp"
+#include "model_journal.hpp"
+#include "model_loader.hpp"
 
 #include "codegen.hpp"
 #include "codegen_component.hpp"
+#include "codegen_model.hpp"
 
 #include "model_manager.hpp"
 
@@ -22,308 +35,18 @@ using namespace mtea;
 
 const std::string mtea::Model::DEFAULT_MODEL_EXTENSION = ".tmdl";
 
-/* ==================== MODEL LINKS DATA =================== */
+/* ================= MODEL EXECUTION TEMPLATE ================= */
 
-struct mtea::Model::CompiledModelData {
-    struct Links {
-        struct Block {
-            size_t block_id;
-            size_t port_num;
-        };
-
-        std::unordered_map<size_t, std::vector<Block>> input_port_links; // Defines input ports -> block input ports
-        std::unordered_map<size_t, Block> output_port_links;             // Defines output ports <- block output ports
-        std::unordered_map<size_t, std::unordered_map<size_t, std::vector<Block>>>
-            component_links; // Defines block_id -> (output port, block input port)
-    };
-
-    Links links;
-    std::vector<size_t> execution_order;
-};
-
-/* ==================== MODEL COMPONENT =================== */
-
-class ModelCodeComponent : public mtea::codegen::CodeComponent {
-protected:
-    struct ComponentVariable {
-        ComponentVariable(const std::string_view name, std::unique_ptr<const codegen::CodeComponent>&& component)
-            : name{name}, component{std::move(component)} {
-            // Empty Constructor
-        }
-
-        const std::string name;
-        const std::unique_ptr<const codegen::CodeComponent> component;
-    };
-
-public:
-    ModelCodeComponent(const mtea::Identifier& model_name, const mtea::Model::CompiledModelData& exec_data,
-                       const std::vector<mtea::DataType>& input_types, const std::vector<mtea::DataType>& output_types,
-                       std::unordered_map<size_t, std::unique_ptr<const codegen::CodeComponent>>&& components)
-        : _model_name(model_name), _model_data(exec_data), _input_types(input_types), _output_types(output_types) {
-        for (auto& [bid, comp] : std::move(components)) {
-            _blocks.try_emplace(bid, fmt::format("_block_{}", bid), std::move(comp));
-        }
-        components.clear();
-
-        for (size_t i = 0; i < input_types.size(); ++i) {
-            _input_names.push_back(fmt::format("value_{}", i));
-        }
-
-        for (size_t i = 0; i < output_types.size(); ++i) {
-            _output_names.push_back(fmt::format("value_{}", i));
-        }
-    }
-
-    std::optional<mtea::codegen::InterfaceDefinition> get_input_type() const override {
-        return mtea::codegen::InterfaceDefinition("s_in", _input_names);
-    }
-
-    std::optional<mtea::codegen::InterfaceDefinition> get_output_type() const override {
-        return mtea::codegen::InterfaceDefinition("s_out", _output_names);
-    }
-
-    std::string get_name_base() const override { return _model_name.get(); }
-
-    std::optional<std::string> get_function_name(mtea::codegen::BlockFunction ft) const override {
-        switch (ft) {
-            using enum mtea::codegen::BlockFunction;
-        case STEP:
-            return "step";
-        case RESET:
-            return "reset";
-        default:
-            return {};
-        }
-    }
-
-protected:
-    std::vector<std::string> write_code(mtea::codegen::CodeSection section) const override {
-        if (section == mtea::codegen::CodeSection::DECLARATION) {
-            return write_cpp_implementation();
-        } else {
-            return {};
-        }
-    }
-
-    std::vector<std::string> write_cpp_implementation() const {
-        std::string name_base_upper = get_name_base();
-        for (auto& c : name_base_upper) {
-            c = static_cast<char>(std::toupper(c));
-        }
-
-        const std::string HDR_GUARD = fmt::format("GEN_MDL_BLOCK_{}_GUARD", name_base_upper);
-
-        std::vector<std::string> lines;
-        lines.emplace_back(fmt::format("#ifndef {}", HDR_GUARD));
-        lines.emplace_back(fmt::format("#define {}", HDR_GUARD));
-        lines.emplace_back("");
-
-        std::vector<std::string> include_files;
-        for (const auto& [varname, comp] : _blocks | std::views::values) {
-            const auto fcn_name = comp->get_module_name();
-            if (fcn_name.empty()) {
-                continue;
-            }
-
-            if (std::ranges::find(include_files, fcn_name) == include_files.end()) {
-                include_files.emplace_back(fcn_name);
-            }
-        }
-
-        std::ranges::sort(include_files);
-
-        for (const auto& f : include_files) {
-            lines.emplace_back(fmt::format("#include \"{}\"", f));
-        }
-
-        lines.emplace_back("");
-
-        lines.emplace_back(fmt::format("struct {}", get_name_base()));
-        lines.emplace_back("{");
-
-        lines.emplace_back("    struct input_t");
-        lines.emplace_back("    {");
-
-        for (size_t i = 0; i < _input_types.size(); ++i) {
-            const auto dt = _input_types[i];
-            lines.emplace_back(
-                fmt::format("        {} {}{{}};", mtea::codegen::get_datatype_name(dt), _input_names[i]));
-        }
-
-        lines.emplace_back("    };");
-        lines.emplace_back("");
-
-        lines.emplace_back("    struct output_t");
-        lines.emplace_back("    {");
-
-        for (size_t i = 0; i < _output_types.size(); ++i) {
-            const auto dt = _output_types[i];
-            lines.emplace_back(
-                fmt::format("        {} {}{{}};", mtea::codegen::get_datatype_name(dt), _output_names[i]));
-        }
-
-        lines.emplace_back("    };");
-        lines.emplace_back("");
-
-        lines.emplace_back(fmt::format("    {}()", get_name_base()));
-        lines.emplace_back("    {");
-        lines.emplace_back("    }");
-
-        lines.emplace_back("");
-
-        lines.push_back(fmt::format("    {}(const {}&) = delete;", get_name_base(), get_name_base()));
-        lines.push_back(fmt::format("    {}& operator=(const {}&) = delete;", get_name_base(), get_name_base()));
-
-        for (const auto fcn : {mtea::codegen::BlockFunction::RESET, mtea::codegen::BlockFunction::STEP}) {
-            lines.emplace_back("");
-            for (const auto& l : get_model_function_calls(fcn)) {
-                lines.emplace_back(fmt::format("    {}", l));
-            }
-        }
-
-        lines.emplace_back("");
-        lines.push_back(fmt::format("    input_t {};", get_input_type()->get_name()));
-        lines.push_back(fmt::format("    output_t {};", get_output_type()->get_name()));
-
-        if (!_blocks.empty()) {
-            lines.emplace_back("");
-            lines.emplace_back("private:");
-            for (const auto& [varname, comp] : _blocks | std::views::values) {
-                std::string args = "";
-
-                for (const auto& a : comp->constructor_arguments()) {
-                    if (args.empty()) {
-                        args = a;
-                    } else {
-                        args = fmt::format("{}, {}", args, a);
-                    }
-                }
-
-                if (!args.empty()) {
-                    args = fmt::format(" {} ", args);
-                }
-
-                lines.push_back(fmt::format("    {} {}{{{}}};", comp->get_type_name(), varname, args));
-            }
-        }
-
-        lines.emplace_back("};");
-
-        lines.emplace_back("");
-        lines.push_back(fmt::format("#endif // {}", HDR_GUARD));
-
-        return lines;
-    }
-
-    std::vector<std::string> get_model_function_calls(const mtea::codegen::BlockFunction fcn) const {
-        std::vector<std::string> fcn_lines;
-
-        for (const auto& bid : _model_data.execution_order) {
-            auto it = _blocks.find(bid);
-            if (it == _blocks.end()) {
-                continue;
-            }
-
-            std::vector<std::string> block_lines;
-
-            // Copy Input Values
-            const auto input_def = get_input_type();
-            for (const auto& [port_num, destinations] : _model_data.links.input_port_links) {
-                for (const auto& dest : destinations) {
-                    if (dest.block_id != bid) {
-                        continue;
-                    }
-
-                    const auto& blk = _blocks.at(dest.block_id);
-                    const auto comp = *blk.component->get_input_type();
-                    block_lines.push_back(fmt::format("{}.{}.{} = {}.{};", blk.name, comp.get_name(), comp.get_field(dest.port_num),
-                                                      input_def->get_name(), input_def->get_field(port_num)));
-                }
-            }
-
-            for (const auto& [src_index, vals] : _model_data.links.component_links) {
-                const auto& src_blk = _blocks.at(src_index);
-                const auto src_comp = *src_blk.component->get_output_type();
-
-                for (const auto& [src_port, dest_links] : vals) {
-                    for (const auto& dest_i : dest_links) {
-                        if (dest_i.block_id != bid) {
-                            continue;
-                        }
-
-                        const auto& dst_blk = _blocks.at(dest_i.block_id);
-                        const auto dst_comp = *dst_blk.component->get_input_type();
-
-                        block_lines.push_back(fmt::format("{}.{}.{} = {}.{}.{};", dst_blk.name, dst_comp.get_name(),
-                                                          dst_comp.get_field(dest_i.port_num), src_blk.name, src_comp.get_name(),
-                                                          src_comp.get_field(src_port)));
-                    }
-                }
-            }
-
-            // Call the resulting function name if present
-            const auto& [varname, comp] = it->second;
-            const auto fcn_name = comp->get_function_name(fcn);
-            if (fcn_name) {
-                block_lines.push_back(fmt::format("{}.{}();", varname, *fcn_name));
-            }
-
-            // Add the lines to the block if needed
-            if (!block_lines.empty()) {
-                if (!fcn_lines.empty()) {
-                    fcn_lines.emplace_back("");
-                }
-
-                fcn_lines.emplace_back(fmt::format("// Block {} - {}", bid, it->second.name));
-                for (const auto& bl : block_lines) {
-                    fcn_lines.emplace_back(fmt::format("{}", bl));
-                }
-            }
-        }
-
-        if (fcn == mtea::codegen::BlockFunction::STEP || fcn == mtea::codegen::BlockFunction::RESET) {
-            const auto output_def = get_output_type();
-            std::vector<std::string> output_lines;
-
-            for (const auto& [port_num, src] : _model_data.links.output_port_links) {
-                const auto& blk = _blocks.at(src.block_id);
-                const auto comp = *blk.component->get_output_type();
-                output_lines.push_back(fmt::format("{}.{} = {}.{}.{};", output_def->get_name(), output_def->get_field(port_num), blk.name,
-                                                   comp.get_name(), comp.get_field(src.port_num)));
-            }
-
-            if (!output_lines.empty()) {
-                if (!fcn_lines.empty()) {
-                    fcn_lines.emplace_back("");
-                }
-                fcn_lines.emplace_back("// Copy Output Values");
-                for (const auto& ol : output_lines) {
-                    fcn_lines.emplace_back(fmt::format("{}", ol));
-                }
-            }
-        }
-
-        std::vector<std::string> lines;
-        lines.push_back(fmt::format("void {}()", *get_function_name(fcn)));
-        lines.emplace_back("{");
-
-        for (const auto& l : fcn_lines) {
-            lines.emplace_back(fmt::format("    {}", l));
-        }
-
-        lines.emplace_back("}");
-
-        return lines;
+struct mtea::Model::ExecutionTemplate {
+    explicit ExecutionTemplate(const BlockInterface::ModelInfo& info) : info(info) {
+        // Empty Constructor
     }
 
-private:
-    const mtea::Identifier _model_name;
-    const mtea::Model::CompiledModelData _model_data;
-    std::vector<mtea::DataType> _input_types;
-    std::vector<std::string> _input_names;
-    std::vector<mtea::DataType> _output_types;
-    std::vector<std::string> _output_names;
-    std::unordered_map<size_t, ComponentVariable> _blocks;
+    const BlockInterface::ModelInfo info;
+    std::shared_ptr<const CompiledModelData> compiled;
+    std::shared_ptr<const SignalLayout> layout;
+    std::vector<VariableIdentifier> output_sources;
+    std::vector<std::unique_ptr<CompiledBlockInterface>> blocks;
 };
 
 /* ==================== MODEL EXECUTOR ==================== */
@@ -369,6 +92,24 @@ private:
 
 /* ==================== MODEL ==================== */
 
+// Shared by every model, so that a version is never repeated anywhere in a model hierarchy
+static std::atomic<uint64_t> structure_version_counter{0};
+
+static uint64_t next_structure_version() { return ++structure_version_counter; }
+
+Model::Model(ModelManager& manager) : manager(&manager) {
+    // Empty Constructor
+}
+
+Model::~Model() {
+    // Blocks may be kept by the editor after the model is closed
+    for (const auto& blk : blocks | std::views::values) {
+        unwatch_parameters(*blk);
+    }
+}
+
+ModelManager& Model::get_manager() const { return *manager; }
+
 void Model::set_unsaved_changes() { has_unsaved_changed = true; }
 
 bool Model::get_unsaved_changes() const { return has_unsaved_changed; }
@@ -394,11 +135,17 @@ void Model::add_block(const std::shared_ptr<BlockInterface> block, const size_t
         input_ids.push_back(id);
     } else if (const auto out_ptr = std::dynamic_pointer_cast<OutputPort>(block)) {
         output_ids.push_back(id);
+    } else if (const auto mdl_ptr = std::dynamic_pointer_cast<ModelBlock>(block)) {
+        submodel_ids.insert(id);
     }
 
     block->set_id(id);
     blocks.try_emplace(id, block);
-    has_unsaved_changed = true;
+    watch_parameters(*block);
+    pending_updates.push_back(id);
+    mark_structure_changed();
+
+    record_block_entry("add_block", *block);
 }
 
 void Model::remove_block(const size_t id) {
@@ -408,7 +155,10 @@ void Model::remove_block(const size_t id) {
         throw ModelException(fmt::format("id {} not found in the block map", id));
     }
 
+    unwatch_parameters(*map_it->second);
     blocks.erase(map_it);
+    submodel_ids.erase(id);
+    submodel_versions.erase(id);
 
     // Remove references in the port vectors
     for (auto* vec : {&input_ids, &output_ids}) {
@@ -424,11 +174,14 @@ void Model::remove_block(const size_t id) {
             continue;
 
         get_block(c->get_to_id())->set_input_type(c->get_to_port(), DataType::NONE);
+        pending_updates.push_back(c->get_to_id());
     }
 
     // Remove references to the block ID
     connections.remove_block(id);
-    has_unsaved_changed = true;
+    mark_structure_changed();
+
+    record_journal_entry({{"op", "remove_block"}, {"id", id}});
 }
 
 void Model::add_connection(const std::shared_ptr<Connection> connection) {
@@ -443,13 +196,17 @@ void Model::add_connection(const std::shared_ptr<Connection> connection) {
         connections.add_connection(connection);
         to_block->set_input_type(connection->get_to_port(), from_block->get_output_type(connection->get_from_port()));
 
+        // Changes to the output types are propagated to downstream blocks by the next model update
         to_block->update_block();
+        pending_updates.push_back(to_block->get_id());
     } else {
         throw ModelException(fmt::format("from ({} < {}) / to ({} < {}) block and port number mismatch", connection->get_from_port(),
                                          from_block->get_num_outputs(), connection->get_to_port(), to_block->get_num_inputs()));
     }
 
-    has_unsaved_changed = true;
+    mark_structure_changed();
+
+    record_journal_entry({{"op", "add_connection"}, {"connection", *connection}});
 }
 
 void Model::remove_connection(const size_t to_block, const size_t to_port) {
@@ -460,8 +217,11 @@ void Model::remove_connection(const size_t to_block, const size_t to_port) {
     }
 
     connections.remove_connection(to_block, to_port);
+    pending_updates.push_back(to_block);
 
-    has_unsaved_changed = true;
+    mark_structure_changed();
+
+    record_journal_entry({{"op", "remove_connection"}, {"to_block", to_block}, {"to_port", to_port}});
 }
 
 std::string Model::get_name() const {
@@ -478,6 +238,8 @@ void Model::set_description(const std::string_view s) {
     if (description != s) {
         description = s;
         has_unsaved_changed = true;
+
+        record_journal_entry({{"op", "set_description"}, {"value", description}});
     }
 }
 
@@ -489,8 +251,11 @@ void Model::set_preferred_dt(const double dt) {
     }
 
     if (preferred_dt != dt) {
+        // Rate groups and timestep-dependent block arguments are read from the preferred step when the model is compiled
         preferred_dt = dt;
-        has_unsaved_changed = true;
+        mark_structure_changed();
+
+        record_journal_entry({{"op", "set_preferred_dt"}, {"value", preferred_dt}});
     }
 }
 
@@ -503,43 +268,176 @@ const std::vector<size_t>& Model::get_input_ids() const { return input_ids; }
 const std::vector<size_t>& Model::get_output_ids() const { return output_ids; }
 
 bool Model::update_block() {
-    bool any_updated = true;
+    // Seed the worklist with blocks marked as changed, along with any subsystem blocks whose inner
+    // models have been edited independently of this model
+    std::deque<size_t> worklist;
+    std::unordered_set<size_t> queued;
+
+    const auto enqueue = [&worklist, &queued](const size_t id) {
+        if (queued.insert(id).second) {
+            worklist.push_back(id);
+        }
+    };
+
+    if (pending_full_update) {
+        for (const auto& id : blocks | std::views::keys) {
+            enqueue(id);
+        }
+    } else {
+        for (const auto id : pending_updates) {
+            enqueue(id);
+        }
+
+        for (const auto id : submodel_ids) {
+            const auto it = submodel_versions.find(id);
+            if (it == submodel_versions.end() || it->second != get_submodel_version(id)) {
+                enqueue(id);
+            }
+        }
+    }
+
+    // Marked blocks have changed regardless of their output types, as a new connection or parameter
+    // may change the values passed downstream, and so always propagate
+    std::unordered_set<size_t> marked(pending_updates.begin(), pending_updates.end());
+
+    pending_updates.clear();
+    pending_full_update = false;
+
     bool model_updated = false;
-    size_t update_count = 0;
-    const size_t UPDATE_LIMIT = blocks.size() * 2;
+    size_t evaluations = 0;
+    std::unordered_map<size_t, size_t> block_evaluations;
+    const size_t UPDATE_LIMIT = blocks.size() * 2 + 1;
+
+    while (!worklist.empty()) {
+        const size_t id = worklist.front();
+        worklist.pop_front();
+        queued.erase(id);
+
+        // Skip blocks that were removed after being marked
+        const auto blk_it = blocks.find(id);
+        if (blk_it == blocks.end()) {
+            continue;
+        }
+
+        const auto& blk = blk_it->second;
 
-    while (any_updated) {
-        // Set all to not updated
-        any_updated = false;
+        if (++block_evaluations[id] > UPDATE_LIMIT) {
+            throw ModelException("iteration limit exceeded trying to update model block");
+        }
 
-        // Update any port types
-        for (const auto& c : connections.get_connections()) {
-            std::shared_ptr<const BlockInterface> from_blk = get_block(c->get_from_id());
-            std::shared_ptr<BlockInterface> to_blk = get_block(c->get_to_id());
+        evaluations += 1;
 
-            to_blk->set_input_type(c->get_to_port(), from_blk->get_output_type(c->get_from_port()));
+        // Store the current output types to check whether downstream blocks must be updated
+        std::vector<DataType> prev_output_types;
+        for (size_t i = 0; i < blk->get_num_outputs(); ++i) {
+            prev_output_types.push_back(blk->get_output_type(i));
         }
 
-        // Check each port for updates
-        for (const auto& blk : blocks | std::views::values) {
-            any_updated |= blk->update_block();
+        // Update input port types from the connected blocks
+        for (const auto& c : connections.get_connections_to(id)) {
+            const auto from_blk = get_block(c->get_from_id());
+            if (c->get_to_port() >= blk->get_num_inputs() || c->get_from_port() >= from_blk->get_num_outputs()) {
+                continue;
+            }
+
+            blk->set_input_type(c->get_to_port(), from_blk->get_output_type(c->get_from_port()));
         }
 
-        // Mark as updated, and break if the count has been exceeded
-        if (any_updated) {
-            model_updated = true;
+        // Update the block and queue downstream blocks if the output interface changed
+        bool blk_updated = blk->update_block();
+
+        if (marked.erase(id) > 0) {
+            blk_updated = true;
         }
 
-        if (update_count > UPDATE_LIMIT) {
-            throw ModelException("iteration limit exceeded trying to update model block");
+        if (submodel_ids.contains(id)) {
+            submodel_versions[id] = get_submodel_version(id);
+        }
+
+        if (prev_output_types.size() != blk->get_num_outputs()) {
+            blk_updated = true;
+        } else {
+            for (size_t i = 0; i < prev_output_types.size() && !blk_updated; ++i) {
+                blk_updated = prev_output_types[i] != blk->get_output_type(i);
+            }
+        }
+
+        if (blk_updated) {
+            model_updated = true;
+
+            for (const auto& c : connections.get_connections_from(id)) {
+                enqueue(c->get_to_id());
+            }
         }
+    }
 
-        update_count += 1;
+    if (model_updated) {
+        structure_version = next_structure_version();
     }
 
+    update_statistics.update_calls += 1;
+    update_statistics.last_evaluations = evaluations;
+    update_statistics.total_evaluations += evaluations;
+
     return model_updated;
 }
 
+void Model::mark_block_changed(const size_t id) {
+    if (!blocks.contains(id)) {
+        throw ModelException(fmt::format("id {} not found in the block map", id));
+    }
+
+    pending_updates.push_back(id);
+    structure_version = next_structure_version();
+
+    record_block_entry("update_block", *get_block(id));
+}
+
+void Model::mark_block_layout_changed(const size_t id) {
+    // Location and orientation don't affect the compiled model, and so only need to be saved
+    has_unsaved_changed = true;
+    record_block_entry("update_block", *get_block(id));
+}
+
+void Model::mark_connection_changed(const size_t to_block, const size_t to_port) {
+    const auto c = connections.get_connection_to(to_block, to_port);
+
+    has_unsaved_changed = true;
+    record_journal_entry({{"op", "update_connection"}, {"connection", *c}});
+}
+
+const Model::UpdateStatistics& Model::get_update_statistics() const { return update_statistics; }
+
+uint64_t Model::get_submodel_version(const size_t id) const {
+    if (const auto mdl = std::dynamic_pointer_cast<const ModelBlock>(get_block(id))) {
+        return mdl->get_model()->get_version();
+    } else {
+        return 0;
+    }
+}
+
+uint64_t Model::get_version() const {
+    // Versions are drawn from one process-wide counter, so the latest change anywhere in the hierarchy, including the
+    // removal of a subsystem, always gives a version that hasn't been seen before
+    uint64_t version = structure_version;
+
+    for (const auto id : submodel_ids) {
+        version = std::max(version, get_submodel_version(id));
+    }
+
+    return version;
+}
+
+Model::CompileCacheStatistics Model::get_compile_cache_statistics() const {
+    std::lock_guard lock(cache_mutex);
+    return compile_cache_statistics;
+}
+
+void Model::mark_structure_changed() {
+    structure_version = next_structure_version();
+    has_unsaved_changed = true;
+}
+
 std::unique_ptr<const BlockError> Model::has_error() const {
     for (const auto& blk : blocks | std::views::values) {
         auto blk_error = blk->has_error();
@@ -595,7 +493,26 @@ DataType Model::get_output_datatype(const size_t port) const {
     }
 }
 
-mtea::Model::CompiledModelData Model::compile_model() const {
+std::shared_ptr<const mtea::Model::CompiledModelData> Model::compile_model() const {
+    // Reuse the stored result if the model hasn't changed since it was compiled
+    const uint64_t version = get_version();
+
+    std::lock_guard lock(cache_mutex);
+
+    if (compiled_cache != nullptr && compiled_cache_version == version) {
+        compile_cache_statistics.hits += 1;
+        return compiled_cache;
+    }
+
+    compile_cache_statistics.misses += 1;
+
+    compiled_cache = std::make_shared<const CompiledModelData>(build_compiled_model());
+    compiled_cache_version = version;
+
+    return compiled_cache;
+}
+
+mtea::Model::CompiledModelData Model::build_compiled_model() const {
     // Skip if an error is present
     if (const auto err = has_error(); err != nullptr) {
         throw ModelException(err->message);
@@ -603,6 +520,13 @@ mtea::Model::CompiledModelData Model::compile_model() const {
 
     CompiledModelData data;
 
+    // Compact the block ids into dense indices
+    data.dense_index.resize(blocks.capacity(), CompiledModelData::NO_INDEX);
+    for (const auto& blk_id : blocks | std::views::keys) {
+        data.dense_index[blk_id] = data.block_ids.size();
+        data.block_ids.push_back(blk_id);
+    }
+
     // Add the input blocks as the first to be executed
     for (const size_t i : input_ids) {
         data.execution_order.push_back(i);
@@ -680,13 +604,14 @@ mtea::Model::CompiledModelData Model::compile_model() const {
         block.block_id = c->get_from_id();
         block.port_num = c->get_from_port();
 
-        data.links.output_port_links[i] = block;
+        data.links.output_port_links.push_back(block);
     }
 
     // Add input port types
+    data.links.input_port_links.resize(input_ids.size());
     for (size_t i = 0; i < input_ids.size(); ++i) {
-        for (const auto& c : connections.get_connections()) {
-            if (c->get_from_id() != input_ids[i] || c->get_from_port() != 0) {
+        for (const auto& c : connections.get_connections_from(input_ids[i])) {
+            if (c->get_from_port() != 0) {
                 continue;
             }
 
@@ -698,6 +623,7 @@ mtea::Model::CompiledModelData Model::compile_model() const {
         }
     }
 
+    data.links.component_links.resize(data.block_ids.size());
     for (const auto& c : connections.get_connections()) {
         if (std::ranges::find(input_ids, c->get_from_id()) != input_ids.end()) {
             continue;
@@ -709,32 +635,88 @@ mtea::Model::CompiledModelData Model::compile_model() const {
         blk.block_id = c->get_to_id();
         blk.port_num = c->get_to_port();
 
-        data.links.component_links[c->get_from_id()][c->get_from_port()].push_back(blk);
+        auto& src_links = data.links.component_links[data.get_dense_index(c->get_from_id())];
+        if (src_links.size() <= c->get_from_port()) {
+            src_links.resize(c->get_from_port() + 1);
+        }
+
+        src_links[c->get_from_port()].push_back(blk);
+    }
+
+    // Add the port data types
+    for (size_t i = 0; i < input_ids.size(); ++i) {
+        data.input_types.push_back(get_input_datatype(i));
+    }
+
+    for (size_t i = 0; i < output_ids.size(); ++i) {
+        data.output_types.push_back(get_output_datatype(i));
     }
 
     // Return the result
     return data;
 }
 
+std::shared_ptr<const Model::ExecutionTemplate> Model::get_execution_template(const BlockInterface::ModelInfo& state) const {
+    // Reuse the stored template if the model and timestep haven't changed
+    const auto exec_data = compile_model();
+    const uint64_t version = get_version();
+
+    std::lock_guard lock(cache_mutex);
+
+    if (execution_template != nullptr && execution_template_version == version && execution_template->compiled == exec_data &&
+        execution_template->info.get_dt() == state.get_dt()) {
+        return execution_template;
+    }
+
+    auto tmpl = std::make_shared<ExecutionTemplate>(state);
+    tmpl->compiled = exec_data;
+
+    // Determine the inner variables that are provided by the outer model
+    for (size_t i = 0; i < output_ids.size(); ++i) {
+        const auto c = connections.get_connection_to(output_ids[i], 0);
+        tmpl->output_sources.push_back(VariableIdentifier{.block_id = c->get_from_id(), .output_port_num = c->get_from_port()});
+    }
+
+    // Add interior block types, skipping variables that alias input/output ports
+    auto layout = std::make_shared<SignalLayout>();
+    for (const auto& [blk_id, blk] : blocks) {
+        for (size_t i = 0; i < blk->get_num_outputs(); ++i) {
+            const VariableIdentifier vid{.block_id = blk_id, .output_port_num = i};
+
+            if (std::ranges::find(input_ids, blk_id) != input_ids.end() || std::ranges::find(tmpl->output_sources, vid) != tmpl->output_sources.end()) {
+                continue;
+            }
+
+            layout->add_variable(vid, blk->get_output_type(i));
+        }
+    }
+
+    tmpl->layout = layout;
+
+    // Compile each block in execution order against the template-owned model information
+    for (const auto& b_id : exec_data->execution_order) {
+        tmpl->blocks.push_back(get_block(b_id)->get_compiled(tmpl->info));
+    }
+
+    execution_template = tmpl;
+    execution_template_version = version;
+
+    return execution_template;
+}
+
 std::unique_ptr<ModelExecutionInterface> Model::get_execution_interface(const size_t block_id, const ConnectionManager& outer_connections,
                                                                         const VariableManager& outer_variables,
                                                                         const BlockInterface::ModelInfo& state) const {
-    // Get the execution order
-    const std::vector<size_t> order_values = compile_model().execution_order;
+    // Get the shared execution template
+    const auto tmpl = get_execution_template(state);
 
-    // Construct the variable list values
-    auto variables = std::make_shared<VariableManager>();
+    // Construct the variable list values, with interior values stored in a single slab for this instance
+    auto variables = std::make_shared<VariableManager>(tmpl->layout);
 
     // Add output port types
     for (size_t i = 0; i < output_ids.size(); ++i) {
         const auto outer_id = VariableIdentifier{.block_id = block_id, .output_port_num = i};
-
-        const auto ptr_val = outer_variables.get_ptr(outer_id);
-
-        const auto c = connections.get_connection_to(output_ids[i], 0);
-        const auto inner_id = VariableIdentifier{.block_id = c->get_from_id(), .output_port_num = c->get_from_port()};
-
-        variables->add_variable(inner_id, ptr_val);
+        variables->add_variable(tmpl->output_sources[i], outer_variables.get_ptr(outer_id));
     }
 
     // Add input port types
@@ -747,26 +729,10 @@ std::unique_ptr<ModelExecutionInterface> Model::get_execution_interface(const si
         variables->add_variable(inner_id, ptr_val);
     }
 
-    // Add interior block types
-    for (const auto& [blk_id, blk] : blocks) {
-        // Grab block, but skip if an input or output port, as it would have been updated above
-        for (size_t i = 0; i < blk->get_num_outputs(); ++i) {
-            const VariableIdentifier vid{.block_id = blk->get_id(), .output_port_num = i};
-
-            // Skip if variable already added (due to input/output)
-            if (!variables->has_variable(vid)) {
-                const auto pv = get_block(vid.block_id)->get_output_type(vid.output_port_num);
-                variables->add_variable(vid, std::shared_ptr<ModelValue>(ModelValue::make_default(pv)));
-            }
-        }
-    }
-
     // Construct the interface order value
     std::vector<std::shared_ptr<BlockExecutionInterface>> interface_order;
-    for (const auto& b_id : order_values) {
-        std::shared_ptr<BlockExecutionInterface> block =
-            get_block(b_id)->get_compiled(state)->get_execution_interface(connections, *variables);
-        interface_order.push_back(block);
+    for (const auto& compiled : tmpl->blocks) {
+        interface_order.push_back(compiled->get_execution_interface(connections, *variables));
     }
 
     // Create the executor
@@ -776,18 +742,56 @@ std::unique_ptr<ModelExecutionInterface> Model::get_execution_interface(const si
     return model_exec;
 }
 
-std::unique_ptr<codegen::CodeComponent> Model::get_codegen_component(const BlockInterface::ModelInfo& state) const {
-    // Throw exception if no name provided
-    if (!name.has_value()) {
-        throw ModelException("cannot generate code for model without name");
+ExecutionArtifact::SlotMap Model::add_to_artifact(const size_t block_id, const ConnectionManager& outer_connections,
+                                                  const ExecutionArtifact::SlotMap& outer_slots, const BlockInterface::ModelInfo& state,
+                                                  ExecutionArtifact& artifact) const {
+    // Get the shared execution template
+    const auto tmpl = get_execution_template(state);
+
+    // Allocate an artifact signal for each interior variable
+    ExecutionArtifact::SlotMap slots;
+    for (const auto& e : tmpl->layout->get_entries()) {
+        slots[e.id] = artifact.add_signal(e.data_type);
     }
 
-    // Get the execution order
+    // Alias output ports to the signals of the outer model
+    for (size_t i = 0; i < output_ids.size(); ++i) {
+        const auto outer_id = VariableIdentifier{.block_id = block_id, .output_port_num = i};
+        slots[tmpl->output_sources[i]] = ExecutionArtifact::get_slot(outer_slots, outer_id);
+    }
+
+    // Alias input ports to the signals of the outer model
+    for (size_t i = 0; i < input_ids.size(); ++i) {
+        const auto outer_connection = outer_connections.get_connection_to(block_id, i);
+        const auto outer_id = VariableIdentifier{.block_id = outer_connection->get_from_id(), .output_port_num = outer_connection->get_from_port()};
+
+        const auto inner_id = VariableIdentifier{.block_id = input_ids[i], .output_port_num = 0};
+        if (!slots.try_emplace(inner_id, ExecutionArtifact::get_slot(outer_slots, outer_id)).second) {
+            throw ModelException(fmt::format("input port {} cannot be directly connected to an output port", i));
+        }
+    }
+
+    // Add each block in execution order, flattening any submodels
+    for (const auto& compiled : tmpl->blocks) {
+        compiled->add_to_artifact(connections, slots, artifact);
+    }
+
+    return slots;
+}
+
+std::unique_ptr<codegen::CodeComponent> Model::get_codegen_component(const BlockInterface::ModelInfo& state) const {
+    // Throw exception if no name provided
+    if (!name.has_value()) {
+        throw ModelException("cannot generate code for model without name");
+    }
+
+    // Get the execution order
     const auto exec_data = compile_model();
 
     // Construct the block parameters
-    std::unordered_map<size_t, std::unique_ptr<const codegen::CodeComponent>> components;
-    for (const auto& id : exec_data.execution_order) {
+    std::vector<std::unique_ptr<const codegen::CodeComponent>> components(exec_data->block_ids.size());
+    std::vector<std::shared_ptr<const BlockInterface>> sources(exec_data->block_ids.size());
+    for (const auto& id : exec_data->execution_order) {
         if (std::ranges::find(input_ids, id) != input_ids.end()) {
             // Skip Input
         }
@@ -796,29 +800,26 @@ std::unique_ptr<codegen::CodeComponent> Model::get_codegen_component(const Block
             // Skip Output
         } else {
             const auto blk = get_block(id);
-            components.emplace(id, blk->get_compiled(state)->get_codegen_self());
+            components[exec_data->get_dense_index(id)] = blk->get_compiled(state)->get_codegen_self();
+            sources[exec_data->get_dense_index(id)] = blk;
         }
     }
 
-    std::vector<DataType> input_types;
-    std::vector<DataType> output_types;
-
-    for (size_t i = 0; i < input_ids.size(); ++i) {
-        input_types.push_back(get_input_datatype(i));
-    }
-
-    for (size_t i = 0; i < output_ids.size(); ++i) {
-        output_types.push_back(get_output_datatype(i));
-    }
-
     // Return the results
-    return std::make_unique<ModelCodeComponent>(*name, exec_data, input_types, output_types, std::move(components));
+    return std::make_unique<codegen::ModelCodeComponent>(*name, state.get_dt(), preferred_dt, exec_data, std::move(components),
+                                                          std::move(sources));
 }
 
 std::vector<std::unique_ptr<codegen::CodeComponent>> Model::get_all_sub_components(const BlockInterface::ModelInfo& state) const {
     std::vector<std::unique_ptr<codegen::CodeComponent>> components;
+    std::unordered_set<const Model*> visited_models;
 
     for (const auto& [blk_id, blk] : blocks) {
+        // Only generate each subsystem once, as every instance produces the same components
+        if (const auto mdl = std::dynamic_pointer_cast<const ModelBlock>(blk); mdl && !visited_models.insert(mdl->get_model().get()).second) {
+            continue;
+        }
+
         for (auto& c : blk->get_compiled(state)->get_codegen_components()) {
             components.push_back(std::move(c));
         }
@@ -845,14 +846,7 @@ std::vector<std::unique_ptr<const BlockError>> Model::get_all_errors() const {
 
 const ConnectionManager& Model::get_connection_manager() const { return connections; }
 
-size_t Model::get_next_id() const {
-    size_t current_id = 0;
-    while (blocks.contains(current_id)) {
-        current_id += 1;
-    }
-
-    return current_id;
-}
+size_t Model::get_next_id() { return blocks.next_id(); }
 
 std::shared_ptr<BlockInterface> Model::get_block(const size_t id) const {
     const auto it = blocks.find(id);
@@ -862,6 +856,13 @@ std::shared_ptr<BlockInterface> Model::get_block(const size_t id) const {
     return it->second;
 }
 
+BlockStore::Handle Model::get_block_handle(const size_t id) const { return blocks.get_handle(id); }
+
+std::shared_ptr<BlockInterface> Model::find_block(const BlockStore::Handle& handle) const {
+    const auto it = blocks.find(handle);
+    return it == blocks.end() ? nullptr : it->second;
+}
+
 std::vector<std::shared_ptr<BlockInterface>> Model::get_blocks() const {
     std::vector<std::shared_ptr<BlockInterface>> retval;
 
@@ -902,37 +903,35 @@ void Model::clear_filename() {
     filename.reset();
 }
 
-std::shared_ptr<mtea::Model> mtea::Model::load_model(const std::filesystem::path& path) {
-    std::ifstream iss(path);
-    if (!iss) {
-        throw ModelException(fmt::format("unable to open file for model with '{}'", path.string()));
+void mtea::Model::save_model() const {
+    if (!filename.has_value()) {
+        throw ModelException("cannot save model without stored filename");
     }
 
-    nlohmann::json j;
-    try {
-        iss >> j;
-    } catch (const nlohmann::json::exception& err) {
-        throw ModelException(fmt::format("unable to load model '{}' - {}", path.string(), err.what()));
+    // Edits already recorded in the journal only need to be committed, and are written into the model file in the background
+    if (journal != nullptr && journal->get_model_path() == *filename && !journal->get_last_error().has_value()) {
+        journal->commit();
+        has_unsaved_changed = false;
+        return;
     }
 
-    const auto mdl = std::make_shared<mtea::Model>();
-    mdl->set_filename(path);
-
-    mtea::from_json(j["model"], *mdl);
-
-    return mdl;
-}
-
-void mtea::Model::save_model() const {
-    if (filename.has_value()) {
-        std::ofstream oss(*filename);
+    // The journal is replaced once the full model has been written, dropping the journal for any previous file name
+    if (journal != nullptr) {
+        const auto prev_path = journal->get_model_path();
+        journal.reset();
+        ModelJournal::remove(prev_path);
+    }
 
+    if (ModelBinaryFormat::is_binary_path(*filename)) {
+        ModelBinaryFormat::write(*this, *filename);
+    } else {
         nlohmann::json j;
         j["model"] = *this;
 
-        oss << std::setw(4) << j;
-    } else {
-        throw ModelException("cannot save model without stored filename");
+        write_file_atomic(*filename, [&j](std::ostream& os) { os << std::setw(4) << j; });
+
+        journal_offset = get_block_offset();
+        journal = ModelJournal::create(*filename);
     }
 
     has_unsaved_changed = false;
@@ -956,7 +955,7 @@ struct SaveParameter {
 
         if (const auto prm_mdl = dynamic_cast<const mtea::ParameterValue*>(prm)) {
             dtype = prm_mdl->get_value()->data_type();
-        } else if (const auto prm_dt = dynamic_cast<const mtea::ParameterDataType*>(prm)) {
+        } else if (dynamic_cast<const mtea::ParameterDataType*>(prm) || dynamic_cast<const mtea::ParameterIdentifier*>(prm)) {
             dtype = DataType::NONE;
         } else {
             throw ModelException("unknown save parameter type provided");
@@ -1008,52 +1007,417 @@ void from_json(const nlohmann::json& j, SaveBlock& b) {
     j.at("inverted").get_to(b.inverted);
 }
 
-void mtea::to_json(nlohmann::json& j, const mtea::Model& m) {
-    // Find the offset XY positions
-    std::optional<BlockLocation> block_offset = std::nullopt;
-    for (const auto& blk : m.blocks | std::views::values) {
-        const auto loc = blk->get_loc();
-        if (!block_offset) {
-            block_offset = loc;
+static SaveBlock make_save_block(const BlockInterface& blk, const BlockLocation& offset) {
+    std::vector<SaveParameter> json_parameters;
+    for (const auto& p : blk.get_parameters()) {
+        json_parameters.emplace_back(p.get());
+    }
+
+    return SaveBlock{
+        .id = blk.get_id(),
+        .name = blk.get_full_name(),
+        .parameters = json_parameters,
+        .x = blk.get_loc().x - offset.x,
+        .y = blk.get_loc().y - offset.y,
+        .inverted = blk.get_inverted(),
+    };
+}
+
+/* ==================== STREAMING JSON LOADER ==================== */
+
+// Collects a single JSON value from SAX events, so that only one model entry is held in memory at a time
+class JsonSubtree {
+public:
+    template <typename T> void add_value(T&& v) {
+        insert(nlohmann::json(std::forward<T>(v)));
+        if (stack.empty()) {
+            complete = true;
+        }
+    }
+
+    void start_container(nlohmann::json&& container) { stack.push_back(insert(std::move(container))); }
+
+    void end_container() {
+        stack.pop_back();
+        if (stack.empty()) {
+            complete = true;
+        }
+    }
+
+    void set_key(std::string&& k) { key = std::move(k); }
+
+    bool is_complete() const { return complete; }
+
+    const nlohmann::json& get() const { return root; }
+
+private:
+    nlohmann::json* insert(nlohmann::json&& v) {
+        if (stack.empty()) {
+            root = std::move(v);
+            return &root;
+        }
+
+        auto& parent = *stack.back();
+        if (parent.is_array()) {
+            parent.push_back(std::move(v));
+            return &parent.back();
         } else {
-            block_offset->x = std::min(block_offset->x, loc.x);
-            block_offset->y = std::min(block_offset->y, loc.y);
+            auto& child = parent[key];
+            child = std::move(v);
+            return &child;
         }
     }
 
-    if (!block_offset) {
-        block_offset.emplace();
+    nlohmann::json root;
+    std::vector<nlohmann::json*> stack;
+    std::string key;
+    bool complete{false};
+};
+
+// Receives each model entry from the JSON reader as soon as it has been read
+class JsonModelSink {
+public:
+    virtual ~JsonModelSink() = default;
+
+    virtual void set_description(std::string&& description) = 0;
+
+    virtual void set_preferred_dt(const double dt) = 0;
+
+    virtual void set_input_ids(std::vector<size_t>&& ids) = 0;
+
+    virtual void set_output_ids(std::vector<size_t>&& ids) = 0;
+
+    virtual void add_connection(std::shared_ptr<Connection> c) = 0;
+
+    virtual void add_block(SaveBlock&& blk) = 0;
+};
+
+// Reads a model from SAX events, passing each block and connection to the sink as soon as its entry has been read,
+// rather than building the full document tree first
+class JsonModelReader : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit JsonModelReader(JsonModelSink& sink) : sink(sink) {}
+
+    void finish() const {
+        if (!found_model) {
+            throw ModelException("no model entry found in model file");
+        }
+
+        for (const auto k : REQUIRED_KEYS) {
+            if (!found_keys.contains(k)) {
+                throw ModelException(fmt::format("model entry is missing required key '{}'", k));
+            }
+        }
     }
 
+    bool null() override { return on_value(nullptr); }
+
+    bool boolean(bool val) override { return on_value(val); }
+
+    bool number_integer(number_integer_t val) override { return on_value(val); }
+
+    bool number_unsigned(number_unsigned_t val) override { return on_value(val); }
+
+    bool number_float(number_float_t val, const string_t&) override { return on_value(val); }
+
+    bool string(string_t& val) override { return on_value(std::move(val)); }
+
+    bool binary(binary_t&) override { throw ModelException("unexpected binary value in model file"); }
+
+    bool start_object(std::size_t) override {
+        if (capture) {
+            capture->start_container(nlohmann::json::object());
+        } else if (level == Level::Document) {
+            level = Level::Root;
+        } else if (level == Level::Root && current_key == "model") {
+            level = Level::Model;
+            found_model = true;
+        } else {
+            begin_capture();
+            capture->start_container(nlohmann::json::object());
+        }
+
+        return true;
+    }
+
+    bool end_object() override {
+        if (capture) {
+            capture->end_container();
+            finish_capture();
+        } else if (level == Level::Model) {
+            level = Level::Root;
+        } else if (level == Level::Root) {
+            level = Level::Document;
+        }
+
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (capture) {
+            capture->start_container(nlohmann::json::array());
+        } else if (level == Level::Model && (current_key == "blocks" || current_key == "connections")) {
+            section = current_key == "blocks" ? Section::Blocks : Section::Connections;
+            found_keys.insert(current_key);
+            level = Level::Section;
+        } else {
+            begin_capture();
+            capture->start_container(nlohmann::json::array());
+        }
+
+        return true;
+    }
+
+    bool end_array() override {
+        if (capture) {
+            capture->end_container();
+            finish_capture();
+        } else if (level == Level::Section) {
+            level = Level::Model;
+        }
+
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (capture) {
+            capture->set_key(std::move(val));
+        } else {
+            current_key = std::move(val);
+        }
+
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception& ex) override { throw ex; }
+
+private:
+    enum class Level {
+        Document,
+        Root,
+        Model,
+        Section,
+    };
+
+    enum class Section {
+        Blocks,
+        Connections,
+    };
+
+    template <typename T> bool on_value(T&& val) {
+        if (!capture) {
+            begin_capture();
+        }
+
+        capture->add_value(std::forward<T>(val));
+        finish_capture();
+        return true;
+    }
+
+    void begin_capture() {
+        if (level == Level::Document) {
+            throw ModelException("model file must contain a JSON object");
+        } else if (level == Level::Root && current_key == "model") {
+            throw ModelException("model entry must be a JSON object");
+        }
+
+        capture.emplace();
+        capture_level = level;
+        capture_key = current_key;
+    }
+
+    void finish_capture() {
+        if (!capture->is_complete()) {
+            return;
+        }
+
+        const auto& value = capture->get();
+
+        if (capture_level == Level::Section && section == Section::Blocks) {
+            sink.add_block(value.get<SaveBlock>());
+        } else if (capture_level == Level::Section && section == Section::Connections) {
+            const auto c = std::make_shared<mtea::Connection>(0, 0, 0, 0);
+            from_json(value, *c);
+            sink.add_connection(c);
+        } else if (capture_level == Level::Model) {
+            found_keys.insert(capture_key);
+
+            if (capture_key == "description") {
+                sink.set_description(value.get<std::string>());
+            } else if (capture_key == "preferred_dt") {
+                sink.set_preferred_dt(value.get<double>());
+            } else if (capture_key == "output_ids") {
+                sink.set_output_ids(value.get<std::vector<size_t>>());
+            } else if (capture_key == "input_ids") {
+                sink.set_input_ids(value.get<std::vector<size_t>>());
+            } else if (capture_key == "blocks" || capture_key == "connections") {
+                throw ModelException(fmt::format("model entry '{}' must be an array", capture_key));
+            }
+        }
+
+        capture.reset();
+    }
+
+    static constexpr std::array<std::string_view, 5> REQUIRED_KEYS = {"description", "output_ids", "input_ids", "connections", "blocks"};
+
+    JsonModelSink& sink;
+    Level level{Level::Document};
+    Section section{Section::Blocks};
+    std::string current_key;
+    std::optional<JsonSubtree> capture;
+    Level capture_level{Level::Document};
+    std::string capture_key;
+    std::set<std::string, std::less<>> found_keys;
+    bool found_model{false};
+};
+
+// Instantiates blocks and connections directly into the model as they are read
+class mtea::Model::JsonLoader : public JsonModelSink {
+public:
+    explicit JsonLoader(Model& model) : model(model) {}
+
+    static void load_parameters(BlockInterface& blk, const std::vector<SaveParameter>& parameters) {
+        const auto blk_params = blk.get_parameters();
+
+        for (const auto& prm : parameters) {
+            const auto it = std::ranges::find_if(blk_params, [&prm](const auto& p) { return p->get_id() == prm.id; });
+            if (it == blk_params.end()) {
+                throw mtea::ModelException("missing parameter id for provided block");
+            } else if (const auto prm_mdl = dynamic_cast<ParameterValue*>((*it).get())) {
+                prm_mdl->set_value(ModelValue::from_string(prm.value, prm.dtype));
+            } else if (const auto prm_dt = dynamic_cast<ParameterDataType*>((*it).get())) {
+                prm_dt->set_value_string(prm.value);
+            } else if (const auto prm_id = dynamic_cast<ParameterIdentifier*>((*it).get())) {
+                prm_id->set_value_string(prm.value);
+            } else {
+                throw ModelException("unknown parameter type to load into");
+            }
+        }
+    }
+
+    static std::unique_ptr<BlockInterface> create_block(const Model& m, const SaveBlock& json_blk) {
+        auto blk = m.create_saved_block(json_blk.name, json_blk.id, BlockLocation{json_blk.x, json_blk.y}, json_blk.inverted);
+        load_parameters(*blk, json_blk.parameters);
+        return blk;
+    }
+
+    static void load_block(Model& m, const SaveBlock& json_blk) { m.insert_saved_block(create_block(m, json_blk)); }
+
+    void set_description(std::string&& description) override { model.description = std::move(description); }
+
+    void set_preferred_dt(const double dt) override { model.set_preferred_dt(dt); }
+
+    void set_input_ids(std::vector<size_t>&& ids) override { model.input_ids = std::move(ids); }
+
+    void set_output_ids(std::vector<size_t>&& ids) override { model.output_ids = std::move(ids); }
+
+    void add_connection(std::shared_ptr<Connection> c) override { model.connections.add_connection(c); }
+
+    void add_block(SaveBlock&& blk) override { load_block(model, blk); }
+
+private:
+    Model& model;
+};
+
+// Holds the entries of a parsed model file until they are instantiated, so that files may be parsed in parallel, and each
+// file is only read once. Blocks are kept in their parsed form rather than as a JSON document
+class mtea::Model::JsonParsedFile : public ParsedModelFile, public JsonModelSink {
+public:
+    std::vector<std::string> get_block_names() const override {
+        std::set<std::string, std::less<>> names;
+        for (const auto& blk : blocks) {
+            names.insert(blk.name);
+        }
+        return {names.begin(), names.end()};
+    }
+
+    std::string get_description() const override { return description; }
+
+    size_t get_num_inputs() const override { return input_ids.size(); }
+
+    size_t get_num_outputs() const override { return output_ids.size(); }
+
+    void load_into(Model& m) const override {
+        JsonLoader loader(m);
+
+        loader.set_description(std::string(description));
+        if (preferred_dt.has_value()) {
+            loader.set_preferred_dt(*preferred_dt);
+        }
+        loader.set_input_ids(std::vector<size_t>(input_ids));
+        loader.set_output_ids(std::vector<size_t>(output_ids));
+
+        for (const auto& c : connections) {
+            loader.add_connection(std::make_shared<Connection>(*c));
+        }
+
+        for (const auto& blk : blocks) {
+            JsonLoader::load_block(m, blk);
+        }
+
+        m.complete_load();
+    }
+
+    void set_description(std::string&& d) override { description = std::move(d); }
+
+    void set_preferred_dt(const double dt) override { preferred_dt = dt; }
+
+    void set_input_ids(std::vector<size_t>&& ids) override { input_ids = std::move(ids); }
+
+    void set_output_ids(std::vector<size_t>&& ids) override { output_ids = std::move(ids); }
+
+    void add_connection(std::shared_ptr<Connection> c) override { connections.push_back(std::move(c)); }
+
+    void add_block(SaveBlock&& blk) override { blocks.push_back(std::move(blk)); }
+
+private:
+    std::string description;
+    std::optional<double> preferred_dt;
+    std::vector<size_t> input_ids;
+    std::vector<size_t> output_ids;
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::vector<SaveBlock> blocks;
+};
+
+std::unique_ptr<ParsedModelFile> Model::parse_file(const std::filesystem::path& path) {
+    if (ModelBinaryFormat::is_binary_path(path)) {
+        return ModelBinaryFormat::parse(path);
+    }
+
+    std::ifstream iss(path);
+    if (!iss) {
+        throw ModelException(fmt::format("unable to open file for model with '{}'", path.string()));
+    }
+
+    auto parsed = std::make_unique<JsonParsedFile>();
+
+    try {
+        JsonModelReader reader(*parsed);
+        nlohmann::json::sax_parse(iss, &reader);
+        reader.finish();
+    } catch (const nlohmann::json::exception& err) {
+        throw ModelException(fmt::format("unable to load model '{}' - {}", path.string(), err.what()));
+    }
+
+    return parsed;
+}
+
+void mtea::to_json(nlohmann::json& j, const mtea::Model& m) {
+    const auto block_offset = m.get_block_offset();
+
     j["description"] = m.description;
     j["preferred_dt"] = m.preferred_dt;
     j["output_ids"] = m.output_ids;
     j["input_ids"] = m.input_ids;
     j["connections"] = m.connections;
 
-    std::unordered_map<size_t, SaveBlock> json_blocks;
-    for (const auto& [blk_id, blk] : m.blocks) {
-        std::vector<SaveParameter> json_parameters;
-        for (const auto& p : blk->get_parameters()) {
-            json_parameters.emplace_back(p.get());
-        }
-
-        SaveBlock save_blk{
-            .id = blk->get_id(),
-            .name = blk->get_full_name(),
-            .parameters = json_parameters,
-            .x = blk->get_loc().x - block_offset->x,
-            .y = blk->get_loc().y - block_offset->y,
-            .inverted = blk->get_inverted(),
-        };
-
-        json_blocks.try_emplace(save_blk.id, save_blk);
+    // Blocks are stored in ascending ID order, so the saved block list is deterministic
+    std::vector<SaveBlock> json_blocks;
+    for (const auto& blk : m.blocks | std::views::values) {
+        json_blocks.push_back(make_save_block(*blk, block_offset));
     }
 
-    const auto v = json_blocks | std::views::values;
-    std::vector<SaveBlock> json_blocks_vec(v.begin(), v.end());
-
-    j["blocks"] = json_blocks_vec;
+    j["blocks"] = json_blocks;
 }
 
 void mtea::from_json(const nlohmann::json& j, mtea::Model& m) {
@@ -1073,60 +1437,175 @@ void mtea::from_json(const nlohmann::json& j, mtea::Model& m) {
 
     const auto json_blocks = j.at("blocks").get<std::vector<SaveBlock>>();
 
-    const auto& libmgr = mtea::ModelManager::get_instance();
-
     for (const auto& json_blk : json_blocks) {
-        const auto it = json_blk.name.find("::");
-        if (it == std::string::npos) {
-            throw mtea::ModelException(fmt::format("no library block name for name found in '{}'", json_blk.name));
-        }
+        Model::JsonLoader::load_block(m, json_blk);
+    }
 
-        const std::string lib_name = json_blk.name.substr(0, it);
-        const std::string block_name = json_blk.name.substr(it + 2);
+    m.complete_load();
+}
 
-        const auto lib = libmgr.get_library(lib_name);
-        auto blk = lib->try_create_block(block_name);
+std::unique_ptr<BlockInterface> Model::create_saved_block(const std::string_view full_name, const size_t id, const BlockLocation& loc,
+                                                          const bool inverted) const {
+    const auto it = full_name.find("::");
+    if (it == std::string_view::npos) {
+        throw mtea::ModelException(fmt::format("no library block name for name found in '{}'", full_name));
+    }
 
-        const auto modellib = dynamic_cast<mtea::ModelLibrary*>(lib);
+    const std::string lib_name(full_name.substr(0, it));
+    const std::string block_name(full_name.substr(it + 2));
 
-        if (blk == nullptr && modellib != nullptr) {
-            auto test_path = m.get_filename();
-            if (test_path.has_value()) {
-                auto pth = *test_path;
-                pth = pth.parent_path() / std::filesystem::path(block_name).replace_extension(mtea::Model::DEFAULT_MODEL_EXTENSION);
+    // Blocks are created from the libraries of the session owning the model
+    const auto lib = manager->get_library(lib_name);
+    auto blk = lib->try_create_block(block_name);
 
-                const auto mdl = modellib->load_model(pth);
-                blk = modellib->create_block(mdl.get());
-            }
+    const auto modellib = std::dynamic_pointer_cast<mtea::ModelLibrary>(lib);
+
+    if (blk == nullptr && modellib != nullptr && filename.has_value()) {
+        const auto mdl = modellib->load_model(modellib->find_submodel_path(*filename, block_name));
+        blk = modellib->create_block(mdl.get());
+    }
+
+    if (blk == nullptr) {
+        throw mtea::ModelException(fmt::format("unable to create model due to missing block '{}'", full_name));
+    }
+
+    blk->set_id(id);
+    blk->set_loc(loc);
+    blk->set_inverted(inverted);
+
+    return blk;
+}
+
+/* ==================== MODEL JOURNAL ==================== */
+
+BlockLocation Model::get_block_offset() const {
+    // Find the offset XY positions
+    std::optional<BlockLocation> block_offset = std::nullopt;
+    for (const auto& blk : blocks | std::views::values) {
+        const auto loc = blk->get_loc();
+        if (!block_offset) {
+            block_offset = loc;
+        } else {
+            block_offset->x = std::min(block_offset->x, loc.x);
+            block_offset->y = std::min(block_offset->y, loc.y);
         }
+    }
 
-        if (blk == nullptr) {
-            throw mtea::ModelException(fmt::format("unable to create model due to missing block '{}'", json_blk.name));
+    return block_offset.value_or(BlockLocation{});
+}
+
+void Model::open_journal() {
+    if (!filename.has_value() || ModelBinaryFormat::is_binary_path(*filename)) {
+        return;
+    }
+
+    // Replay any entries left from a previous session before recording new edits
+    auto recovered = ModelJournal::open(*filename);
+    const auto entries = recovered->get_entries();
+
+    for (const auto& e : entries) {
+        try {
+            apply_journal_entry(e);
+        } catch (const std::exception& err) {
+            throw ModelException(fmt::format("unable to replay journal for '{}' - {}", filename->string(), err.what()));
         }
+    }
+
+    journal_offset = BlockLocation{};
+    journal = std::move(recovered);
+
+    // Uncommitted entries are edits that were never saved
+    has_unsaved_changed = journal->get_num_committed() != entries.size();
+}
+
+void Model::apply_journal_entry(const nlohmann::json& entry) {
+    const auto op = entry.at("op").get<std::string>();
+
+    if (op == "add_block") {
+        add_block(JsonLoader::create_block(*this, entry.at("block").get<SaveBlock>()), entry.at("block").at("id").get<size_t>());
+    } else if (op == "update_block") {
+        const auto json_blk = entry.at("block").get<SaveBlock>();
+        const auto blk = get_block(json_blk.id);
 
-        blk->set_id(json_blk.id);
         blk->set_loc(BlockLocation{json_blk.x, json_blk.y});
         blk->set_inverted(json_blk.inverted);
+        JsonLoader::load_parameters(*blk, json_blk.parameters);
 
-        const auto blk_params = blk->get_parameters();
+        mark_block_changed(json_blk.id);
+    } else if (op == "remove_block") {
+        remove_block(entry.at("id").get<size_t>());
+    } else if (op == "add_connection" || op == "update_connection") {
+        const auto c = std::make_shared<Connection>(0, 0, 0, 0);
+        from_json(entry.at("connection"), *c);
 
-        for (const auto& prm : json_blk.parameters) {
-            const auto it = std::ranges::find_if(blk_params, [&prm](const auto& p) { return p->get_id() == prm.id; });
-            if (it == blk_params.end()) {
-                throw mtea::ModelException("missing parameter id for provided block");
-            } else if (const auto prm_mdl = dynamic_cast<ParameterValue*>((*it).get())) {
-                prm_mdl->set_value(ModelValue::from_string(prm.value, prm.dtype));
-            } else if (const auto prm_dt = dynamic_cast<ParameterDataType*>((*it).get())) {
-                prm_dt->set_value_string(prm.value);
-            } else {
-                throw ModelException("unknown parameter type to load into");
-            }
+        if (op == "update_connection") {
+            remove_connection(c->get_to_id(), c->get_to_port());
         }
 
-        m.blocks[blk->get_id()] = std::move(blk);
+        add_connection(c);
+    } else if (op == "remove_connection") {
+        remove_connection(entry.at("to_block").get<size_t>(), entry.at("to_port").get<size_t>());
+    } else if (op == "set_description") {
+        set_description(entry.at("value").get<std::string>());
+    } else if (op == "set_preferred_dt") {
+        set_preferred_dt(entry.at("value").get<double>());
+    } else {
+        throw ModelException(fmt::format("unknown journal operation '{}'", op));
+    }
+}
+
+void Model::record_journal_entry(nlohmann::json&& entry) const {
+    if (journal != nullptr) {
+        journal->append(std::move(entry));
+    }
+}
+
+void Model::record_block_entry(const std::string_view op, const BlockInterface& blk) const {
+    if (journal == nullptr) {
+        return;
+    }
+
+    nlohmann::json entry;
+    entry["op"] = op;
+    entry["block"] = make_save_block(blk, journal_offset);
+
+    if (dynamic_cast<const InputPort*>(&blk) != nullptr) {
+        entry["port"] = "input";
+    } else if (dynamic_cast<const OutputPort*>(&blk) != nullptr) {
+        entry["port"] = "output";
     }
 
-    m.update_block();
+    journal->append(std::move(entry));
+}
+
+void Model::insert_saved_block(std::unique_ptr<BlockInterface>&& blk) {
+    if (dynamic_cast<const ModelBlock*>(blk.get()) != nullptr) {
+        submodel_ids.insert(blk->get_id());
+    }
 
-    m.has_unsaved_changed = false;
+    const size_t blk_id = blk->get_id();
+    watch_parameters(*blk);
+    if (!blocks.try_emplace(blk_id, std::move(blk))) {
+        throw ModelException(fmt::format("duplicate block ID {} found in model", blk_id));
+    }
+}
+
+void Model::watch_parameters(const BlockInterface& blk) {
+    for (const auto& p : blk.get_parameters()) {
+        p->set_change_callback([this, id = blk.get_id()]() { mark_block_changed(id); });
+    }
+}
+
+void Model::unwatch_parameters(const BlockInterface& blk) {
+    for (const auto& p : blk.get_parameters()) {
+        p->set_change_callback(nullptr);
+    }
+}
+
+void Model::complete_load() {
+    pending_full_update = true;
+    structure_version = next_structure_version();
+    update_block();
+
+    has_unsaved_changed = false;
 }
@@ -0,0 +1,418 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "model_binary.hpp"
+
+#include "atomic_file.hpp"
+#include "mapped_file.hpp"
+#include "model.hpp"
+#include "model_exception.hpp"
+#include "model_loader.hpp"
+#include "parameter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+
+const std::string mtea::ModelBinaryFormat::FILE_EXTENSION = ".tmdb";
+
+/* ==================== FILE LAYOUT ==================== */
+
+namespace {
+
+constexpr std::array<char, 4> FILE_MAGIC = {'T', 'M', 'D', 'B'};
+constexpr uint32_t ENDIAN_TAG = 0x01020304;
+constexpr uint32_t NO_STRING = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t SECTION_ALIGNMENT = 8;
+
+enum class ParameterKind : uint8_t {
+    Value = 0,
+    DataType,
+    Identifier, // Value holds the string index of the identifier
+};
+
+struct TableRef {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct FileHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t endian_tag;
+    uint32_t description;
+    double preferred_dt;
+    TableRef strings;
+    TableRef string_data;
+    TableRef blocks;
+    TableRef parameters;
+    TableRef connections;
+    TableRef input_ids;
+    TableRef output_ids;
+};
+
+struct StringRecord {
+    uint64_t offset; // Relative to the start of the string data section
+    uint64_t size;
+};
+
+struct BlockRecord {
+    uint64_t id;
+    int64_t x;
+    int64_t y;
+    uint64_t parameter_start;
+    uint32_t parameter_count;
+    uint32_t name;
+    uint8_t inverted;
+    std::array<uint8_t, 7> padding;
+};
+
+struct ParameterRecord {
+    uint32_t id;
+    ParameterKind kind;
+    uint8_t dtype;
+    std::array<uint8_t, 2> padding;
+    std::array<uint8_t, mtea::ModelValue::RAW_VALUE_SIZE> value;
+};
+
+struct ConnectionRecord {
+    uint64_t from_id;
+    uint64_t from_port;
+    uint64_t to_id;
+    uint64_t to_port;
+    uint32_t name;
+    uint32_t padding;
+};
+
+template <typename T>
+concept FileRecord = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>;
+
+static_assert(FileRecord<FileHeader> && FileRecord<StringRecord> && FileRecord<BlockRecord> && FileRecord<ParameterRecord> &&
+              FileRecord<ConnectionRecord>);
+
+/* ==================== WRITER ==================== */
+
+class StringTable {
+public:
+    uint32_t intern(const std::string_view s) {
+        if (const auto it = index.find(std::string(s)); it != index.end()) {
+            return it->second;
+        } else if (records.size() >= NO_STRING) {
+            throw mtea::ModelException("too many unique strings to store in binary model");
+        }
+
+        const auto id = static_cast<uint32_t>(records.size());
+        records.push_back(StringRecord{.offset = data.size(), .size = s.size()});
+        data.append(s);
+        index.try_emplace(std::string(s), id);
+        return id;
+    }
+
+    const std::vector<StringRecord>& get_records() const { return records; }
+
+    const std::string& get_data() const { return data; }
+
+private:
+    std::vector<StringRecord> records;
+    std::string data;
+    std::unordered_map<std::string, uint32_t> index;
+};
+
+class FileBuffer {
+public:
+    FileBuffer() : buffer(sizeof(FileHeader)) {}
+
+    template <FileRecord T> TableRef append_table(const std::vector<T>& values) {
+        const auto offset = align();
+        buffer.resize(offset + values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(buffer.data() + offset, values.data(), values.size() * sizeof(T));
+        }
+
+        return TableRef{.offset = offset, .count = values.size()};
+    }
+
+    TableRef append_bytes(const std::string& data) {
+        const auto offset = align();
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        return TableRef{.offset = offset, .count = data.size()};
+    }
+
+    void set_header(const FileHeader& header) { std::memcpy(buffer.data(), &header, sizeof(header)); }
+
+    const std::vector<char>& get_data() const { return buffer; }
+
+private:
+    uint64_t align() {
+        buffer.resize((buffer.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT);
+        return buffer.size();
+    }
+
+    std::vector<char> buffer;
+};
+
+/* ==================== READER ==================== */
+
+// Provides checked, in-place access to the tables of a mapped binary model file
+class BinaryModelView {
+public:
+    explicit BinaryModelView(const std::span<const char> data) : data(data) {
+        if (data.size() < sizeof(FileHeader)) {
+            throw mtea::ModelException("binary model file is too small to contain a header");
+        }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (header.magic != FILE_MAGIC) {
+            throw mtea::ModelException("binary model file has an invalid file signature");
+        } else if (header.endian_tag != ENDIAN_TAG) {
+            throw mtea::ModelException("binary model file was written with a different byte order");
+        } else if (header.version != mtea::ModelBinaryFormat::FORMAT_VERSION) {
+            throw mtea::ModelException(fmt::format("unsupported binary model version {}", header.version));
+        }
+
+        check_table(header.strings, sizeof(StringRecord));
+        check_table(header.string_data, 1);
+        check_table(header.blocks, sizeof(BlockRecord));
+        check_table(header.parameters, sizeof(ParameterRecord));
+        check_table(header.connections, sizeof(ConnectionRecord));
+        check_table(header.input_ids, sizeof(uint64_t));
+        check_table(header.output_ids, sizeof(uint64_t));
+    }
+
+    const FileHeader& get_header() const { return header; }
+
+    template <FileRecord T> T record(const TableRef& table, const uint64_t i) const {
+        if (i >= table.count) {
+            throw mtea::ModelException("binary model record index out of range");
+        }
+
+        T value;
+        std::memcpy(&value, data.data() + table.offset + i * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    std::string_view string(const uint32_t id) const {
+        const auto rec = record<StringRecord>(header.strings, id);
+        if (rec.offset > header.string_data.count || rec.size > header.string_data.count - rec.offset) {
+            throw mtea::ModelException("binary model string out of range");
+        }
+
+        return {data.data() + header.string_data.offset + rec.offset, rec.size};
+    }
+
+    std::vector<size_t> id_list(const TableRef& table) const {
+        std::vector<size_t> ids;
+        ids.reserve(table.count);
+        for (uint64_t i = 0; i < table.count; ++i) {
+            ids.push_back(record<uint64_t>(table, i));
+        }
+        return ids;
+    }
+
+private:
+    void check_table(const TableRef& table, const uint64_t record_size) const {
+        if (table.offset > data.size() || table.count > (data.size() - table.offset) / record_size) {
+            throw mtea::ModelException("binary model table extends past the end of the file");
+        }
+    }
+
+    std::span<const char> data;
+    FileHeader header;
+};
+
+}
+
+/* ==================== BINARY FORMAT ==================== */
+
+bool mtea::ModelBinaryFormat::is_binary_path(const std::filesystem::path& path) { return path.extension() == FILE_EXTENSION; }
+
+void mtea::ModelBinaryFormat::write(const Model& model, const std::filesystem::path& path) {
+    // Find the offset XY positions, matching the JSON model format
+    std::optional<BlockLocation> block_offset = std::nullopt;
+    for (const auto& blk : model.blocks | std::views::values) {
+        const auto loc = blk->get_loc();
+        if (!block_offset) {
+            block_offset = loc;
+        } else {
+            block_offset->x = std::min(block_offset->x, loc.x);
+            block_offset->y = std::min(block_offset->y, loc.y);
+        }
+    }
+
+    if (!block_offset) {
+        block_offset.emplace();
+    }
+
+    StringTable strings;
+
+    std::vector<BlockRecord> blocks;
+    std::vector<ParameterRecord> parameters;
+    for (const auto& blk : model.blocks | std::views::values) {
+        BlockRecord blk_rec{};
+        blk_rec.id = blk->get_id();
+        blk_rec.x = blk->get_loc().x - block_offset->x;
+        blk_rec.y = blk->get_loc().y - block_offset->y;
+        blk_rec.parameter_start = parameters.size();
+        blk_rec.name = strings.intern(blk->get_full_symbol().str());
+        blk_rec.inverted = blk->get_inverted() ? 1 : 0;
+
+        for (const auto& p : blk->get_parameters()) {
+            ParameterRecord prm_rec{};
+            prm_rec.id = strings.intern(p->get_id());
+
+            if (const auto prm_mdl = dynamic_cast<const ParameterValue*>(p.get())) {
+                prm_rec.kind = ParameterKind::Value;
+                prm_rec.dtype = static_cast<uint8_t>(prm_mdl->get_value()->data_type());
+                ModelValue::to_raw(prm_mdl->get_value(), prm_rec.value.data());
+            } else if (const auto prm_dt = dynamic_cast<const ParameterDataType*>(p.get())) {
+                prm_rec.kind = ParameterKind::DataType;
+                prm_rec.dtype = static_cast<uint8_t>(prm_dt->get_type());
+            } else if (const auto prm_id = dynamic_cast<const ParameterIdentifier*>(p.get())) {
+                const auto str_id = strings.intern(prm_id->get_value_string());
+                prm_rec.kind = ParameterKind::Identifier;
+                std::memcpy(prm_rec.value.data(), &str_id, sizeof(str_id));
+            } else {
+                throw ModelException("unknown save parameter type provided");
+            }
+
+            parameters.push_back(prm_rec);
+            blk_rec.parameter_count += 1;
+        }
+
+        blocks.push_back(blk_rec);
+    }
+
+    std::vector<ConnectionRecord> connections;
+    for (const auto& c : model.connections.get_connections()) {
+        ConnectionRecord conn_rec{};
+        conn_rec.from_id = c->get_from_id();
+        conn_rec.from_port = c->get_from_port();
+        conn_rec.to_id = c->get_to_id();
+        conn_rec.to_port = c->get_to_port();
+        conn_rec.name = c->get_name().has_value() ? strings.intern(c->get_name()->get()) : NO_STRING;
+        connections.push_back(conn_rec);
+    }
+
+    const std::vector<uint64_t> input_ids(model.input_ids.begin(), model.input_ids.end());
+    const std::vector<uint64_t> output_ids(model.output_ids.begin(), model.output_ids.end());
+
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FORMAT_VERSION;
+    header.endian_tag = ENDIAN_TAG;
+    header.description = strings.intern(model.description);
+    header.preferred_dt = model.preferred_dt;
+
+    FileBuffer buffer;
+    header.blocks = buffer.append_table(blocks);
+    header.parameters = buffer.append_table(parameters);
+    header.connections = buffer.append_table(connections);
+    header.input_ids = buffer.append_table(input_ids);
+    header.output_ids = buffer.append_table(output_ids);
+    header.strings = buffer.append_table(strings.get_records());
+    header.string_data = buffer.append_bytes(strings.get_data());
+    buffer.set_header(header);
+
+    // The previous file may still be mapped by a parsed model, and so is replaced rather than truncated in place
+    write_file_atomic(path, [&buffer](std::ostream& os) {
+        os.write(buffer.get_data().data(), static_cast<std::streamsize>(buffer.get_data().size()));
+    });
+}
+
+// Keeps the model file mapped until its blocks are instantiated, so that files may be parsed in parallel
+class mtea::ModelBinaryFormat::ParsedFile : public ParsedModelFile {
+public:
+    explicit ParsedFile(const std::filesystem::path& path) : file(path), view(file.get_data()) {}
+
+    std::vector<std::string> get_block_names() const override {
+        std::vector<std::string> names;
+        for (uint64_t i = 0; i < view.get_header().blocks.count; ++i) {
+            names.emplace_back(view.string(view.record<BlockRecord>(view.get_header().blocks, i).name));
+        }
+        return names;
+    }
+
+    std::string get_description() const override { return std::string(view.string(view.get_header().description)); }
+
+    size_t get_num_inputs() const override { return static_cast<size_t>(view.get_header().input_ids.count); }
+
+    size_t get_num_outputs() const override { return static_cast<size_t>(view.get_header().output_ids.count); }
+
+    void load_into(Model& model) const override {
+        const auto& header = view.get_header();
+
+        model.description = view.string(header.description);
+        model.set_preferred_dt(header.preferred_dt);
+        model.input_ids = view.id_list(header.input_ids);
+        model.output_ids = view.id_list(header.output_ids);
+
+        for (uint64_t i = 0; i < header.connections.count; ++i) {
+            const auto conn_rec = view.record<ConnectionRecord>(header.connections, i);
+
+            const auto c = std::make_shared<Connection>(conn_rec.from_id, conn_rec.from_port, conn_rec.to_id, conn_rec.to_port);
+            if (conn_rec.name != NO_STRING) {
+                c->set_name(view.string(conn_rec.name));
+            }
+
+            model.connections.add_connection(c);
+        }
+
+        // Blocks are instantiated directly from their mapped records, without an intermediate parsed representation
+        for (uint64_t i = 0; i < header.blocks.count; ++i) {
+            const auto blk_rec = view.record<BlockRecord>(header.blocks, i);
+
+            auto blk =
+                model.create_saved_block(view.string(blk_rec.name), blk_rec.id, BlockLocation{blk_rec.x, blk_rec.y}, blk_rec.inverted != 0);
+            const auto blk_params = blk->get_parameters();
+
+            for (uint64_t j = 0; j < blk_rec.parameter_count; ++j) {
+                const auto prm_rec = view.record<ParameterRecord>(header.parameters, blk_rec.parameter_start + j);
+                const auto prm_id = view.string(prm_rec.id);
+                const auto dtype = static_cast<DataType>(prm_rec.dtype);
+
+                const auto it = std::ranges::find_if(blk_params, [&prm_id](const auto& p) { return p->get_id() == prm_id; });
+                if (it == blk_params.end()) {
+                    throw ModelException("missing parameter id for provided block");
+                } else if (const auto prm_mdl = dynamic_cast<ParameterValue*>((*it).get()); prm_mdl && prm_rec.kind == ParameterKind::Value) {
+                    prm_mdl->set_value(ModelValue::from_raw(prm_rec.value.data(), dtype));
+                } else if (const auto prm_dt = dynamic_cast<ParameterDataType*>((*it).get());
+                           prm_dt && prm_rec.kind == ParameterKind::DataType) {
+                    if (dtype != DataType::NONE && mtea::get_meta_type(dtype) == nullptr) {
+                        throw ModelException(fmt::format("unknown data type {} provided", prm_rec.dtype));
+                    }
+
+                    prm_dt->set_type(dtype);
+                } else if (const auto prm_id = dynamic_cast<ParameterIdentifier*>((*it).get());
+                           prm_id && prm_rec.kind == ParameterKind::Identifier) {
+                    uint32_t str_id;
+                    std::memcpy(&str_id, prm_rec.value.data(), sizeof(str_id));
+                    prm_id->set_value_string(view.string(str_id));
+                } else {
+                    throw ModelException("unknown parameter type to load into");
+                }
+            }
+
+            model.insert_saved_block(std::move(blk));
+        }
+
+        model.complete_load();
+    }
+
+private:
+    const MappedFile file;
+    const BinaryModelView view;
+};
+
+std::unique_ptr<mtea::ParsedModelFile> mtea::ModelBinaryFormat::parse(const std::filesystem::path& path) {
+    return std::make_unique<ParsedFile>(path);
+}
@@ -104,6 +104,11 @@ struct CompiledModelBlock : public mtea::CompiledBlockInterface {
         return _model->get_execution_interface(_id, connections, manager, _state);
     }
 
+    void add_to_artifact(const mtea::ConnectionManager& connections, const mtea::ExecutionArtifact::SlotMap& slots,
+                         mtea::ExecutionArtifact& artifact) const override {
+        _model->add_to_artifact(_id, connections, slots, _state, artifact);
+    }
+
     std::vector<std::unique_ptr<mtea::codegen::CodeComponent>> get_codegen_other() const override {
         return _model->get_all_sub_components(_state);
     }
@@ -113,7 +118,7 @@ struct CompiledModelBlock : public mtea::CompiledBlockInterface {
 private:
     const size_t _id;
     std::shared_ptr<const mtea::Model> _model;
-    const mtea::BlockInterface::ModelInfo& _state;
+    const mtea::BlockInterface::ModelInfo _state;
 };
 
 std::unique_ptr<mtea::CompiledBlockInterface> mtea::ModelBlock::get_compiled(const BlockInterface::ModelInfo& s) const {
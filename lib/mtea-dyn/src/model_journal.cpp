@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "model_journal.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "atomic_file.hpp"
+#include "execution_artifact.hpp"
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
+const std::string mtea::ModelJournal::FILE_EXTENSION = ".journal";
+
+static const std::string COMMIT_OP = "commit";
+
+static std::filesystem::path with_suffix(const std::filesystem::path& path, const std::string_view suffix) {
+    auto result = path;
+    result += suffix;
+    return result;
+}
+
+static uint64_t hash_file(const std::filesystem::path& path) { return mtea::ExecutionArtifact::hash_sources({path}); }
+
+// Reads a journal file, returning the entries and committed entry count if it applies to the provided model file hash
+static std::optional<std::pair<std::vector<nlohmann::json>, size_t>> read_journal(const std::filesystem::path& path,
+                                                                                  const uint64_t base_hash) {
+    std::ifstream iss(path);
+    std::string line;
+
+    if (!iss || !std::getline(iss, line)) {
+        return std::nullopt;
+    }
+
+    try {
+        const auto header = nlohmann::json::parse(line);
+        if (header.at("journal").get<uint32_t>() != mtea::ModelJournal::FORMAT_VERSION || header.at("base_hash").get<uint64_t>() != base_hash) {
+            return std::nullopt;
+        }
+    } catch (const nlohmann::json::exception&) {
+        return std::nullopt;
+    }
+
+    std::vector<nlohmann::json> entries;
+    size_t committed = 0;
+
+    while (std::getline(iss, line)) {
+        // A partially written final line is expected if the application stopped while appending
+        const auto entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_discarded()) {
+            break;
+        }
+
+        if (entry.value("op", "") == COMMIT_OP) {
+            committed = entries.size();
+        } else {
+            entries.push_back(entry);
+        }
+    }
+
+    return std::make_pair(std::move(entries), committed);
+}
+
+static auto find_block(nlohmann::json& blocks, const size_t id) {
+    return std::ranges::find_if(blocks, [id](const nlohmann::json& b) { return b.at("id").get<size_t>() == id; });
+}
+
+static void erase_id(nlohmann::json& ids, const size_t id) {
+    if (const auto it = std::ranges::find(ids, nlohmann::json(id)); it != ids.end()) {
+        ids.erase(it);
+    }
+}
+
+/* ==================== MODEL JOURNAL ==================== */
+
+mtea::ModelJournal::ModelJournal(const std::filesystem::path& model_path, const uint64_t base_hash, std::vector<nlohmann::json>&& entries,
+                                 const size_t committed)
+    : model_path(model_path), base_hash(base_hash), entries(std::move(entries)), committed(committed) {
+    reopen_stream();
+    worker = std::thread([this]() { run(); });
+}
+
+mtea::ModelJournal::~ModelJournal() {
+    // Edits that were never saved are dropped, while committed entries are kept for the next load
+    try {
+        discard_uncommitted();
+    } catch (const ModelException&) {
+        // Entries that cannot be discarded are recovered as unsaved changes on the next load
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    cv.notify_all();
+    worker.join();
+}
+
+const std::filesystem::path& mtea::ModelJournal::get_model_path() const { return model_path; }
+
+std::vector<nlohmann::json> mtea::ModelJournal::get_entries() const {
+    std::lock_guard lock(mutex);
+    return entries;
+}
+
+size_t mtea::ModelJournal::get_num_committed() const {
+    std::lock_guard lock(mutex);
+    return committed;
+}
+
+std::optional<std::string> mtea::ModelJournal::get_last_error() const {
+    std::lock_guard lock(mutex);
+    return last_error;
+}
+
+void mtea::ModelJournal::append(nlohmann::json&& entry) {
+    std::lock_guard lock(mutex);
+    stream << entry.dump() << '\n' << std::flush;
+    entries.push_back(std::move(entry));
+}
+
+void mtea::ModelJournal::commit() {
+    {
+        std::lock_guard lock(mutex);
+        if (committed == entries.size()) {
+            return;
+        }
+
+        stream << nlohmann::json{{"op", COMMIT_OP}}.dump() << '\n' << std::flush;
+        committed = entries.size();
+        compact_requested = true;
+    }
+
+    cv.notify_all();
+}
+
+void mtea::ModelJournal::discard_uncommitted() {
+    std::lock_guard lock(mutex);
+    if (committed == entries.size()) {
+        return;
+    }
+
+    entries.resize(committed);
+
+    stream.close();
+    write_journal(get_journal_path(model_path), base_hash, entries, committed);
+    reopen_stream();
+}
+
+void mtea::ModelJournal::wait_idle() {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [this]() { return !compact_requested && !compacting; });
+}
+
+std::shared_ptr<mtea::ModelJournal> mtea::ModelJournal::create(const std::filesystem::path& model_path) {
+    std::filesystem::remove(with_suffix(get_journal_path(model_path), ".next"));
+
+    const auto base_hash = hash_file(model_path);
+    write_journal(get_journal_path(model_path), base_hash, {}, 0);
+
+    return std::shared_ptr<ModelJournal>(new ModelJournal(model_path, base_hash, {}, 0));
+}
+
+std::shared_ptr<mtea::ModelJournal> mtea::ModelJournal::open(const std::filesystem::path& model_path) {
+    const auto journal_path = get_journal_path(model_path);
+    const auto next_path = with_suffix(journal_path, ".next");
+    const auto base_hash = hash_file(model_path);
+
+    // A pending journal only applies if compaction stopped after the model file was replaced
+    if (auto next = read_journal(next_path, base_hash)) {
+        std::filesystem::rename(next_path, journal_path);
+        return std::shared_ptr<ModelJournal>(new ModelJournal(model_path, base_hash, std::move(next->first), next->second));
+    } else if (auto current = read_journal(journal_path, base_hash)) {
+        std::filesystem::remove(next_path);
+        return std::shared_ptr<ModelJournal>(new ModelJournal(model_path, base_hash, std::move(current->first), current->second));
+    } else {
+        return create(model_path);
+    }
+}
+
+void mtea::ModelJournal::remove(const std::filesystem::path& model_path) {
+    const auto journal_path = get_journal_path(model_path);
+    std::filesystem::remove(journal_path);
+    std::filesystem::remove(with_suffix(journal_path, ".next"));
+}
+
+std::filesystem::path mtea::ModelJournal::get_journal_path(const std::filesystem::path& model_path) {
+    return with_suffix(model_path, FILE_EXTENSION);
+}
+
+void mtea::ModelJournal::apply(nlohmann::json& model, const nlohmann::json& entry) {
+    const auto op = entry.at("op").get<std::string>();
+    auto& blocks = model.at("blocks");
+    auto& connections = model.at("connections");
+
+    const auto matches_input = [](const nlohmann::json& c, const size_t to_block, const size_t to_port) {
+        return c.at("to_block").get<size_t>() == to_block && c.at("to_port").get<size_t>() == to_port;
+    };
+
+    if (op == "add_block") {
+        const auto& blk = entry.at("block");
+        const auto id = blk.at("id").get<size_t>();
+
+        // Keep the block list in ascending ID order, to match a full save
+        const auto it = std::ranges::find_if(blocks, [id](const nlohmann::json& b) { return b.at("id").get<size_t>() > id; });
+        blocks.insert(it, blk);
+
+        if (const auto port = entry.value("port", ""); port == "input") {
+            model.at("input_ids").push_back(id);
+        } else if (port == "output") {
+            model.at("output_ids").push_back(id);
+        }
+    } else if (op == "update_block") {
+        const auto& blk = entry.at("block");
+        if (const auto it = find_block(blocks, blk.at("id").get<size_t>()); it != blocks.end()) {
+            *it = blk;
+        } else {
+            throw ModelException(fmt::format("journal updates missing block {}", blk.at("id").get<size_t>()));
+        }
+    } else if (op == "remove_block") {
+        const auto id = entry.at("id").get<size_t>();
+        if (const auto it = find_block(blocks, id); it != blocks.end()) {
+            blocks.erase(it);
+        }
+
+        erase_id(model.at("input_ids"), id);
+        erase_id(model.at("output_ids"), id);
+
+        std::erase_if(connections.get_ref<nlohmann::json::array_t&>(), [id](const nlohmann::json& c) {
+            return c.at("from_block").get<size_t>() == id || c.at("to_block").get<size_t>() == id;
+        });
+    } else if (op == "add_connection") {
+        connections.push_back(entry.at("connection"));
+    } else if (op == "update_connection") {
+        const auto& conn = entry.at("connection");
+        const auto to_block = conn.at("to_block").get<size_t>();
+        const auto to_port = conn.at("to_port").get<size_t>();
+
+        for (auto& c : connections) {
+            if (matches_input(c, to_block, to_port)) {
+                c = conn;
+            }
+        }
+    } else if (op == "remove_connection") {
+        const auto to_block = entry.at("to_block").get<size_t>();
+        const auto to_port = entry.at("to_port").get<size_t>();
+
+        std::erase_if(connections.get_ref<nlohmann::json::array_t&>(),
+                      [&](const nlohmann::json& c) { return matches_input(c, to_block, to_port); });
+    } else if (op == "set_description") {
+        model["description"] = entry.at("value");
+    } else if (op == "set_preferred_dt") {
+        model["preferred_dt"] = entry.at("value");
+    } else {
+        throw ModelException(fmt::format("unknown journal operation '{}'", op));
+    }
+}
+
+void mtea::ModelJournal::write_journal(const std::filesystem::path& path, const uint64_t base_hash,
+                                       const std::vector<nlohmann::json>& entries, const size_t committed) {
+    write_file_atomic(path, [&](std::ostream& os) {
+        os << nlohmann::json{{"journal", FORMAT_VERSION}, {"base_hash", base_hash}}.dump() << '\n';
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            os << entries[i].dump() << '\n';
+
+            if (i + 1 == committed) {
+                os << nlohmann::json{{"op", COMMIT_OP}}.dump() << '\n';
+            }
+        }
+    });
+}
+
+void mtea::ModelJournal::reopen_stream() {
+    stream = std::ofstream(get_journal_path(model_path), std::ios::app);
+    if (!stream) {
+        throw ModelException(fmt::format("unable to open journal for '{}'", model_path.string()));
+    }
+}
+
+void mtea::ModelJournal::run() {
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [this]() { return stopping || compact_requested; });
+
+            if (!compact_requested) {
+                return;
+            }
+
+            compact_requested = false;
+            compacting = true;
+        }
+
+        try {
+            compact();
+        } catch (const std::exception& err) {
+            // The journal is left in place, so that no edits are lost if compaction fails
+            std::lock_guard lock(mutex);
+            last_error = err.what();
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            compacting = false;
+        }
+
+        cv.notify_all();
+    }
+}
+
+void mtea::ModelJournal::compact() {
+    // Take the committed entries, leaving the journal open for further edits while the model file is rewritten
+    std::vector<nlohmann::json> batch;
+    {
+        std::lock_guard lock(mutex);
+        batch.assign(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(committed));
+    }
+
+    if (batch.empty()) {
+        return;
+    }
+
+    nlohmann::json j;
+    {
+        std::ifstream iss(model_path);
+        if (!iss) {
+            throw ModelException(fmt::format("unable to open model '{}' for compaction", model_path.string()));
+        }
+
+        j = nlohmann::json::parse(iss);
+    }
+
+    for (const auto& e : batch) {
+        apply(j.at("model"), e);
+    }
+
+    const auto tmp_path = with_suffix(model_path, ".compact");
+    write_file_atomic(tmp_path, [&j](std::ostream& os) { os << std::setw(4) << j; });
+    const auto new_hash = hash_file(tmp_path);
+
+    // Write the remaining entries against the new model file before replacing it, so that a journal always matches the
+    // model file on disk
+    std::lock_guard lock(mutex);
+
+    const std::vector<nlohmann::json> remaining(entries.begin() + static_cast<std::ptrdiff_t>(batch.size()), entries.end());
+    const size_t remaining_committed = committed - batch.size();
+
+    const auto journal_path = get_journal_path(model_path);
+    const auto next_path = with_suffix(journal_path, ".next");
+
+    write_journal(next_path, new_hash, remaining, remaining_committed);
+    std::filesystem::rename(tmp_path, model_path);
+
+    entries = remaining;
+    committed = remaining_committed;
+    base_hash = new_hash;
+
+    stream.close();
+    std::filesystem::rename(next_path, journal_path);
+    reopen_stream();
+
+    last_error.reset();
+}
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "model_loader.hpp"
+
+#include "library_model.hpp"
+#include "model.hpp"
+#include "model_binary.hpp"
+#include "model_exception.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <fmt/format.h>
+
+namespace {
+
+struct ModelNode {
+    enum class State {
+        Pending,
+        Loading,
+        Loaded,
+    };
+
+    std::filesystem::path path;
+    std::future<std::unique_ptr<mtea::ParsedModelFile>> parsed_future;
+    std::unique_ptr<mtea::ParsedModelFile> parsed;
+    std::vector<ModelNode*> dependencies;
+    std::shared_ptr<mtea::Model> model;
+    State state{State::Pending};
+    bool queued{false};
+};
+
+}
+
+/* ==================== MODEL LOADER ==================== */
+
+mtea::ModelLoader::ModelLoader(ModelLibrary& library, const size_t num_threads)
+    : library(library), num_threads(num_threads > 0 ? num_threads : std::max<size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+std::shared_ptr<mtea::Model> mtea::ModelLoader::load(const std::filesystem::path& path) {
+    mtea::ThreadPool pool(num_threads);
+
+    // Submodel files are deduplicated by path, so that each file is only parsed once
+    std::map<std::filesystem::path, std::unique_ptr<ModelNode>> nodes;
+    std::deque<ModelNode*> unscanned;
+
+    const auto submit_node = [&nodes, &pool](const std::filesystem::path& p) {
+        const auto key = std::filesystem::weakly_canonical(p);
+        if (const auto it = nodes.find(key); it != nodes.end()) {
+            return it->second.get();
+        }
+
+        auto node = std::make_unique<ModelNode>();
+        node->path = p;
+        node->parsed_future = pool.submit([p]() { return Model::parse_file(p); });
+
+        auto* ptr = node.get();
+        nodes.emplace(key, std::move(node));
+        return ptr;
+    };
+
+    const auto add_node = [&submit_node, &unscanned](const std::filesystem::path& p) {
+        auto* node = submit_node(p);
+        if (!node->queued) {
+            node->queued = true;
+            unscanned.push_back(node);
+        }
+        return node;
+    };
+
+    // Start parsing the whole closure known to the workspace index up front, rather than waiting for each parent file to be parsed.
+    // Prefetched files are only used once they are found to be referenced, so a stale index cannot change what is loaded
+    if (const auto index = library.get_workspace_index(); index != nullptr) {
+        for (const auto& p : index->get_load_closure(path)) {
+            if (library.try_get_model(p.stem().string()) == nullptr) {
+                submit_node(p);
+            }
+        }
+    }
+
+    auto* root = add_node(path);
+
+    // Scan the dependency closure, queueing each newly found submodel file for parsing as soon as its parent is parsed
+    const auto prefix = fmt::format("{}::", library.get_library_name());
+    while (!unscanned.empty()) {
+        auto* node = unscanned.front();
+        unscanned.pop_front();
+
+        node->parsed = node->parsed_future.get();
+
+        for (const auto& blk_name : node->parsed->get_block_names()) {
+            if (!blk_name.starts_with(prefix)) {
+                continue;
+            }
+
+            const auto mdl_name = std::string_view(blk_name).substr(prefix.size());
+            if (library.try_get_model(mdl_name) != nullptr) {
+                continue;
+            }
+
+            auto* dep = add_node(library.find_submodel_path(node->path, mdl_name));
+            if (std::ranges::find(node->dependencies, dep) == node->dependencies.end()) {
+                node->dependencies.push_back(dep);
+            }
+        }
+    }
+
+    // Instantiate the models serially with dependencies first, as block creation reads from the library and updates
+    // shared submodels
+    const std::function<void(ModelNode*)> instantiate = [this, &instantiate](ModelNode* node) {
+        if (node->state == ModelNode::State::Loaded) {
+            return;
+        } else if (node->state == ModelNode::State::Loading) {
+            throw ModelException(fmt::format("cannot have recursive model with file '{}'", node->path.string()));
+        }
+
+        node->state = ModelNode::State::Loading;
+
+        for (auto* dep : node->dependencies) {
+            instantiate(dep);
+        }
+
+        const auto mdl = std::make_shared<Model>(library.get_manager());
+        mdl->set_filename(node->path);
+
+        if (library.try_get_model(mdl->get_name()) != nullptr) {
+            throw ModelException(fmt::format("library already exists a model with the name '{}'", mdl->get_name()));
+        }
+
+        node->parsed->load_into(*mdl);
+        node->parsed.reset();
+
+        mdl->open_journal();
+
+        node->model = library.add_model(mdl);
+        node->state = ModelNode::State::Loaded;
+    };
+
+    instantiate(root);
+    return root->model;
+}
+
+std::filesystem::path mtea::ModelLoader::find_submodel_path(const std::filesystem::path& parent, const std::string_view name) {
+    // Prefer a submodel saved in the same format as the parent, falling back to the other supported format
+    auto pth = parent.parent_path() / std::filesystem::path(name).replace_extension(parent.extension());
+    if (!std::filesystem::exists(pth)) {
+        const auto& alt_ext = ModelBinaryFormat::is_binary_path(parent) ? Model::DEFAULT_MODEL_EXTENSION : ModelBinaryFormat::FILE_EXTENSION;
+        if (const auto alt_pth = std::filesystem::path(pth).replace_extension(alt_ext); std::filesystem::exists(alt_pth)) {
+            pth = alt_pth;
+        }
+    }
+
+    return pth;
+}
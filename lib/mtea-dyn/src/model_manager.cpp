@@ -7,6 +7,7 @@
 #include <fmt/format.h>
 
 #include "library_stdlib.hpp"
+#include "mapped_data_dictionary.hpp"
 #include "model_exception.hpp"
 
 mtea::ModelManager& mtea::ModelManager::get_instance() {
@@ -15,38 +16,48 @@ mtea::ModelManager& mtea::ModelManager::get_instance() {
 }
 
 mtea::ModelManager::ModelManager() {
-    register_library("stdlib", std::make_unique<mtea::blocks::StandardLibrary>());
-    model_library = register_library_type("models", std::make_unique<ModelLibrary>());
+    tunable_parameters = std::make_shared<TunableParameters>([this](const Identifier& name) { return get_dictionary_value(name.get()); });
+    register_library("stdlib", std::make_unique<mtea::blocks::StandardLibrary>(tunable_parameters));
+    model_library = register_library_type("models", std::make_unique<ModelLibrary>(*this));
 }
 
 mtea::LibraryBase* mtea::ModelManager::register_library(std::string_view name, std::unique_ptr<LibraryBase>&& library) {
     return register_library_type(name, std::move(library));
 }
 
-std::unique_ptr<mtea::LibraryBase> mtea::ModelManager::deregister_library(std::string_view name) {
-    const auto it = libraries.find(std::string(name));
-    if (it == libraries.end()) {
+std::shared_ptr<mtea::LibraryBase> mtea::ModelManager::deregister_library(std::string_view name) {
+    std::lock_guard lock(write_mutex);
+    auto updated = std::make_shared<library_map_t>(*libraries.load());
+
+    const auto sym = SymbolTable::get_instance().find(name);
+    const auto it = sym.has_value() ? updated->find(*sym) : updated->end();
+    if (it == updated->end()) {
         throw ModelException("library name does not exist in manager");
     }
 
     auto ptr = std::move(it->second);
-    libraries.erase(it);
+    updated->erase(it);
+    libraries.store(std::move(updated));
     return ptr;
 }
 
-mtea::LibraryBase* mtea::ModelManager::get_library(std::string_view name) const {
-    const auto it = libraries.find(std::string(name));
-    if (it == libraries.end()) {
+std::shared_ptr<mtea::LibraryBase> mtea::ModelManager::get_library(std::string_view name) const {
+    const auto libs = libraries.load();
+
+    // Names that were never interned cannot match a library, and so are not added to the symbol table
+    const auto sym = SymbolTable::get_instance().find(name);
+    const auto it = sym.has_value() ? libs->find(*sym) : libs->end();
+    if (it == libs->end()) {
         throw ModelException("library name does not exists in manager");
     } else {
-        return it->second.get();
+        return it->second;
     }
 }
 
 std::vector<std::string> mtea::ModelManager::get_library_names() const {
     std::vector<std::string> names;
-    for (const auto& k : libraries | std::views::keys) {
-        names.push_back(k);
+    for (const auto& k : *libraries.load() | std::views::keys) {
+        names.push_back(k.str());
     }
     std::ranges::sort(names);
     return names;
@@ -60,19 +71,17 @@ std::unique_ptr<mtea::BlockInterface> mtea::ModelManager::create_block(std::stri
     }
 }
 std::unique_ptr<mtea::BlockInterface> mtea::ModelManager::try_create_block(std::string_view name) const {
-    const std::string SCOPE_SYMBOL = "::";
-
-    const auto it = name.find(SCOPE_SYMBOL);
+    const auto it = name.find(SymbolTable::SCOPE_SEPARATOR);
     if (it != std::string::npos) {
         const auto lib_name = name.substr(0, it);
-        const auto block_name = name.substr(it + SCOPE_SYMBOL.size());
+        const auto block_name = name.substr(it + SymbolTable::SCOPE_SEPARATOR.size());
 
         const auto lib = get_library(lib_name);
         if (lib) {
             return lib->create_block(block_name);
         }
     } else {
-        for (const auto& lib : libraries | std::views::values) {
+        for (const auto& lib : *libraries.load() | std::views::values) {
             if (lib->has_block(name)) {
                 return lib->create_block(name);
             }
@@ -87,25 +96,66 @@ bool mtea::ModelManager::has_block(std::string_view name) const { return try_cre
 mtea::ModelLibrary* mtea::ModelManager::default_model_library() const { return model_library; }
 
 void mtea::ModelManager::dict_register(std::string_view name, std::unique_ptr<DataDictionary>&& data) {
-    if (auto it = dictionaries.find(std::string(name)); it != dictionaries.end()) {
+    const Symbol sym(name);
+
+    std::lock_guard lock(write_mutex);
+    auto updated = std::make_shared<dictionary_map_t>(*dictionaries.load());
+
+    if (auto it = updated->find(sym); it != updated->end()) {
         throw ModelException("data name already exists in manager");
-    } else {
-        dictionaries.emplace(std::make_pair(name, std::move(data)));
     }
+
+    updated->emplace(std::make_pair(sym, std::shared_ptr<DataDictionary>(std::move(data))));
+    dictionaries.store(std::move(updated));
 }
 
 void mtea::ModelManager::dict_close(std::string_view name) {
-    if (auto it = dictionaries.find(std::string(name)); it != dictionaries.end()) {
-        dictionaries.erase(it);
+    std::lock_guard lock(write_mutex);
+    auto updated = std::make_shared<dictionary_map_t>(*dictionaries.load());
+
+    const auto sym = SymbolTable::get_instance().find(name);
+    if (auto it = sym.has_value() ? updated->find(*sym) : updated->end(); it != updated->end()) {
+        updated->erase(it);
+        dictionaries.store(std::move(updated));
     } else {
         throw ModelException("data name does not exists in manager");
     }
 }
 
-mtea::DataDictionary* mtea::ModelManager::get_data(std::string_view name) const {
-    if (const auto it = dictionaries.find(std::string(name)); it != dictionaries.end()) {
-        return it->second.get();
+std::shared_ptr<mtea::DataDictionary> mtea::ModelManager::get_data(std::string_view name) const {
+    const auto dicts = dictionaries.load();
+
+    const auto sym = SymbolTable::get_instance().find(name);
+    if (const auto it = sym.has_value() ? dicts->find(*sym) : dicts->end(); it != dicts->end()) {
+        return it->second;
     } else {
         throw ModelException("data name does not exists in manager");
     }
 }
+
+std::shared_ptr<const mtea::ModelValue> mtea::ModelManager::get_dictionary_value(std::string_view name) const {
+    const auto dicts = dictionaries.load();
+
+    // Search the dictionaries in name order, so that the result does not depend on registration order
+    std::vector<Symbol> dict_names;
+    for (const auto& k : *dicts | std::views::keys) {
+        dict_names.push_back(k);
+    }
+    std::ranges::sort(dict_names, Symbol::Less{});
+
+    const Identifier ident(name);
+    for (const auto& dn : dict_names) {
+        const auto& dict = dicts->at(dn);
+        if (const auto val = dict->get_value(ident)) {
+            // Share ownership of the dictionary, so the value outlives the dictionary being closed
+            return std::shared_ptr<const ModelValue>(dict, val);
+        } else if (const auto e = dict->get_mapped() != nullptr ? dict->get_mapped()->find(name) : std::nullopt; e && !e->is_array) {
+            // Mapped entries are copied rather than held in the dictionary, so that looking them up never changes it
+            return e->to_value();
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<mtea::TunableParameters> mtea::ModelManager::get_tunable_parameters() const { return tunable_parameters; }
@@ -18,13 +18,24 @@ bool mtea::Parameter::get_enabled() const { return enabled; }
 
 void mtea::Parameter::set_enabled(const bool v) { enabled = v; }
 
+void mtea::Parameter::set_change_callback(std::function<void()> callback) { change_callback = std::move(callback); }
+
+void mtea::Parameter::notify_changed() const {
+    if (change_callback) {
+        change_callback();
+    }
+}
+
 mtea::ParameterDataType::ParameterDataType(std::string_view id, std::string_view name, DataType val)
     : mtea::Parameter(id, name), value{val} {}
 
 mtea::DataType& mtea::ParameterDataType::get_type() { return value; }
 const mtea::DataType& mtea::ParameterDataType::get_type() const { return value; }
 
-void mtea::ParameterDataType::set_type(const DataType& val) { value = val; }
+void mtea::ParameterDataType::set_type(const DataType& val) {
+    value = val;
+    notify_changed();
+}
 
 std::string mtea::ParameterDataType::get_value_string() const {
     const auto dt = mtea::get_meta_type(value);
@@ -44,6 +55,8 @@ void mtea::ParameterDataType::set_value_string(std::string_view val) {
     } else {
         throw ModelException(fmt::format("unknown data type {} provided", val));
     }
+
+    notify_changed();
 }
 
 mtea::ParameterValue::ParameterValue(std::string_view id, std::string_view name, std::unique_ptr<ModelValue>&& value)
@@ -53,7 +66,10 @@ mtea::ModelValue* mtea::ParameterValue::get_value() { return value.get(); }
 
 const mtea::ModelValue* mtea::ParameterValue::get_value() const { return value.get(); }
 
-void mtea::ParameterValue::set_value(std::unique_ptr<ModelValue>&& val) { value = std::move(val); }
+void mtea::ParameterValue::set_value(std::unique_ptr<ModelValue>&& val) {
+    value = std::move(val);
+    notify_changed();
+}
 
 void mtea::ParameterValue::convert_type(const DataType dt) {
     try {
@@ -61,17 +77,28 @@ void mtea::ParameterValue::convert_type(const DataType dt) {
     } catch (const ModelException&) {
         value = ModelValue::make_default(dt);
     }
+
+    notify_changed();
 }
 
 std::string mtea::ParameterValue::get_value_string() const { return value->to_string(); }
 
-void mtea::ParameterValue::set_value_string(std::string_view val) { value = ModelValue::from_string(val, value->data_type()); }
+void mtea::ParameterValue::set_value_string(std::string_view val) {
+    value = ModelValue::from_string(val, value->data_type());
+    notify_changed();
+}
 
 mtea::ParameterIdentifier::ParameterIdentifier(std::string_view id, std::string_view name, const Identifier& value)
     : mtea::Parameter(id, name), ident(value) {}
 
 mtea::Identifier mtea::ParameterIdentifier::get_value() const { return ident; }
-void mtea::ParameterIdentifier::set_value(Identifier val) { ident = val; }
+void mtea::ParameterIdentifier::set_value(Identifier val) {
+    ident = val;
+    notify_changed();
+}
 
 std::string mtea::ParameterIdentifier::get_value_string() const { return ident.get(); }
-void mtea::ParameterIdentifier::set_value_string(std::string_view val) { ident.set(val); }
+void mtea::ParameterIdentifier::set_value_string(std::string_view val) {
+    ident.set(val);
+    notify_changed();
+}
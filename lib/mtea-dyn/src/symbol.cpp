@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "symbol.hpp"
+
+#include <limits>
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include "model_exception.hpp"
+
+mtea::Symbol::Symbol() : Symbol(SymbolTable::get_instance().intern({})) {
+    // Empty Constructor
+}
+
+mtea::Symbol::Symbol(const std::string_view s) : Symbol(SymbolTable::get_instance().intern(s)) {
+    // Empty Constructor
+}
+
+mtea::SymbolTable& mtea::SymbolTable::get_instance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+mtea::SymbolTable::SymbolTable() {
+    // Reserve the first symbol for the empty string, used by default-constructed symbols
+    intern({});
+}
+
+mtea::Symbol mtea::SymbolTable::intern(const std::string_view s) {
+    {
+        std::shared_lock lock(mutex);
+        if (const auto it = lookup.find(s); it != lookup.end()) {
+            return Symbol(it->second);
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    if (const auto it = lookup.find(s); it != lookup.end()) {
+        return Symbol(it->second);
+    }
+
+    if (storage.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw ModelException("symbol table is full");
+    }
+
+    const auto& entry = storage.emplace_back(Symbol::Entry{
+        .value = std::string(s),
+        .hash = std::hash<std::string_view>{}(s),
+        .id = static_cast<uint32_t>(storage.size()),
+    });
+
+    lookup.emplace(entry.value, &entry);
+    return Symbol(&entry);
+}
+
+std::optional<mtea::Symbol> mtea::SymbolTable::find(const std::string_view s) const {
+    std::shared_lock lock(mutex);
+    if (const auto it = lookup.find(s); it != lookup.end()) {
+        return Symbol(it->second);
+    } else {
+        return std::nullopt;
+    }
+}
+
+mtea::Symbol mtea::SymbolTable::qualify(const Symbol& scope, const Symbol& name) {
+    const auto key = std::make_pair(scope.id(), name.id());
+
+    {
+        std::shared_lock lock(mutex);
+        if (const auto it = qualified.find(key); it != qualified.end()) {
+            return Symbol(it->second);
+        }
+    }
+
+    // Only format the qualified name the first time that the pair is seen
+    const auto full = intern(fmt::format("{}{}{}", scope.str(), SCOPE_SEPARATOR, name.str()));
+
+    std::unique_lock lock(mutex);
+    qualified.emplace(key, full.entry);
+    return full;
+}
+
+size_t mtea::SymbolTable::size() const {
+    std::shared_lock lock(mutex);
+    return storage.size();
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "tunable_parameters.hpp"
+
+#include "data_dictionary.hpp"
+#include "model_exception.hpp"
+
+#include <fmt/format.h>
+
+namespace {
+
+thread_local mtea::TunableParameters::Bindings* active_bindings = nullptr;
+
+}
+
+mtea::TunableParameters::Bindings::Bindings(std::shared_ptr<TunableParameters> parameters) : parameters(std::move(parameters)) {
+    applied_version = this->parameters->get_version();
+}
+
+std::shared_ptr<mtea::ModelValue> mtea::TunableParameters::Bindings::get_storage(const Identifier& name, const DataType dtype) {
+    auto& bound = storage[name];
+    for (const auto& s : bound) {
+        if (s->data_type() == dtype) {
+            return s;
+        }
+    }
+
+    // Blocks reading the same parameter as different types each get storage of their own type
+    auto value = std::shared_ptr<ModelValue>(parameters->get_initial_value(name, dtype));
+    bound.push_back(value);
+    return value;
+}
+
+void mtea::TunableParameters::Bindings::apply_pending() {
+    if (parameters->version == applied_version) {
+        return;
+    }
+
+    std::lock_guard lock(parameters->mutex);
+
+    for (auto& [name, bound] : storage) {
+        const auto it = parameters->values.find(name);
+        if (it == parameters->values.end()) {
+            continue;
+        }
+
+        for (const auto& s : bound) {
+            if (s->data_type() == it->second->data_type()) {
+                s->copy_from(it->second.get());
+            } else {
+                s->copy_from(ModelValue::convert_type(it->second.get(), s->data_type()).get());
+            }
+        }
+    }
+
+    applied_version = parameters->version;
+}
+
+mtea::TunableParameters::BindScope::BindScope(Bindings& bindings) : previous(active_bindings) { active_bindings = &bindings; }
+
+mtea::TunableParameters::BindScope::~BindScope() { active_bindings = previous; }
+
+mtea::TunableParameters::TunableParameters(resolver_t resolver) : resolver(std::move(resolver)) {
+    // Empty Constructor
+}
+
+std::shared_ptr<mtea::ModelValue> mtea::TunableParameters::get_storage(const Identifier& name, const DataType dtype) {
+    if (active_bindings == nullptr) {
+        throw ModelException(fmt::format("tunable parameter '{}' must be bound to an executor", name.get()));
+    }
+
+    return active_bindings->get_storage(name, dtype);
+}
+
+std::unique_ptr<mtea::ModelValue> mtea::TunableParameters::get_initial_value(const Identifier& name, const DataType dtype) {
+    std::lock_guard lock(mutex);
+    bound_names.insert(name);
+
+    // Take the initial value from the last edit, then the data dictionaries, falling back to the default value for the type
+    if (const auto it = values.find(name); it != values.end()) {
+        return ModelValue::convert_type(it->second.get(), dtype);
+    } else if (const auto initial = resolver ? resolver(name) : nullptr) {
+        return ModelValue::convert_type(initial.get(), dtype);
+    } else {
+        return ModelValue::make_default(dtype);
+    }
+}
+
+std::vector<mtea::Identifier> mtea::TunableParameters::get_names() const {
+    std::lock_guard lock(mutex);
+    return std::vector<Identifier>(bound_names.begin(), bound_names.end());
+}
+
+void mtea::TunableParameters::set_value(const Identifier& name, const ModelValue* value) {
+    if (value == nullptr) {
+        throw ModelException("unexpected nullptr");
+    }
+
+    auto staged = value->clone();
+
+    std::lock_guard lock(mutex);
+    values.insert_or_assign(name, std::move(staged));
+    version += 1;
+}
+
+void mtea::TunableParameters::set_values(const DataDictionary& dict) {
+    // Copy the dictionary before taking the lock, so that executors applying edits are only held for the merge itself
+    auto staged = dict.copy_values();
+
+    std::lock_guard lock(mutex);
+    for (auto& [k, v] : staged) {
+        values.insert_or_assign(k, std::move(v));
+    }
+    version += 1;
+}
+
+uint64_t mtea::TunableParameters::get_version() const { return version; }
@@ -6,6 +6,9 @@
 
 #include "mtea_string.hpp"
 
+#include <cstring>
+#include <new>
+
 template <mtea::DataType DT> static std::unique_ptr<mtea::ModelValue> make_default_static() {
     return std::make_unique<mtea::ModelValueBox<DT>>();
 }
@@ -42,6 +45,50 @@ std::unique_ptr<mtea::ModelValue> mtea::ModelValue::make_default(const DataType
     }
 }
 
+template <typename F> static auto visit_value_type(const mtea::DataType dtype, F&& func) {
+    switch (dtype) {
+        using enum mtea::DataType;
+    case BOOL:
+        return func.template operator()<BOOL>();
+    case F32:
+        return func.template operator()<F32>();
+    case F64:
+        return func.template operator()<F64>();
+    case I8:
+        return func.template operator()<I8>();
+    case U8:
+        return func.template operator()<U8>();
+    case I16:
+        return func.template operator()<I16>();
+    case U16:
+        return func.template operator()<U16>();
+    case I32:
+        return func.template operator()<I32>();
+    case U32:
+        return func.template operator()<U32>();
+    case I64:
+        return func.template operator()<I64>();
+    case U64:
+        return func.template operator()<U64>();
+    case NONE:
+        return func.template operator()<NONE>();
+    default:
+        throw mtea::ModelException(fmt::format("unable to construct value for type {}", mtea::datatype_to_string(dtype)));
+    }
+}
+
+size_t mtea::ModelValue::storage_size(const DataType dtype) {
+    return visit_value_type(dtype, []<DataType DT>() { return sizeof(ModelValueBox<DT>); });
+}
+
+size_t mtea::ModelValue::storage_alignment(const DataType dtype) {
+    return visit_value_type(dtype, []<DataType DT>() { return alignof(ModelValueBox<DT>); });
+}
+
+mtea::ModelValue* mtea::ModelValue::make_default_at(void* ptr, const DataType dtype) {
+    return visit_value_type(dtype, [ptr]<DataType DT>() -> ModelValue* { return new (ptr) ModelValueBox<DT>(); });
+}
+
 std::unique_ptr<mtea::ModelValue> mtea::ModelValue::from_string(std::string_view s, const DataType dt) {
     const std::string ss(s);
     try {
@@ -81,6 +128,47 @@ std::unique_ptr<mtea::ModelValue> mtea::ModelValue::from_string(std::string_view
     }
 }
 
+size_t mtea::ModelValue::raw_size(const DataType dtype) {
+    return visit_value_type(dtype, []<DataType DT>() -> size_t {
+        if constexpr (DT == DataType::NONE) {
+            return 0;
+        } else {
+            return sizeof(typename ModelValueBox<DT>::type_t);
+        }
+    });
+}
+
+void mtea::ModelValue::to_raw(const ModelValue* val, void* dst) {
+    if (val == nullptr) {
+        throw ModelException("unexpected nullptr");
+    }
+
+    std::memset(dst, 0, RAW_VALUE_SIZE);
+    visit_value_type(val->data_type(), [val, dst]<DataType DT>() {
+        if constexpr (DT != DataType::NONE) {
+            using type_t = typename ModelValueBox<DT>::type_t;
+            static_assert(sizeof(type_t) <= RAW_VALUE_SIZE, "value must fit within the raw value size");
+
+            const type_t& v = get_inner_value<DT>(val);
+            std::memcpy(dst, &v, sizeof(type_t));
+        }
+    });
+}
+
+std::unique_ptr<mtea::ModelValue> mtea::ModelValue::from_raw(const void* src, const DataType dt) {
+    return visit_value_type(dt, [src]<DataType DT>() -> std::unique_ptr<ModelValue> {
+        auto val = std::make_unique<ModelValueBox<DT>>();
+        if constexpr (DT == DataType::BOOL) {
+            uint8_t b;
+            std::memcpy(&b, src, sizeof(b));
+            val->value = b != 0;
+        } else if constexpr (DT != DataType::NONE) {
+            std::memcpy(&val->value, src, sizeof(val->value));
+        }
+        return val;
+    });
+}
+
 template <mtea::DataType DT>
 static std::unique_ptr<mtea::ModelValue> convert_numeric_type_helper(const mtea::ModelValueBox<DT>* ptr, const mtea::DataType dt) {
     switch (dt) {
@@ -12,10 +12,80 @@ static mtea::VariableIdentifier connection_to_variable_id(const mtea::Connection
     return mtea::VariableIdentifier{.block_id = c.get_from_id(), .output_port_num = c.get_from_port()};
 }
 
+void mtea::SignalLayout::add_variable(const VariableIdentifier id, const DataType data_type) {
+    if (find(id).has_value()) {
+        throw ModelException("variable with provided name already exists");
+    }
+
+    const size_t align = ModelValue::storage_alignment(data_type);
+    const size_t offset = (size + align - 1) / align * align;
+
+    // Block ids are dense, so the index is stored as plain arrays by block id and port number
+    if (index.size() <= id.block_id) {
+        index.resize(id.block_id + 1);
+    }
+
+    auto& ports = index[id.block_id];
+    if (ports.size() <= id.output_port_num) {
+        ports.resize(id.output_port_num + 1, NO_SLOT);
+    }
+
+    ports[id.output_port_num] = entries.size();
+    entries.push_back(Entry{.id = id, .data_type = data_type, .offset = offset});
+    size = offset + ModelValue::storage_size(data_type);
+}
+
+std::optional<size_t> mtea::SignalLayout::find(const VariableIdentifier& id) const {
+    if (id.block_id < index.size() && id.output_port_num < index[id.block_id].size() &&
+        index[id.block_id][id.output_port_num] != NO_SLOT) {
+        return index[id.block_id][id.output_port_num];
+    } else {
+        return std::nullopt;
+    }
+}
+
+const std::vector<mtea::SignalLayout::Entry>& mtea::SignalLayout::get_entries() const { return entries; }
+
+size_t mtea::SignalLayout::get_size() const { return size; }
+
+mtea::SignalSlab::SignalSlab(std::shared_ptr<const SignalLayout> layout) : layout(layout) {
+    if (layout == nullptr) {
+        throw ModelException("cannot create a signal slab without a layout");
+    }
+
+    const size_t count = (layout->get_size() + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    data = std::make_unique<std::max_align_t[]>(count);
+
+    auto* base = reinterpret_cast<std::byte*>(data.get());
+    try {
+        for (const auto& e : layout->get_entries()) {
+            values.push_back(ModelValue::make_default_at(base + e.offset, e.data_type));
+        }
+    } catch (const ModelException&) {
+        for (auto* v : values) {
+            std::destroy_at(v);
+        }
+        throw;
+    }
+}
+
+mtea::SignalSlab::~SignalSlab() {
+    for (auto* v : values) {
+        std::destroy_at(v);
+    }
+}
+
+mtea::ModelValue* mtea::SignalSlab::get_value(const size_t slot) const { return values.at(slot); }
+
+mtea::VariableManager::VariableManager(std::shared_ptr<const SignalLayout> layout)
+    : layout(layout), slab(std::make_shared<SignalSlab>(layout)) {
+    // Empty Constructor
+}
+
 void mtea::VariableManager::add_variable(const VariableIdentifier id, const std::shared_ptr<ModelValue> value) {
     const auto it = variables.find(id);
 
-    if (it != variables.end()) {
+    if (it != variables.end() || (layout && layout->find(id).has_value())) {
         throw ModelException("variable with provided name already exists");
     } else if (value == nullptr) {
         throw ModelException("cannot add a null pointer to the variables list");
@@ -28,15 +98,24 @@ std::shared_ptr<mtea::ModelValue> mtea::VariableManager::get_ptr(const VariableI
     const auto it = variables.find(id);
     if (it != variables.end()) {
         return it->second;
-    } else {
-        throw ModelException("variable with identifier not found");
     }
+
+    // Values stored in the slab share ownership of the slab itself
+    if (layout != nullptr) {
+        if (const auto slot = layout->find(id)) {
+            return std::shared_ptr<ModelValue>(slab, slab->get_value(*slot));
+        }
+    }
+
+    throw ModelException("variable with identifier not found");
 }
 
 std::shared_ptr<mtea::ModelValue> mtea::VariableManager::get_ptr(const Connection& c) const {
     return get_ptr(connection_to_variable_id(c));
 }
 
-bool mtea::VariableManager::has_variable(const VariableIdentifier& id) const { return variables.contains(id); }
+bool mtea::VariableManager::has_variable(const VariableIdentifier& id) const {
+    return variables.contains(id) || (layout != nullptr && layout->find(id).has_value());
+}
 
 bool mtea::VariableManager::has_variable(const Connection& c) const { return has_variable(connection_to_variable_id(c)); }
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "workspace_index.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <ranges>
+#include <set>
+
+#include "atomic_file.hpp"
+#include "execution_artifact.hpp"
+#include "identifier.hpp"
+#include "model.hpp"
+#include "model_binary.hpp"
+#include "model_exception.hpp"
+#include "model_loader.hpp"
+
+#include <fmt/format.h>
+
+const std::string mtea::WorkspaceIndex::FILE_NAME = ".mtea_index";
+
+static const std::string MODEL_BLOCK_PREFIX = "models::";
+
+static bool is_model_path(const std::filesystem::path& path) {
+    return path.extension() == mtea::Model::DEFAULT_MODEL_EXTENSION || mtea::ModelBinaryFormat::is_binary_path(path);
+}
+
+static int64_t get_mtime(const std::filesystem::path& path) {
+    return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+mtea::WorkspaceIndex::WorkspaceIndex(const std::filesystem::path& root) : root(std::filesystem::weakly_canonical(root)) {
+    if (!std::filesystem::is_directory(this->root)) {
+        throw ModelException(fmt::format("workspace '{}' is not a directory", root.string()));
+    }
+}
+
+const std::filesystem::path& mtea::WorkspaceIndex::get_root() const { return root; }
+
+std::filesystem::path mtea::WorkspaceIndex::get_index_path() const { return root / FILE_NAME; }
+
+bool mtea::WorkspaceIndex::contains(const std::filesystem::path& path) const { return get_relative_path(path).has_value(); }
+
+size_t mtea::WorkspaceIndex::scan() {
+    size_t num_changed = 0;
+    std::set<std::string> found;
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(root, std::filesystem::directory_options::skip_permission_denied, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        const auto& path = it->path();
+        if (!it->is_regular_file() || !is_model_path(path) || !Identifier::is_valid_identifier(path.stem().string())) {
+            continue;
+        }
+
+        const auto key = path.lexically_relative(root).generic_string();
+        const auto mtime = get_mtime(path);
+        const auto size = static_cast<uint64_t>(it->file_size());
+
+        found.insert(key);
+
+        // Skip files whose modification time and size are unchanged, and then files whose contents are unchanged
+        const auto existing = entries.find(key);
+        if (existing != entries.end() && existing->second.mtime == mtime && existing->second.size == size) {
+            continue;
+        }
+
+        const auto content_hash = ExecutionArtifact::hash_sources({path});
+        if (existing != entries.end() && existing->second.content_hash == content_hash) {
+            existing->second.mtime = mtime;
+            existing->second.size = size;
+            continue;
+        }
+
+        // Models that fail to parse are left out of the index until they are next modified
+        std::unique_ptr<ParsedModelFile> parsed;
+        try {
+            parsed = Model::parse_file(path);
+        } catch (const ModelException&) {
+            if (existing != entries.end()) {
+                entries.erase(existing);
+                num_changed += 1;
+            }
+            continue;
+        }
+
+        Entry entry{
+            .path = std::filesystem::path(key),
+            .name = path.stem().string(),
+            .description = parsed->get_description(),
+            .num_inputs = parsed->get_num_inputs(),
+            .num_outputs = parsed->get_num_outputs(),
+            .dependencies = {},
+            .mtime = mtime,
+            .size = size,
+            .content_hash = content_hash,
+        };
+
+        for (const auto& blk_name : parsed->get_block_names()) {
+            if (blk_name.starts_with(MODEL_BLOCK_PREFIX)) {
+                auto dep = blk_name.substr(MODEL_BLOCK_PREFIX.size());
+                if (std::ranges::find(entry.dependencies, dep) == entry.dependencies.end()) {
+                    entry.dependencies.push_back(std::move(dep));
+                }
+            }
+        }
+
+        entries.insert_or_assign(key, std::move(entry));
+        num_changed += 1;
+    }
+
+    if (ec) {
+        throw ModelException(fmt::format("unable to scan workspace '{}' - {}", root.string(), ec.message()));
+    }
+
+    // Remove any files that no longer exist
+    num_changed += std::erase_if(entries, [&found](const auto& kv) { return !found.contains(kv.first); });
+
+    rebuild_name_map();
+    return num_changed;
+}
+
+void mtea::WorkspaceIndex::save() const {
+    nlohmann::json j;
+    j["version"] = FORMAT_VERSION;
+
+    auto& models = j["models"] = nlohmann::json::array();
+    for (const auto& e : entries | std::views::values) {
+        models.push_back(e);
+    }
+
+    write_file_atomic(get_index_path(), [&j](std::ostream& os) { os << j; });
+}
+
+std::vector<mtea::WorkspaceIndex::Entry> mtea::WorkspaceIndex::get_entries() const {
+    const auto values = entries | std::views::values;
+    return std::vector<Entry>(values.begin(), values.end());
+}
+
+std::optional<mtea::WorkspaceIndex::Entry> mtea::WorkspaceIndex::get_entry(const std::filesystem::path& path) const {
+    if (const auto rel = get_relative_path(path); rel.has_value()) {
+        if (const auto it = entries.find(rel->generic_string()); it != entries.end()) {
+            return it->second;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::filesystem::path> mtea::WorkspaceIndex::find_model(const std::string_view name) const {
+    if (const auto it = entries_by_name.find(std::string(name)); it != entries_by_name.end() && !it->second.empty()) {
+        return root / it->second.front();
+    } else {
+        return std::nullopt;
+    }
+}
+
+std::optional<std::filesystem::path> mtea::WorkspaceIndex::find_submodel(const std::filesystem::path& parent,
+                                                                         const std::string_view name) const {
+    const auto rel = get_relative_path(parent);
+    if (!rel.has_value()) {
+        return std::nullopt;
+    }
+
+    const auto it = entries.find(rel->generic_string());
+    if (it == entries.end()) {
+        return std::nullopt;
+    }
+
+    if (const auto* dep = find_relative_submodel(it->second, name)) {
+        return root / dep->path;
+    } else {
+        return std::nullopt;
+    }
+}
+
+std::vector<std::filesystem::path> mtea::WorkspaceIndex::get_users(const std::filesystem::path& path) const {
+    std::vector<std::filesystem::path> users;
+
+    const auto rel = get_relative_path(path);
+    if (!rel.has_value()) {
+        return users;
+    }
+
+    const auto it = entries.find(rel->generic_string());
+    if (it == entries.end()) {
+        return users;
+    }
+
+    const auto& target = it->second;
+
+    for (const auto& e : entries | std::views::values) {
+        if (std::ranges::find(e.dependencies, target.name) != e.dependencies.end() && find_relative_submodel(e, target.name) == &target) {
+            users.push_back(root / e.path);
+        }
+    }
+
+    return users;
+}
+
+std::vector<std::filesystem::path> mtea::WorkspaceIndex::get_load_closure(const std::filesystem::path& path) const {
+    std::vector<std::filesystem::path> closure;
+
+    const auto rel = get_relative_path(path);
+    if (!rel.has_value()) {
+        return closure;
+    }
+
+    const auto it = entries.find(rel->generic_string());
+    if (it == entries.end()) {
+        return closure;
+    }
+
+    // Provide each model after its dependencies, so that the closure is in load order
+    std::set<const Entry*> visited;
+    const std::function<void(const Entry&)> visit = [&](const Entry& e) {
+        if (!visited.insert(&e).second) {
+            return;
+        }
+
+        for (const auto& dep_name : e.dependencies) {
+            if (const auto* dep = find_relative_submodel(e, dep_name)) {
+                visit(*dep);
+            }
+        }
+
+        closure.push_back(root / e.path);
+    };
+
+    visit(it->second);
+    return closure;
+}
+
+std::shared_ptr<mtea::WorkspaceIndex> mtea::WorkspaceIndex::open(const std::filesystem::path& root) {
+    auto index = std::make_shared<WorkspaceIndex>(root);
+    index->load_cache();
+    index->scan();
+    return index;
+}
+
+std::optional<std::filesystem::path> mtea::WorkspaceIndex::get_relative_path(const std::filesystem::path& path) const {
+    const auto rel = std::filesystem::weakly_canonical(path).lexically_relative(root);
+    if (rel.empty() || *rel.begin() == "..") {
+        return std::nullopt;
+    } else {
+        return rel;
+    }
+}
+
+const mtea::WorkspaceIndex::Entry* mtea::WorkspaceIndex::find_relative_submodel(const Entry& parent, const std::string_view name) const {
+    // Match the search order of the model loader, preferring a submodel saved in the same format as the parent
+    const auto base = parent.path.parent_path() / std::filesystem::path(name);
+    const auto& alt_ext =
+        ModelBinaryFormat::is_binary_path(parent.path) ? Model::DEFAULT_MODEL_EXTENSION : ModelBinaryFormat::FILE_EXTENSION;
+
+    for (const auto& ext : {parent.path.extension().string(), alt_ext}) {
+        if (const auto it = entries.find(std::filesystem::path(base).replace_extension(ext).generic_string()); it != entries.end()) {
+            return &it->second;
+        }
+    }
+
+    return nullptr;
+}
+
+void mtea::WorkspaceIndex::load_cache() {
+    std::ifstream iss(get_index_path());
+    if (!iss) {
+        return;
+    }
+
+    // A missing, outdated or damaged cache only costs a full scan, and so is discarded rather than reported
+    try {
+        const auto j = nlohmann::json::parse(iss);
+        if (j.at("version").get<uint32_t>() != FORMAT_VERSION) {
+            return;
+        }
+
+        std::map<std::string, Entry> loaded;
+        for (const auto& jm : j.at("models")) {
+            auto e = jm.get<Entry>();
+            auto key = e.path.generic_string();
+            loaded.insert_or_assign(std::move(key), std::move(e));
+        }
+
+        entries = std::move(loaded);
+    } catch (const nlohmann::json::exception&) {
+        entries.clear();
+    }
+
+    rebuild_name_map();
+}
+
+void mtea::WorkspaceIndex::rebuild_name_map() {
+    entries_by_name.clear();
+    for (const auto& [key, e] : entries) {
+        entries_by_name[e.name].push_back(key);
+    }
+}
+
+void mtea::to_json(nlohmann::json& j, const WorkspaceIndex::Entry& e) {
+    j["path"] = e.path.generic_string();
+    j["name"] = e.name;
+    j["description"] = e.description;
+    j["inputs"] = e.num_inputs;
+    j["outputs"] = e.num_outputs;
+    j["dependencies"] = e.dependencies;
+    j["mtime"] = e.mtime;
+    j["size"] = e.size;
+    j["hash"] = e.content_hash;
+}
+
+void mtea::from_json(const nlohmann::json& j, WorkspaceIndex::Entry& e) {
+    e.path = std::filesystem::path(j.at("path").get<std::string>());
+    j.at("name").get_to(e.name);
+    j.at("description").get_to(e.description);
+    j.at("inputs").get_to(e.num_inputs);
+    j.at("outputs").get_to(e.num_outputs);
+    j.at("dependencies").get_to(e.dependencies);
+    j.at("mtime").get_to(e.mtime);
+    j.at("size").get_to(e.size);
+    j.at("hash").get_to(e.content_hash);
+}
@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+
+#include "codegen_benchmark.hpp"
+#include "codegen_generator.hpp"
+#include "model.hpp"
+#include "model_block.hpp"
+#include "test_library.hpp"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+constexpr double BASE_DT = 0.1;
+
+// Submodel fed back through a delay that runs after it, alongside a chain of submodels reading each other through their bound outputs
+std::shared_ptr<mtea::Model> create_feedback(mtea::test::TestSession& session, const std::filesystem::path& folder) {
+    auto& mgr = session.get_manager();
+
+    const auto inner = session.create_model();
+    inner->add_block(session.create_input("f64"));
+    inner->add_block(mgr.create_block("stdlib::output"));
+    inner->add_block(mgr.create_block("test::gain"));
+    mtea::test::connect(*inner, {{0, 2}, {2, 1}});
+    inner->update_block();
+    session.get_models().save_model(inner.get(), folder / "Twice.tmdl");
+
+    auto outer = session.create_model();
+    outer->add_block(mgr.create_block("models::Twice"));  // 0
+    outer->add_block(mgr.create_block("test::delay"));    // 1
+    outer->add_block(mgr.create_block("stdlib::output")); // 2
+    outer->add_block(mgr.create_block("test::counter"));  // 3
+    outer->add_block(mgr.create_block("models::Twice"));  // 4
+    outer->add_block(mgr.create_block("stdlib::output")); // 5
+    outer->add_block(mgr.create_block("models::Twice"));  // 6
+    mtea::test::connect(*outer, {{1, 0}, {0, 1}, {0, 2}, {3, 4}, {4, 6}, {6, 5}});
+    outer->update_block();
+    session.get_models().save_model(outer.get(), folder / "Feedback.tmdl");
+    return outer;
+}
+
+// Three independent chains, two of which include delays, so that blocks may be spread across partitions
+std::shared_ptr<mtea::Model> create_chains(mtea::test::TestSession& session, const std::filesystem::path& folder) {
+    auto& mgr = session.get_manager();
+    auto mdl = session.create_model();
+    mdl->add_block(session.create_input("f64"));      // 0
+    mdl->add_block(mgr.create_block("stdlib::output")); // 1
+    for (size_t i = 0; i < 3; ++i) {
+        mdl->add_block(mgr.create_block("test::gain")); // 2, 3, 4
+    }
+    mdl->add_block(mgr.create_block("test::counter"));  // 5
+    mdl->add_block(mgr.create_block("test::scale"));    // 6
+    mdl->add_block(mgr.create_block("test::gain"));     // 7
+    mdl->add_block(mgr.create_block("stdlib::output")); // 8
+    mdl->add_block(mgr.create_block("test::delay"));    // 9
+    mdl->add_block(mgr.create_block("test::gain"));     // 10
+    mdl->add_block(mgr.create_block("stdlib::output")); // 11
+    mdl->add_block(mgr.create_block("test::delay"));    // 12
+    mdl->add_block(mgr.create_block("test::gain"));     // 13
+    mdl->add_block(mgr.create_block("stdlib::output")); // 14
+    mtea::test::connect(*mdl, {{0, 2}, {2, 3}, {3, 4}, {4, 1}, {5, 6}, {6, 7}, {7, 8}, {13, 9}, {9, 10}, {10, 11}, {7, 12}, {12, 13},
+                               {13, 14}});
+    mdl->update_block();
+    session.get_models().save_model(mdl.get(), folder / "Chains.tmdl");
+    return mdl;
+}
+
+// Independent chains of slow blocks, with enough work per step to be worth stepping in parallel
+std::shared_ptr<mtea::Model> create_work(mtea::test::TestSession& session, const std::filesystem::path& folder, const size_t chains) {
+    auto& mgr = session.get_manager();
+    auto mdl = session.create_model();
+    for (size_t i = 0; i < chains; ++i) {
+        const auto first = mdl->get_blocks().size();
+        mdl->add_block(mgr.create_block("test::counter"));
+        mdl->add_block(mgr.create_block("test::work"));
+        mdl->add_block(mgr.create_block("test::work"));
+        mdl->add_block(mgr.create_block("stdlib::output"));
+        mtea::test::connect(*mdl, {{first, first + 1}, {first + 1, first + 2}, {first + 2, first + 3}});
+    }
+    mdl->update_block();
+    session.get_models().save_model(mdl.get(), folder / "Work.tmdl");
+    return mdl;
+}
+
+// Counter driving a submodel with a slower preferred step, so that the submodel runs in its own rate group
+std::shared_ptr<mtea::Model> create_multi_rate(mtea::test::TestSession& session, const std::filesystem::path& folder,
+                                               const std::string_view inner_block, const double inner_dt) {
+    auto& mgr = session.get_manager();
+
+    const auto inner = session.create_model();
+    inner->add_block(session.create_input("f64"));
+    inner->add_block(mgr.create_block("stdlib::output"));
+    inner->add_block(mgr.create_block(fmt::format("test::{}", inner_block)));
+    mtea::test::connect(*inner, {{0, 2}, {2, 1}});
+    inner->set_preferred_dt(inner_dt);
+    inner->update_block();
+    session.get_models().save_model(inner.get(), folder / "Slow.tmdl");
+
+    auto outer = session.create_model();
+    outer->add_block(mgr.create_block("test::counter"));                       // 0
+    outer->add_block(mgr.create_block("models::Slow"));                        // 1
+    outer->add_block(mgr.create_block(fmt::format("test::{}", inner_block))); // 2
+    outer->add_block(mgr.create_block("stdlib::output"));                      // 3
+    mtea::test::connect(*outer, {{0, 1}, {1, 2}, {2, 3}});
+    outer->update_block();
+    session.get_models().save_model(outer.get(), folder / "Rates.tmdl");
+    return outer;
+}
+
+size_t get_num_partitions(const std::shared_ptr<mtea::Model>& mdl, const mtea::codegen::CodegenOptions& options) {
+    const auto root = std::make_unique<mtea::ModelBlock>(mdl, "");
+    return root->get_compiled(mtea::BlockInterface::ModelInfo(BASE_DT))->get_codegen_self()->get_num_partitions(options);
+}
+
+}
+
+TEST_CASE("Flat signal storage binds every submodel and matches block interface code", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("flat");
+    const auto mdl = create_feedback(session, folder);
+    const auto stimulus = mtea::test::create_stimulus(20, 0, BASE_DT);
+
+    const mtea::codegen::CodegenOptions interface_options;
+    const auto interface = mtea::test::run_generated(mdl, BASE_DT, interface_options, stimulus, folder / "interface");
+    REQUIRE(mtea::codegen::compare_outputs(interface, mtea::codegen::run_interpreter(mdl, stimulus, BASE_DT, 1)).max_deviation == 0.0);
+    REQUIRE(interface.values[10][0] + interface.values[10][1] != 0.0);
+
+    auto flat_options = interface_options;
+    flat_options.signal_storage = mtea::codegen::SignalStorage::FLAT;
+    const auto flat = mtea::test::run_generated(mdl, BASE_DT, flat_options, stimulus, folder / "flat");
+    REQUIRE(flat.values == interface.values);
+}
+
+TEST_CASE("Partitioned code matches serial code exactly", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto mdl = create_chains(session, mtea::test::get_test_folder("partitions"));
+    const auto stimulus = mtea::test::create_stimulus(50, 1, BASE_DT);
+
+    mtea::codegen::CodegenOptions serial_options;
+    serial_options.layout = mtea::codegen::CodeLayout::AMALGAMATED;
+
+    const auto serial = mtea::test::run_generated(mdl, BASE_DT, serial_options, stimulus, mtea::test::get_test_folder("partitions_serial"));
+    REQUIRE(mtea::codegen::compare_outputs(serial, mtea::codegen::run_interpreter(mdl, stimulus, BASE_DT, 1)).max_deviation == 0.0);
+
+    for (const size_t partitions : {2, 4}) {
+        auto options = serial_options;
+        options.num_partitions = partitions;
+        options.block_costs = {{"test_gain", 2.0}};
+        options.min_partition_cost = 0.0;
+        REQUIRE(get_num_partitions(mdl, options) == partitions);
+
+        const auto folder = mtea::test::get_test_folder(fmt::format("partitions_{}", partitions));
+        const auto partitioned = mtea::test::run_generated(mdl, BASE_DT, options, stimulus, folder);
+        REQUIRE(partitioned.get_num_steps() == serial.get_num_steps());
+        REQUIRE(partitioned.values == serial.values);
+    }
+}
+
+TEST_CASE("Partitions are only kept for models with enough work per step to outweigh synchronisation", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("partitions_threshold");
+
+    mtea::codegen::CodegenOptions options;
+    options.layout = mtea::codegen::CodeLayout::AMALGAMATED;
+    options.num_partitions = 4;
+    options.block_costs = {{"test_work", 20000.0}};
+
+    // A handful of simple blocks falls back to serial code, which is then written without partitions
+    const auto light = create_chains(session, folder);
+    REQUIRE(get_num_partitions(light, options) == 1);
+
+    auto serial_options = options;
+    serial_options.num_partitions = 0;
+    const auto light_stimulus = mtea::test::create_stimulus(20, 1, BASE_DT);
+    const auto light_serial = mtea::test::run_generated(light, BASE_DT, serial_options, light_stimulus, folder / "light_serial");
+    const auto light_partitioned = mtea::test::run_generated(light, BASE_DT, options, light_stimulus, folder / "light_partitioned");
+    REQUIRE(light_partitioned.values == light_serial.values);
+
+    // Slow blocks keep every partition requested, or fewer where the work only pays for some of them
+    const auto heavy = create_work(session, folder, 4);
+    REQUIRE(get_num_partitions(heavy, options) == 4);
+
+    auto limited_options = options;
+    limited_options.min_partition_cost = 60000.0;
+    REQUIRE(get_num_partitions(heavy, limited_options) == 2);
+
+    const auto heavy_stimulus = mtea::test::create_stimulus(20, 0, BASE_DT);
+    const auto heavy_serial = mtea::test::run_generated(heavy, BASE_DT, serial_options, heavy_stimulus, folder / "heavy_serial");
+    const auto heavy_partitioned = mtea::test::run_generated(heavy, BASE_DT, options, heavy_stimulus, folder / "heavy_partitioned");
+    REQUIRE(heavy_partitioned.values == heavy_serial.values);
+}
+
+TEST_CASE("Partitions are only written for amalgamated code", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto mdl = create_chains(session, mtea::test::get_test_folder("partitions_hierarchical"));
+
+    mtea::codegen::CodegenOptions options;
+    options.num_partitions = 2;
+
+    const auto root = std::make_unique<mtea::ModelBlock>(mdl, "");
+    REQUIRE_THROWS_AS(mtea::codegen::CodeGenerator(root->get_compiled(mtea::BlockInterface::ModelInfo(BASE_DT)), options),
+                      mtea::codegen::CodegenError);
+}
+
+TEST_CASE("Multi-rate code matches serial code for a single rate and runs slower groups at their own rate", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("multi_rate");
+    const auto stimulus = mtea::test::create_stimulus(50, 0, BASE_DT);
+
+    mtea::codegen::CodegenOptions serial_options;
+    serial_options.layout = mtea::codegen::CodeLayout::AMALGAMATED;
+
+    auto rate_options = serial_options;
+    rate_options.multi_rate = true;
+
+    const auto single = create_chains(session, folder);
+    const auto single_stimulus = mtea::test::create_stimulus(50, 1, BASE_DT);
+    const auto serial = mtea::test::run_generated(single, BASE_DT, serial_options, single_stimulus, folder / "single_serial");
+    const auto single_rate = mtea::test::run_generated(single, BASE_DT, rate_options, single_stimulus, folder / "single_rate");
+    REQUIRE(single_rate.values == serial.values);
+
+    const auto mdl = create_multi_rate(session, folder, "gain", 1.0);
+    const auto grouped = mtea::test::run_generated(mdl, BASE_DT, rate_options, stimulus, folder / "grouped");
+
+    // The submodel only samples the counter once every ten steps
+    REQUIRE(grouped.values[5][0] == 0.0);
+    REQUIRE(grouped.values[15][0] == 4.0);
+    REQUIRE(grouped.values[49][0] == 124.0);
+
+    auto dispatched_options = rate_options;
+    dispatched_options.rate_dispatcher = true;
+    const auto dispatched = mtea::test::run_generated(mdl, BASE_DT, dispatched_options, stimulus, folder / "dispatched");
+    REQUIRE(dispatched.values == grouped.values);
+}
+
+TEST_CASE("Blocks in slower rate groups are given the step of their group", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("rate_timestep");
+    const auto mdl = create_multi_rate(session, folder, "tstep", 0.4);
+
+    mtea::codegen::CodegenOptions options;
+    options.layout = mtea::codegen::CodeLayout::AMALGAMATED;
+    options.multi_rate = true;
+
+    const auto root = std::make_unique<mtea::ModelBlock>(mdl, "");
+    mtea::codegen::CodeGenerator(root->get_compiled(mtea::BlockInterface::ModelInfo(BASE_DT)), options).write_in_folder(folder);
+
+    std::ifstream iss(folder / "Rates.h");
+    REQUIRE(iss);
+
+    bool slow_step = false;
+    bool base_step = false;
+    for (std::string line; std::getline(iss, line);) {
+        if (line.find("constexpr") != std::string::npos && line.find("_arg") != std::string::npos) {
+            slow_step |= line.find("0.400000") != std::string::npos;
+            base_step |= line.find("0.100000") != std::string::npos;
+        }
+    }
+
+    REQUIRE(slow_step);
+    REQUIRE(base_step);
+}
+
+TEST_CASE("Constructor parameters are fixed once the model is constructed and reported with their binding", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("parameters");
+    const auto mdl = create_chains(session, folder);
+    const auto stimulus = mtea::test::create_stimulus(20, 1, BASE_DT);
+
+    const mtea::codegen::CodegenOptions constant_options;
+    const auto constant = mtea::test::run_generated(mdl, BASE_DT, constant_options, stimulus, folder / "constant");
+
+    auto constructor_options = constant_options;
+    constructor_options.parameter_binding = mtea::codegen::ParameterBinding::CONSTRUCTOR;
+    const auto constructor = mtea::test::run_generated(mdl, BASE_DT, constructor_options, stimulus, folder / "constructor");
+    REQUIRE(constructor.values == constant.values);
+
+    std::ifstream iss(folder / "constructor" / "Chains.h");
+    const std::string header((std::istreambuf_iterator<char>(iss)), std::istreambuf_iterator<char>());
+    REQUIRE(header.find("const parameters_t parameters{};") != std::string::npos);
+
+    auto report_options = constant_options;
+    report_options.parameter_bindings = {{"Chains::_block_6_arg", mtea::codegen::ParameterBinding::CONSTRUCTOR}};
+    report_options.write_parameter_report = true;
+
+    std::filesystem::create_directories(folder / "report");
+    const auto root = std::make_unique<mtea::ModelBlock>(mdl, "");
+    const auto summary = mtea::codegen::CodeGenerator(root->get_compiled(mtea::BlockInterface::ModelInfo(BASE_DT)), report_options)
+                             .write_in_folder(folder / "report");
+    REQUIRE(summary.parameters_constructor == 1);
+
+    const auto report = nlohmann::json::parse(std::ifstream(folder / "report" / mtea::codegen::CodeGenerator::PARAMETER_REPORT_FILE_NAME));
+    for (const auto& p : report.at("parameters")) {
+        REQUIRE(p.at("binding") == (p.at("name") == "Chains::_block_6_arg" ? "constructor" : "constant"));
+    }
+}
+
+TEST_CASE("Size-optimised code shares identical model types and reports estimated sizes", "[codegen]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("size");
+    auto& mgr = session.get_manager();
+
+    for (const auto* name : {"First", "Second"}) {
+        const auto inner = session.create_model();
+        inner->add_block(session.create_input("f64"));
+        inner->add_block(mgr.create_block("stdlib::output"));
+        inner->add_block(mgr.create_block("test::gain"));
+        mtea::test::connect(*inner, {{0, 2}, {2, 1}});
+        inner->update_block();
+        session.get_models().save_model(inner.get(), folder / fmt::format("{}.tmdl", name));
+    }
+
+    const auto mdl = session.create_model();
+    mdl->add_block(mgr.create_block("test::counter"));
+    mdl->add_block(mgr.create_block("models::First"));
+    mdl->add_block(mgr.create_block("models::Second"));
+    mdl->add_block(mgr.create_block("stdlib::output"));
+    mtea::test::connect(*mdl, {{0, 1}, {1, 2}, {2, 3}});
+    mdl->update_block();
+    session.get_models().save_model(mdl.get(), folder / "Pair.tmdl");
+
+    const auto stimulus = mtea::test::create_stimulus(20, 0, BASE_DT);
+    const mtea::codegen::CodegenOptions options;
+    auto size_options = options;
+    size_options.optimise_size = true;
+
+    const auto plain = mtea::test::run_generated(mdl, BASE_DT, options, stimulus, folder / "plain");
+    const auto optimised = mtea::test::run_generated(mdl, BASE_DT, size_options, stimulus, folder / "optimised");
+    REQUIRE(optimised.values == plain.values);
+
+    const auto report = nlohmann::json::parse(std::ifstream(folder / "optimised" / mtea::codegen::CodeGenerator::SIZE_REPORT_FILE_NAME));
+    REQUIRE(report.contains("units"));
+
+    size_t shared = 0;
+    for (const auto& c : report.at("components")) {
+        REQUIRE(c.contains("estimated_inline_statements"));
+        REQUIRE(c.contains("estimated_out_of_line_statements"));
+        REQUIRE(c.contains("estimated_data_members"));
+        shared += c.at("shared_with").get<std::string>().empty() ? 0 : 1;
+    }
+    REQUIRE(shared == 1);
+}
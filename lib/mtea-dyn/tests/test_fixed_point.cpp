@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <tuple>
+
+#include "fixed_point.hpp"
+#include "model_exception.hpp"
+
+TEST_CASE("Fixed-point names round-trip and invalid names are rejected", "[fixed_point]") {
+    for (const auto* name : {"sfix16_En8", "ufix8_E2", "sfix32", "ufix31_En40"}) {
+        REQUIRE(mtea::FixedPointType::from_string(name).to_string() == name);
+    }
+
+    for (const auto* name : {"sfix", "sfix1", "ufix32", "sfix16_X3", "fix16"}) {
+        REQUIRE_THROWS_AS(mtea::FixedPointType::from_string(name), mtea::ModelException);
+    }
+}
+
+TEST_CASE("Proposed scalings hold the range without saturating", "[fixed_point]") {
+    REQUIRE(mtea::FixedPointType::propose(-3.2, 1.0, 16).to_string() == "sfix16_En13");
+    REQUIRE(mtea::FixedPointType::propose(0.0, 1000.0, 8).to_string() == "ufix8_E2");
+
+    for (const auto& [min, max] : {std::tuple{-1.0, 1.0}, std::tuple{0.0, 0.75}, std::tuple{-1000.0, 0.5}, std::tuple{0.0, 65535.0}}) {
+        const auto type = mtea::FixedPointType::propose(min, max, 16);
+        REQUIRE(type.get_min() <= min);
+        REQUIRE(type.get_max() >= max - type.get_resolution());
+    }
+}
@@ -0,0 +1,350 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "test_library.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+
+#include "block_io_ports.hpp"
+#include "codegen_generator.hpp"
+#include "connection.hpp"
+#include "connection_manager.hpp"
+#include "model_block.hpp"
+#include "model_exception.hpp"
+#include "parameter.hpp"
+#include "variable_manager.hpp"
+
+#include <fmt/format.h>
+
+#ifndef MTEA_TEST_CXX_COMPILER
+#define MTEA_TEST_CXX_COMPILER "c++"
+#endif
+
+namespace {
+
+constexpr std::array<std::string_view, 6> BLOCK_NAMES = {"counter", "delay", "gain", "scale", "tstep", "work"};
+
+constexpr double SCALE_FACTOR = 1.5;
+
+constexpr int WORK_ITERATIONS = 20000;
+
+/* ==================== EXECUTION ==================== */
+
+class TestExecutor : public mtea::BlockExecutionInterface {
+public:
+    TestExecutor(const std::string_view name, const double dt, std::vector<std::shared_ptr<const mtea::ModelValue>>&& inputs,
+                 std::shared_ptr<mtea::ModelValue> output)
+        : name{name}, dt{dt}, inputs{std::move(inputs)}, output{std::move(output)} {
+        // Empty Constructor
+    }
+
+protected:
+    void update_inputs() override {}
+    void update_outputs() override {}
+
+    void blk_reset() override {
+        state = 0.0;
+        write(name == "tstep" ? dt : 0.0);
+    }
+
+    void blk_step() override {
+        if (name == "counter") {
+            state += 1.0;
+            write(state);
+        } else if (name == "delay") {
+            write(state);
+            state = read();
+        } else if (name == "scale") {
+            write(SCALE_FACTOR * read());
+        } else if (name == "tstep") {
+            write(dt);
+        } else if (name == "work") {
+            double acc = 0.0;
+            for (int i = 0; i < WORK_ITERATIONS; ++i) {
+                acc = 0.5 * acc + read();
+            }
+            write(acc);
+        } else {
+            write(2.0 * read());
+        }
+    }
+
+private:
+    double read() const { return mtea::ModelValue::get_inner_value<mtea::DataType::F64>(inputs.at(0).get()); }
+
+    void write(const double value) { mtea::ModelValue::get_inner_value<mtea::DataType::F64>(output.get()) = value; }
+
+    const std::string name;
+    const double dt;
+    const std::vector<std::shared_ptr<const mtea::ModelValue>> inputs;
+    const std::shared_ptr<mtea::ModelValue> output;
+    double state{0.0};
+};
+
+/* ==================== CODE COMPONENT ==================== */
+
+class TestComponent : public mtea::codegen::CodeComponent {
+public:
+    TestComponent(const std::string_view name, const size_t num_inputs, const double dt)
+        : name{name}, num_inputs{num_inputs}, dt{dt} {
+        // Empty Constructor
+    }
+
+    std::optional<mtea::codegen::InterfaceDefinition> get_input_type() const override {
+        if (num_inputs == 0) {
+            return {};
+        }
+
+        return mtea::codegen::InterfaceDefinition("s_in", {"x"});
+    }
+
+    std::optional<mtea::codegen::InterfaceDefinition> get_output_type() const override {
+        return mtea::codegen::InterfaceDefinition("s_out", {"y"});
+    }
+
+    std::string get_name_base() const override { return fmt::format("test_{}", name); }
+
+    std::string get_module_name() const override { return std::string(mtea::test::TestLibrary::HEADER_FILE_NAME); }
+
+    std::optional<std::string> get_function_name(const mtea::codegen::BlockFunction ft) const override {
+        return ft == mtea::codegen::BlockFunction::STEP ? "step" : "reset";
+    }
+
+    std::vector<mtea::codegen::ConstructorArgument> constructor_arguments() const override {
+        if (name == "scale") {
+            return {{.type_name = "double", .value = fmt::format("{}", SCALE_FACTOR)}};
+        } else if (name == "tstep") {
+            return {{.type_name = "double", .value = fmt::format("{:f}", dt)}};
+        } else {
+            return {};
+        }
+    }
+
+protected:
+    std::vector<std::string> write_code(mtea::codegen::CodeSection, const mtea::codegen::CodegenOptions&) const override { return {}; }
+
+private:
+    const std::string name;
+    const size_t num_inputs;
+    const double dt;
+};
+
+/* ==================== BLOCK ==================== */
+
+class TestCompiled : public mtea::CompiledBlockInterface {
+public:
+    TestCompiled(const std::string_view name, const size_t id, const size_t num_inputs, const double dt)
+        : name{name}, id{id}, num_inputs{num_inputs}, dt{dt} {
+        // Empty Constructor
+    }
+
+    std::unique_ptr<mtea::BlockExecutionInterface> get_execution_interface(const mtea::ConnectionManager& connections,
+                                                                            const mtea::VariableManager& manager) const override {
+        std::vector<std::shared_ptr<const mtea::ModelValue>> inputs;
+        for (size_t i = 0; i < num_inputs; ++i) {
+            inputs.push_back(manager.get_ptr(*connections.get_connection_to(id, i)));
+        }
+
+        return std::make_unique<TestExecutor>(name, dt, std::move(inputs), manager.get_ptr(mtea::VariableIdentifier{id, 0}));
+    }
+
+    std::unique_ptr<mtea::codegen::CodeComponent> get_codegen_self() const override {
+        return std::make_unique<TestComponent>(name, num_inputs, dt);
+    }
+
+private:
+    const std::string name;
+    const size_t id;
+    const size_t num_inputs;
+    const double dt;
+};
+
+class TestBlock : public mtea::BlockInterface {
+public:
+    explicit TestBlock(const std::string_view name)
+        : mtea::BlockInterface(mtea::test::TestLibrary::LIBRARY_NAME), name{name}, input_types(name == "counter" ? 0 : 1) {
+        // Empty Constructor
+    }
+
+    std::string get_name() const override { return name; }
+
+    std::string get_description() const override { return fmt::format("test {} block", name); }
+
+    bool update_block() override { return false; }
+
+    std::unique_ptr<const mtea::BlockError> has_error() const override { return nullptr; }
+
+    size_t get_num_inputs() const override { return input_types.size(); }
+
+    size_t get_num_outputs() const override { return 1; }
+
+    bool outputs_are_delayed() const override { return name == "delay"; }
+
+    void set_input_type(const size_t port, const mtea::DataType type) override { input_types.at(port) = type; }
+
+    // Gains take the type of their input, so that type propagation through a chain of blocks can be observed
+    mtea::DataType get_output_type(const size_t) const override {
+        if (name == "gain" && input_types.at(0) != mtea::DataType::NONE) {
+            return input_types.at(0);
+        } else {
+            return mtea::DataType::F64;
+        }
+    }
+
+    std::unique_ptr<mtea::CompiledBlockInterface> get_compiled(const ModelInfo& s) const override {
+        return std::make_unique<TestCompiled>(name, get_id(), input_types.size(), s.get_dt());
+    }
+
+private:
+    const std::string name;
+    std::vector<mtea::DataType> input_types;
+};
+
+}
+
+/* ==================== TEST LIBRARY ==================== */
+
+const std::string mtea::test::TestLibrary::get_library_name() const { return std::string(LIBRARY_NAME); }
+
+std::vector<std::string> mtea::test::TestLibrary::get_block_names() const {
+    return std::vector<std::string>(BLOCK_NAMES.begin(), BLOCK_NAMES.end());
+}
+
+bool mtea::test::TestLibrary::has_block(const std::string_view name) const {
+    return std::ranges::find(BLOCK_NAMES, name) != BLOCK_NAMES.end();
+}
+
+std::unique_ptr<mtea::BlockInterface> mtea::test::TestLibrary::create_block(const std::string_view name) const {
+    if (!has_block(name)) {
+        throw ModelException(fmt::format("unknown test block '{}'", name));
+    }
+
+    return std::make_unique<TestBlock>(name);
+}
+
+void mtea::test::TestLibrary::write_header(const std::filesystem::path& folder) {
+    std::ofstream oss(folder / HEADER_FILE_NAME);
+    oss << "#pragma once\n"
+           "struct test_counter {\n"
+           "    struct { double y{}; } s_out;\n"
+           "    double state{};\n"
+           "    void reset() { state = 0.0; s_out.y = 0.0; }\n"
+           "    void step() { state += 1.0; s_out.y = state; }\n"
+           "};\n"
+           "struct test_delay {\n"
+           "    struct { double x{}; } s_in;\n"
+           "    struct { double y{}; } s_out;\n"
+           "    double state{};\n"
+           "    void reset() { state = 0.0; s_out.y = 0.0; }\n"
+           "    void step() { s_out.y = state; state = s_in.x; }\n"
+           "};\n"
+           "struct test_gain {\n"
+           "    struct { double x{}; } s_in;\n"
+           "    struct { double y{}; } s_out;\n"
+           "    void reset() { s_out.y = 0.0; }\n"
+           "    void step() { s_out.y = 2.0 * s_in.x; }\n"
+           "};\n"
+           "struct test_scale {\n"
+           "    explicit test_scale(double k) : k(k) {}\n"
+           "    struct { double x{}; } s_in;\n"
+           "    struct { double y{}; } s_out;\n"
+           "    double k;\n"
+           "    void reset() { s_out.y = 0.0; }\n"
+           "    void step() { s_out.y = k * s_in.x; }\n"
+           "};\n"
+           "struct test_tstep {\n"
+           "    explicit test_tstep(double dt) : dt(dt) {}\n"
+           "    struct { double x{}; } s_in;\n"
+           "    struct { double y{}; } s_out;\n"
+           "    double dt;\n"
+           "    void reset() { s_out.y = dt; }\n"
+           "    void step() { s_out.y = dt; }\n"
+           "};\n"
+           "struct test_work {\n"
+           "    struct { double x{}; } s_in;\n"
+           "    struct { double y{}; } s_out;\n"
+           "    void reset() { s_out.y = 0.0; }\n"
+           "    void step() {\n"
+           "        double acc = 0.0;\n"
+           "        for (int i = 0; i < "
+        << WORK_ITERATIONS
+        << "; ++i) { acc = 0.5 * acc + s_in.x; }\n"
+           "        s_out.y = acc;\n"
+           "    }\n"
+           "};\n";
+
+    if (!oss) {
+        throw ModelException("unable to write test block header");
+    }
+}
+
+/* ==================== TEST SESSION ==================== */
+
+mtea::test::TestSession::TestSession() { manager.register_library(TestLibrary::LIBRARY_NAME, std::make_unique<TestLibrary>()); }
+
+mtea::ModelManager& mtea::test::TestSession::get_manager() { return manager; }
+
+mtea::ModelLibrary& mtea::test::TestSession::get_models() { return *manager.default_model_library(); }
+
+std::shared_ptr<mtea::Model> mtea::test::TestSession::create_model() { return get_models().create_new_model(); }
+
+std::unique_ptr<mtea::BlockInterface> mtea::test::TestSession::create_input(const std::string_view dtype) {
+    auto blk = manager.create_block("stdlib::input");
+    for (const auto& p : blk->get_parameters()) {
+        p->set_value_string(dtype);
+    }
+    return blk;
+}
+
+/* ==================== HELPERS ==================== */
+
+std::filesystem::path mtea::test::get_test_folder(const std::string_view name) {
+    const auto folder = std::filesystem::temp_directory_path() / "mtea-dyn-tests" / name;
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    return folder;
+}
+
+void mtea::test::connect(Model& model, const std::vector<std::pair<size_t, size_t>>& links) {
+    for (const auto& [from, to] : links) {
+        model.add_connection(std::make_shared<Connection>(from, 0, to, 0));
+    }
+}
+
+mtea::codegen::SignalTrace mtea::test::create_stimulus(const size_t steps, const size_t num_inputs, const double dt) {
+    codegen::SignalTrace stimulus;
+    for (size_t i = 0; i < steps; ++i) {
+        stimulus.times.push_back(dt * static_cast<double>(i));
+        stimulus.values.push_back(std::vector<double>(num_inputs, 0.5 * static_cast<double>(i)));
+    }
+    return stimulus;
+}
+
+bool mtea::test::build_and_run(const std::filesystem::path& folder, const std::string_view source, const std::string_view arguments) {
+    const auto command = fmt::format("cd \"{}\" && \"{}\" -std=c++20 -O1 -pthread -I. {} -o run && ./run {}", folder.string(),
+                                     MTEA_TEST_CXX_COMPILER, source, arguments);
+    return std::system(command.c_str()) == 0;
+}
+
+mtea::codegen::SignalTrace mtea::test::run_generated(const std::shared_ptr<Model>& model, const double dt,
+                                                     const codegen::CodegenOptions& options, const codegen::SignalTrace& stimulus,
+                                                     const std::filesystem::path& folder) {
+    auto bench_options = options;
+    bench_options.write_benchmark = true;
+
+    std::filesystem::create_directories(folder);
+
+    const auto root = std::make_unique<ModelBlock>(model, "");
+    codegen::CodeGenerator(root->get_compiled(BlockInterface::ModelInfo(dt)), bench_options).write_in_folder(folder);
+
+    TestLibrary::write_header(folder);
+    stimulus.write_csv(folder / "stimulus.csv");
+
+    if (!build_and_run(folder, codegen::BenchmarkWriter::MAIN_FILE_NAME, "stimulus.csv outputs.csv 2")) {
+        throw ModelException(fmt::format("unable to build and run the generated benchmark in '{}'", folder.string()));
+    }
+
+    return codegen::SignalTrace::read_csv(folder / "outputs.csv");
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef MTEA_DYNTEST_LIBRARY_HPP
+#define MTEA_DYNTEST_LIBRARY_HPP
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "codegen_benchmark.hpp"
+#include "library.hpp"
+#include "model.hpp"
+#include "model_manager.hpp"
+
+namespace mtea::test {
+
+// Library of double-valued blocks with fixed behaviour, so that tests don't depend on the blocks of the standard library:
+// counter, gain (doubles its input), delay, scale (multiplies by a constructor argument of 1.5), tstep (outputs its timestep) and
+// work (doubles its input the slow way, through a long loop, for models with enough work per step to be worth partitioning)
+class TestLibrary : public LibraryBase {
+public:
+    const std::string get_library_name() const override;
+
+    std::vector<std::string> get_block_names() const override;
+
+    bool has_block(std::string_view name) const override;
+
+    std::unique_ptr<BlockInterface> create_block(std::string_view name) const override;
+
+    // Types matching the blocks of the library in generated code
+    static void write_header(const std::filesystem::path& folder);
+
+    static constexpr std::string_view LIBRARY_NAME = "test";
+    static constexpr std::string_view HEADER_FILE_NAME = "test_blocks.hpp";
+};
+
+// Session with the test library registered alongside the standard library
+class TestSession {
+public:
+    TestSession();
+
+    ModelManager& get_manager();
+
+    ModelLibrary& get_models();
+
+    std::shared_ptr<Model> create_model();
+
+    std::unique_ptr<BlockInterface> create_input(std::string_view dtype);
+
+private:
+    ModelManager manager;
+};
+
+// Empty folder for the files written by a test
+std::filesystem::path get_test_folder(std::string_view name);
+
+// Connects block output port 0 to block input port 0 for each pair of block IDs
+void connect(Model& model, const std::vector<std::pair<size_t, size_t>>& links);
+
+// Stimulus with one row for each step, where every input ramps up by 0.5 at each step
+codegen::SignalTrace create_stimulus(const size_t steps, const size_t num_inputs, const double dt);
+
+// Builds a single source file in a folder with the compiler used for the tests, then runs it with the given arguments
+bool build_and_run(const std::filesystem::path& folder, std::string_view source, std::string_view arguments);
+
+// Writes code for a model with a benchmark, then builds and runs the benchmark over the stimulus and returns its outputs
+codegen::SignalTrace run_generated(const std::shared_ptr<Model>& model, const double dt, const codegen::CodegenOptions& options,
+                                   const codegen::SignalTrace& stimulus, const std::filesystem::path& folder);
+
+}
+
+#endif // MTEA_DYNTEST_LIBRARY_HPP
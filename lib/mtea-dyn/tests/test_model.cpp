@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+
+#include "data_dictionary.hpp"
+#include "execution_state.hpp"
+#include "model.hpp"
+#include "model_exception.hpp"
+#include "parameter.hpp"
+#include "test_library.hpp"
+#include "tunable_parameters.hpp"
+
+TEST_CASE("Output types are updated when connections change", "[model]") {
+    mtea::test::TestSession session;
+    const auto mdl = session.create_model();
+    mdl->add_block(session.create_input("i32"));                           // 0
+    mdl->add_block(session.get_manager().create_block("test::gain"));      // 1
+    mdl->add_block(session.get_manager().create_block("test::gain"));      // 2
+    mdl->add_block(session.get_manager().create_block("stdlib::output"));  // 3
+    mtea::test::connect(*mdl, {{1, 2}, {2, 3}});
+    mdl->update_block();
+
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::F64);
+    REQUIRE_FALSE(mdl->update_block());
+
+    // New connections type the destination block straight away
+    mtea::test::connect(*mdl, {{0, 1}});
+    REQUIRE(mdl->get_block(1)->get_output_type(0) == mtea::DataType::I32);
+    REQUIRE(mdl->update_block());
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::I32);
+
+    mdl->remove_connection(1, 0);
+    REQUIRE(mdl->update_block());
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::F64);
+
+    mtea::test::connect(*mdl, {{0, 1}});
+    mdl->update_block();
+    for (const auto& p : mdl->get_block(0)->get_parameters()) {
+        p->set_value_string("f64");
+    }
+
+    // Parameter edits mark their block as changed without the caller having to
+    REQUIRE(mdl->update_block());
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::F64);
+    REQUIRE_FALSE(mdl->update_block());
+
+    // Removing a block disconnects its downstream blocks, which no longer take the type of the model input
+    mdl->add_block(session.get_manager().create_block("test::gain")); // 4
+    mdl->remove_connection(2, 0);
+    mtea::test::connect(*mdl, {{0, 4}, {4, 2}});
+    for (const auto& p : mdl->get_block(0)->get_parameters()) {
+        p->set_value_string("i32");
+    }
+    REQUIRE(mdl->update_block());
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::I32);
+
+    mdl->remove_block(4);
+    REQUIRE(mdl->update_block());
+    REQUIRE(mdl->get_output_datatype(0) == mtea::DataType::F64);
+}
+
+TEST_CASE("Submodels are only evaluated again once they have changed", "[model]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("submodel_updates");
+
+    const auto inner = session.create_model();
+    inner->add_block(session.create_input("f64"));
+    inner->add_block(session.get_manager().create_block("stdlib::output"));
+    inner->add_block(session.get_manager().create_block("test::gain"));
+    mtea::test::connect(*inner, {{0, 2}, {2, 1}});
+    inner->update_block();
+    session.get_models().save_model(inner.get(), folder / "Inner.tmdl");
+
+    const auto outer = session.create_model();
+    outer->add_block(session.get_manager().create_block("test::counter"));
+    outer->add_block(session.get_manager().create_block("models::Inner"));
+    mtea::test::connect(*outer, {{0, 1}});
+    outer->update_block();
+
+    const auto evaluations = outer->get_update_statistics().total_evaluations;
+    REQUIRE_FALSE(outer->update_block());
+    REQUIRE(outer->get_update_statistics().total_evaluations == evaluations);
+
+    inner->mark_block_changed(2);
+    outer->update_block();
+    REQUIRE(outer->get_update_statistics().total_evaluations > evaluations);
+}
+
+TEST_CASE("Compiled models are rebuilt once a submodel is removed", "[model]") {
+    mtea::test::TestSession session;
+    const auto folder = mtea::test::get_test_folder("compile_cache");
+
+    const auto inner = session.create_model();
+    inner->add_block(session.create_input("f64"));
+    inner->add_block(session.get_manager().create_block("stdlib::output"));
+    inner->add_block(session.get_manager().create_block("test::gain"));
+    mtea::test::connect(*inner, {{0, 2}, {2, 1}});
+    inner->update_block();
+    session.get_models().save_model(inner.get(), folder / "Inner.tmdl");
+
+    const auto outer = session.create_model();
+    outer->add_block(session.get_manager().create_block("test::counter"));
+    outer->add_block(session.get_manager().create_block("models::Inner"));
+    mtea::test::connect(*outer, {{0, 1}});
+    outer->update_block();
+
+    { const auto state = mtea::ExecutionState::from_model(outer, 0.1); }
+    { const auto state = mtea::ExecutionState::from_model(outer, 0.1); }
+
+    const auto statistics = outer->get_compile_cache_statistics();
+    REQUIRE(statistics.hits > 0);
+
+    const auto version = outer->get_version();
+    outer->remove_block(1);
+    outer->update_block();
+    REQUIRE(outer->get_version() > version);
+
+    { const auto state = mtea::ExecutionState::from_model(outer, 0.1); }
+    REQUIRE(outer->get_compile_cache_statistics().misses == statistics.misses + 1);
+}
+
+TEST_CASE("Compiled models are rebuilt once the preferred step changes", "[model]") {
+    mtea::test::TestSession session;
+    const auto mdl = session.create_model();
+    mdl->add_block(session.get_manager().create_block("test::counter"));
+    mdl->update_block();
+
+    { const auto state = mtea::ExecutionState::from_model(mdl, 0.1); }
+    const auto statistics = mdl->get_compile_cache_statistics();
+
+    const auto version = mdl->get_version();
+    mdl->set_preferred_dt(0.5);
+    REQUIRE(mdl->get_version() > version);
+
+    { const auto state = mtea::ExecutionState::from_model(mdl, 0.1); }
+    REQUIRE(mdl->get_compile_cache_statistics().misses == statistics.misses + 1);
+
+    // Parameter edits also give a new version without the block being marked as changed
+    mdl->add_block(session.create_input("f64"));
+    const auto input_version = mdl->get_version();
+    for (const auto& p : mdl->get_block(1)->get_parameters()) {
+        p->set_value_string("i32");
+    }
+    REQUIRE(mdl->get_version() > input_version);
+}
+
+TEST_CASE("Block handles don't resolve to a block that reuses the ID of a removed block", "[model]") {
+    mtea::test::TestSession session;
+    const auto mdl = session.create_model();
+    mdl->add_block(session.get_manager().create_block("test::counter"));
+    mdl->add_block(session.get_manager().create_block("test::gain"));
+
+    const auto handle = mdl->get_block_handle(1);
+    REQUIRE(mdl->find_block(handle) == mdl->get_block(1));
+
+    mdl->remove_block(1);
+    REQUIRE(mdl->find_block(handle) == nullptr);
+
+    mdl->add_block(session.get_manager().create_block("test::gain"));
+    REQUIRE(mdl->get_block(1) != nullptr);
+    REQUIRE(mdl->find_block(handle) == nullptr);
+
+    // The most recently freed ID is reused first
+    mdl->add_block(session.get_manager().create_block("test::gain")); // 2
+    mdl->add_block(session.get_manager().create_block("test::gain")); // 3
+    mdl->remove_block(0);
+    mdl->remove_block(2);
+
+    const std::shared_ptr<mtea::BlockInterface> blk = session.get_manager().create_block("test::gain");
+    mdl->add_block(blk);
+    REQUIRE(blk->get_id() == 2);
+}
+
+TEST_CASE("Models with block IDs far beyond the allocated slots are rejected", "[model]") {
+    mtea::test::TestSession session;
+    const auto path = mtea::test::get_test_folder("huge_ids") / "Huge.tmdl";
+
+    std::ofstream(path) << R"({"model": {"description": "huge", "input_ids": [], "output_ids": [], "connections": [],
+        "blocks": [{"id": 1099511627776, "inverted": false, "name": "test::gain", "parameters": [], "x": 0, "y": 0}]}})";
+
+    REQUIRE_THROWS_AS(session.get_models().load_model(path), mtea::ModelException);
+}
+
+namespace {
+
+std::unique_ptr<mtea::ModelValue> make_f64(const double x) {
+    auto value = mtea::ModelValue::make_default(mtea::DataType::F64);
+    mtea::ModelValue::get_inner_value<mtea::DataType::F64>(value.get()) = x;
+    return value;
+}
+
+double get_f64(const std::shared_ptr<mtea::ModelValue>& value) {
+    return mtea::ModelValue::get_inner_value<mtea::DataType::F64>(value.get());
+}
+
+}
+
+TEST_CASE("Tunable parameter edits only reach each executor at its own step boundary", "[parameters]") {
+    const auto parameters = std::make_shared<mtea::TunableParameters>(nullptr);
+    const mtea::Identifier gain("k");
+
+    mtea::TunableParameters::Bindings first(parameters);
+    mtea::TunableParameters::Bindings second(parameters);
+    const auto first_k = first.get_storage(gain, mtea::DataType::F64);
+    const auto second_k = second.get_storage(gain, mtea::DataType::F64);
+    REQUIRE(first_k != second_k);
+
+    // Blocks are only bound while an executor is being built
+    REQUIRE_THROWS_AS(parameters->get_storage(gain, mtea::DataType::F64), mtea::ModelException);
+
+    const auto edit = make_f64(2.0);
+    parameters->set_value(gain, edit.get());
+    first.apply_pending();
+    REQUIRE(get_f64(first_k) == 2.0);
+    REQUIRE(get_f64(second_k) == 0.0);
+
+    second.apply_pending();
+    REQUIRE(get_f64(second_k) == 2.0);
+}
+
+TEST_CASE("Tunable parameter sets are merged with values already set", "[parameters]") {
+    const auto parameters = std::make_shared<mtea::TunableParameters>(nullptr);
+    const mtea::Identifier gain("k");
+    const mtea::Identifier offset("b");
+
+    mtea::TunableParameters::Bindings bindings(parameters);
+    const auto k = bindings.get_storage(gain, mtea::DataType::F64);
+    const auto b = bindings.get_storage(offset, mtea::DataType::F64);
+
+    const auto edit = make_f64(3.0);
+    parameters->set_value(gain, edit.get());
+
+    mtea::DataDictionary dict;
+    dict.add_value(offset, make_f64(4.0));
+    parameters->set_values(dict);
+
+    bindings.apply_pending();
+    REQUIRE(get_f64(k) == 3.0);
+    REQUIRE(get_f64(b) == 4.0);
+}
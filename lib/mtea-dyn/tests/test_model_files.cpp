@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+
+#include "data_dictionary.hpp"
+#include "mapped_data_dictionary.hpp"
+#include "model.hpp"
+#include "model_journal.hpp"
+#include "parameter.hpp"
+#include "test_library.hpp"
+#include "value_array.hpp"
+
+namespace {
+
+std::shared_ptr<mtea::Model> create_passthrough(mtea::test::TestSession& session) {
+    auto mdl = session.create_model();
+    mdl->add_block(session.create_input("f64"));
+    mdl->add_block(session.get_manager().create_block("stdlib::output"));
+    mtea::test::connect(*mdl, {{0, 1}});
+    mdl->update_block();
+    return mdl;
+}
+
+nlohmann::json to_model_json(const mtea::Model& mdl) {
+    nlohmann::json j;
+    j["model"] = mdl;
+    return j;
+}
+
+}
+
+TEST_CASE("Models round-trip through text and binary model files", "[files]") {
+    mtea::test::TestSession session;
+    auto& models = session.get_models();
+    const auto folder = mtea::test::get_test_folder("round_trip");
+
+    nlohmann::json expected;
+    {
+        const auto a = create_passthrough(session);
+        models.save_model(a.get(), folder / "A.tmdl");
+
+        const auto b = create_passthrough(session);
+        b->add_block(session.get_manager().create_block("models::A"));
+        b->add_block(session.get_manager().create_block("test::scale"));
+        b->get_block(3)->set_loc(mtea::BlockLocation(20, 30));
+        models.save_model(b.get(), folder / "B.tmdb");
+
+        const auto c = create_passthrough(session);
+        c->add_block(session.get_manager().create_block("models::A"));
+        c->add_block(session.get_manager().create_block("models::B"));
+        c->add_block(session.get_manager().create_block("models::B"));
+        models.save_model(c.get(), folder / "C.tmdl");
+        expected = to_model_json(*c);
+    }
+
+    models.close_unused_models();
+    REQUIRE(models.get_block_names().empty());
+
+    const auto loaded = models.load_model(folder / "C.tmdl");
+    REQUIRE(to_model_json(*loaded) == expected);
+    REQUIRE(models.get_block_names().size() == 3);
+
+    const auto binary = models.get_model("B");
+    REQUIRE(binary->get_block(3)->get_loc().x == 20);
+    REQUIRE(binary->get_block(3)->get_loc().y == 30);
+}
+
+TEST_CASE("Malformed model files are rejected", "[files]") {
+    mtea::test::TestSession session;
+    auto& models = session.get_models();
+    const auto folder = mtea::test::get_test_folder("malformed");
+
+    std::ofstream(folder / "Missing.tmdl") << R"({"model": {"description": "x", "blocks": [], "connections": []}})";
+    std::ofstream(folder / "Truncated.tmdl") << R"({"model": {"description": "x", "blocks": [)";
+    std::ofstream(folder / "Header.tmdb") << "TMDBxxxx";
+    std::ofstream(folder / "Unknown.tmdl") << R"({"model": {"description": "x", "input_ids": [], "output_ids": [], "connections": [],
+        "blocks": [{"id": 0, "inverted": false, "name": "models::Unknown", "parameters": [], "x": 0, "y": 0}]}})";
+
+    for (const auto* name : {"Missing.tmdl", "Truncated.tmdl", "Header.tmdb", "Unknown.tmdl"}) {
+        REQUIRE_THROWS(models.load_model(folder / name));
+    }
+}
+
+TEST_CASE("Journals replay committed edits, including parameter edits made directly on blocks", "[files]") {
+    mtea::test::TestSession session;
+    auto& models = session.get_models();
+    const auto path = mtea::test::get_test_folder("journal") / "J.tmdl";
+
+    nlohmann::json expected;
+    {
+        const auto mdl = create_passthrough(session);
+        models.save_model(mdl.get(), path);
+        REQUIRE(std::filesystem::exists(mtea::ModelJournal::get_journal_path(path)));
+
+        mdl->add_block(session.get_manager().create_block("test::counter"));
+        mdl->add_block(session.get_manager().create_block("test::gain"));
+        mtea::test::connect(*mdl, {{2, 3}});
+        mdl->get_block(2)->set_loc(mtea::BlockLocation(40, 50));
+        mdl->mark_block_layout_changed(2);
+        mdl->set_description("journaled");
+        models.save_model(mdl.get());
+        REQUIRE_FALSE(mdl->get_unsaved_changes());
+
+        // Reuses the ID of the removed block
+        mdl->remove_block(3);
+        mdl->add_block(session.get_manager().create_block("test::gain"));
+        mtea::test::connect(*mdl, {{2, 3}});
+
+        // Parameter edits are journaled without the block being marked, while layout edits are journaled once marked
+        mdl->get_block(3)->set_loc(mtea::BlockLocation(70, 80));
+        mdl->mark_block_layout_changed(3);
+        for (const auto& p : mdl->get_block(0)->get_parameters()) {
+            p->set_value_string("i32");
+        }
+        models.save_model(mdl.get());
+        expected = to_model_json(*mdl);
+
+        // Edits after the last save are dropped when the model is closed
+        mdl->set_description("not saved");
+    }
+
+    models.close_unused_models();
+
+    const auto loaded = models.load_model(path);
+    REQUIRE(to_model_json(*loaded) == expected);
+    REQUIRE_FALSE(loaded->get_unsaved_changes());
+}
+
+TEST_CASE("Journals recover edits that were not saved before a crash", "[files]") {
+    mtea::test::TestSession session;
+    auto& models = session.get_models();
+    const auto folder = mtea::test::get_test_folder("journal_recovery");
+    const auto path = folder / "J.tmdl";
+    const auto journal_path = mtea::ModelJournal::get_journal_path(path);
+
+    nlohmann::json expected;
+    {
+        const auto mdl = create_passthrough(session);
+        mdl->add_block(session.get_manager().create_block("test::gain"));
+        mdl->remove_connection(1, 0);
+        mtea::test::connect(*mdl, {{0, 2}, {2, 1}});
+        models.save_model(mdl.get(), path);
+
+        mdl->set_preferred_dt(0.25);
+        mdl->remove_connection(1, 0);
+        expected = to_model_json(*mdl);
+
+        // Keep the journal as it was before the model is closed without saving, as if the editor had crashed
+        std::filesystem::copy_file(journal_path, folder / "crash.journal");
+    }
+
+    models.close_unused_models();
+    std::filesystem::rename(folder / "crash.journal", journal_path);
+
+    const auto recovered = models.load_model(path);
+    REQUIRE(to_model_json(*recovered) == expected);
+    REQUIRE(recovered->get_unsaved_changes());
+}
+
+TEST_CASE("Data dictionaries round-trip through text and mapped binary files", "[files]") {
+    const auto folder = mtea::test::get_test_folder("dictionary");
+
+    nlohmann::json expected;
+    {
+        mtea::DataDictionary dict;
+        dict.add_value(mtea::Identifier("gain"), mtea::ModelValue::from_string("2.5", mtea::DataType::F64));
+        dict.add_value(mtea::Identifier("count"), mtea::ModelValue::from_string("7", mtea::DataType::U8));
+        dict.add_value(mtea::Identifier("offset"), mtea::ModelValue::from_string("-4", mtea::DataType::I32));
+
+        std::vector<std::unique_ptr<const mtea::ModelValue>> table;
+        for (int16_t i = 1; i <= 6; ++i) {
+            table.push_back(mtea::ModelValue::from_value<int16_t>(i));
+        }
+        dict.add_array(mtea::Identifier("table"), mtea::ValueArray::create_with_type(2, 3, table, mtea::DataType::I16));
+
+        dict.save(folder / "cal.json");
+        expected = mtea::DataDictionary::load(folder / "cal.json");
+        dict.save(folder / "cal.tmdd");
+    }
+
+    auto mapped = mtea::DataDictionary::load(folder / "cal.tmdd");
+    const auto* data = mapped.get_mapped();
+    REQUIRE(data != nullptr);
+    REQUIRE(data->size() == 4);
+    REQUIRE(data->find("gain")->get<mtea::DataType::F64>() == 2.5);
+    REQUIRE(data->find("count")->get<mtea::DataType::U8>() == 7);
+    REQUIRE(data->find("offset")->get<mtea::DataType::I32>() == -4);
+    REQUIRE_FALSE(data->find("missing").has_value());
+
+    const auto table = data->find("table");
+    REQUIRE(table.has_value());
+    REQUIRE(table->is_array);
+    REQUIRE(table->size() == 6);
+    REQUIRE(table->get<mtea::DataType::I16>(4) == 5);
+
+    // Lookups don't copy mapped entries into memory, which only happens once they are converted for editing
+    REQUIRE(mapped.get_value(mtea::Identifier("gain")) == nullptr);
+    mapped.materialize_all();
+
+    // Values changed after loading are written back to the mapped file
+    mapped.get_value(mtea::Identifier("gain"))->copy_from(mtea::ModelValue::from_string("3.5", mtea::DataType::F64).get());
+    mapped.save();
+
+    auto reloaded = mtea::DataDictionary::load(folder / "cal.tmdd");
+    REQUIRE(reloaded.get_mapped()->find("gain")->get<mtea::DataType::F64>() == 3.5);
+
+    reloaded.save(folder / "cal2.json");
+    const nlohmann::json round_trip = mtea::DataDictionary::load(folder / "cal2.json");
+    expected["parameters"]["gain"]["value"] = "3.5";
+    REQUIRE(round_trip == expected);
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "codegen_benchmark.hpp"
+#include "library_model.hpp"
+#include "model.hpp"
+#include "model_exception.hpp"
+#include "model_manager.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << fmt::format("usage: {} <model file> <stimulus.csv> <generated outputs.csv> [passes]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t passes = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 100;
+
+    try {
+        const auto model = mtea::ModelManager::get_instance().default_model_library()->load_model(argv[1]);
+        const auto stimulus = mtea::codegen::SignalTrace::read_csv(argv[2]);
+        const auto generated = mtea::codegen::SignalTrace::read_csv(argv[3]);
+
+        // Run the interpreter with the same time step that code is generated for
+        const auto interpreted = mtea::codegen::run_interpreter(model, stimulus, model->get_preferred_dt(), passes);
+        const auto result = mtea::codegen::compare_outputs(generated, interpreted);
+
+        std::cout << fmt::format("steps: {}\n", generated.get_num_steps());
+        std::cout << fmt::format("max deviation: {} (step {}, output {})\n", result.max_deviation, result.max_deviation_step,
+                                 result.max_deviation_port);
+        std::cout << fmt::format("generated step: {:.1f} ns mean, {:.1f} ns p99\n", result.generated.mean_ns, result.generated.p99_ns);
+        std::cout << fmt::format("interpreter step: {:.1f} ns mean, {:.1f} ns p99\n", result.interpreted.mean_ns, result.interpreted.p99_ns);
+        std::cout << fmt::format("speedup: {:.2f}x\n", result.get_speedup());
+    } catch (const mtea::ModelException& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    } catch (const mtea::codegen::CodegenError& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
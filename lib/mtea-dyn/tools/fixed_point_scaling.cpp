@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "codegen_benchmark.hpp"
+#include "fixed_point.hpp"
+#include "library_model.hpp"
+#include "model.hpp"
+#include "model_exception.hpp"
+#include "model_manager.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << fmt::format("usage: {} <model file> <stimulus.csv> [word length]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t word_length = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+    try {
+        const auto model = mtea::ModelManager::get_instance().default_model_library()->load_model(argv[1]);
+        const auto stimulus = mtea::codegen::SignalTrace::read_csv(argv[2]);
+
+        const auto ranges = mtea::codegen::record_signal_ranges(model, stimulus, model->get_preferred_dt());
+
+        for (const auto& r : ranges) {
+            if (r.min > r.max) {
+                continue;
+            }
+
+            const auto type = mtea::FixedPointType::propose(r.min, r.max, word_length);
+            std::cout << fmt::format("{}: [{}, {}] -> {} (resolution {})\n", r.id.to_string(), r.min, r.max, type.to_string(),
+                                     type.get_resolution());
+        }
+    } catch (const mtea::ModelException& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    } catch (const mtea::codegen::CodegenError& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
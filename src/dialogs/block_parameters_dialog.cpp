@@ -14,9 +14,25 @@ BlockParameterDialog::BlockParameterDialog(BlockObject* block, QWidget* parent)
 
     ui->lblBlockTitle->setText(block->get_block()->get_name().c_str());
 
+    // Parameters are edited in place, and so are stored to be restored if the dialog is cancelled
+    for (const auto& prm : block->get_block()->get_parameters()) {
+        initialValues.emplace_back(prm, prm->get_value_string());
+    }
+
     reloadParameters();
 }
 
+void BlockParameterDialog::reject() {
+    for (const auto& [prm, value] : initialValues) {
+        prm->set_value_string(value);
+    }
+
+    block->updateBlock();
+    block->update();
+
+    QDialog::reject();
+}
+
 void BlockParameterDialog::reloadParameters() {
     block->updateBlock();
 
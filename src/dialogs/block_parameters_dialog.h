@@ -5,6 +5,11 @@
 
 #include <QDialog>
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "blocks/block_object.h"
 
 namespace Ui {
@@ -19,6 +24,9 @@ public:
 
     ~BlockParameterDialog();
 
+public slots:
+    void reject() override;
+
 protected:
     void reloadParameters();
 
@@ -28,6 +36,7 @@ protected slots:
 private:
     Ui::BlockParameterDialog* ui;
     BlockObject* block;
+    std::vector<std::pair<std::shared_ptr<mtea::Parameter>, std::string>> initialValues;
 };
 
 #endif // BLOCK_PARAMETER_DIALOG_H
@@ -3,6 +3,9 @@
 #include "block_selector_dialog.h"
 #include "ui_block_selector_dialog.h"
 
+#include <QMessageBox>
+
+#include <model_exception.hpp>
 #include <model_manager.hpp>
 
 BlockSelectorDialog::BlockSelectorDialog(QWidget* parent) : QDialog(parent), ui(new Ui::BlockSelectorDialog) {
@@ -30,7 +33,26 @@ void BlockSelectorDialog::librarySelectionUpdated() {
             item->setData(Qt::UserRole + 0, QString(libName.c_str()));
             item->setData(Qt::UserRole + 1, QString(n.c_str()));
         }
-        (void)itm;
+
+        // List the models in the workspace that are not yet loaded from the index, without opening the model files
+        const auto index = manager.default_model_library()->get_workspace_index();
+        if (lib.get() == manager.default_model_library() && index != nullptr) {
+            for (const auto& e : index->get_entries()) {
+                if (lib->has_block(e.name) || index->find_model(e.name) != index->get_root() / e.path) {
+                    continue;
+                }
+
+                QListWidgetItem* item = new QListWidgetItem(QString("%1::%2").arg(libName.c_str()).arg(e.name.c_str()), ui->listBlocks);
+                item->setData(Qt::UserRole + 0, QString(libName.c_str()));
+                item->setData(Qt::UserRole + 1, QString(e.name.c_str()));
+                item->setData(Qt::UserRole + 2, QString((index->get_root() / e.path).string().c_str()));
+                item->setToolTip(QString("%1 (%2 inputs, %3 outputs)\n%4")
+                                     .arg(e.path.string().c_str())
+                                     .arg(e.num_inputs)
+                                     .arg(e.num_outputs)
+                                     .arg(e.description.c_str()));
+            }
+        }
     }
 }
 
@@ -38,6 +60,18 @@ void BlockSelectorDialog::itemSelected(QListWidgetItem* item) {
     if (item != nullptr) {
         const QString libName = item->data(Qt::UserRole + 0).toString();
         const QString blockName = item->data(Qt::UserRole + 1).toString();
+        const QString modelPath = item->data(Qt::UserRole + 2).toString();
+
+        // Load indexed workspace models on first use
+        const auto mdl_library = mtea::ModelManager::get_instance().default_model_library();
+        if (!modelPath.isEmpty() && !mdl_library->has_block(blockName.toStdString())) {
+            try {
+                (void)mdl_library->load_model(modelPath.toStdString());
+            } catch (const mtea::ModelException& ex) {
+                QMessageBox::warning(this, "error", ex.what());
+                return;
+            }
+        }
 
         emit blockSelected(libName, blockName);
     }
@@ -45,6 +79,18 @@ void BlockSelectorDialog::itemSelected(QListWidgetItem* item) {
 
 void BlockSelectorDialog::updateLibrary() {
     const mtea::ModelManager& manager = mtea::ModelManager::get_instance();
+
+    // Only a workspace the user has opened is indexed, and so the index is only kept within its root
+    if (const auto index = manager.default_model_library()->get_workspace_index()) {
+        try {
+            if (index->scan() > 0) {
+                index->save();
+            }
+        } catch (const mtea::ModelException& ex) {
+            QMessageBox::warning(this, "error", ex.what());
+        }
+    }
+
     ui->listLibraries->clear();
     for (const auto& n : manager.get_library_names()) {
         QListWidgetItem* item = new QListWidgetItem(QString(n.c_str()), ui->listLibraries);
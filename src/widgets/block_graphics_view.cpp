@@ -179,6 +179,10 @@ void BlockGraphicsView::mouseReleaseEvent(QMouseEvent* event) {
 
             updateModel();
         }
+    } else if (auto* blockState = dynamic_cast<BlockDragState*>(mouseState.get())) {
+        if (blockState->getCurrent() != blockState->getOriginal()) {
+            get_model()->mark_block_layout_changed(blockState->getBlock()->get_block()->get_id());
+        }
     }
 
     mouseState = nullptr;
@@ -213,6 +217,7 @@ void BlockGraphicsView::mouseDoubleClickEvent(QMouseEvent* event) {
 
                 connect(dialog, &BlockParameterDialog::finished, [dialog, this, block](const int result) {
                     if (result) {
+                        get_model()->mark_block_changed(block->get_block()->get_id());
                         updateModel();
 
                         const auto sceneItems = scene()->items();
@@ -242,6 +247,7 @@ void BlockGraphicsView::mouseDoubleClickEvent(QMouseEvent* event) {
             connect(
                 dialog, &ConnectionParametersDialog::finished, [dialog, this, conn](const int result) {
                     if (result) {
+                        get_model()->mark_connection_changed(conn->get_to_block()->get_block()->get_id(), conn->get_to_port());
                         conn->update();
                         emit modelChanged();
                     }
@@ -257,6 +263,7 @@ void BlockGraphicsView::keyPressEvent(QKeyEvent* event) {
         if (event->key() == Qt::Key_I) {
             if (auto blk = dynamic_cast<BlockObject*>(selectedItem)) {
                 blk->setInverted(!blk->getInverted());
+                get_model()->mark_block_layout_changed(blk->get_block()->get_id());
                 emit modelChanged();
             }
         } else {
@@ -471,6 +478,7 @@ void BlockGraphicsView::addBlock(std::shared_ptr<mtea::BlockInterface> blk) {
     // Create the block object
     BlockObject* block_obj = new BlockObject(blk);
     block_obj->setPos(mapToScene(QPoint(50, 50)));
+    get_model()->mark_block_layout_changed(blk->get_id());
 
     // Add the block to storage/tracking
     scene()->addItem(block_obj);
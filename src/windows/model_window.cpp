@@ -14,6 +14,7 @@
 
 #include "dialogs/model_parameters_dialog.h"
 
+#include <model_binary.hpp>
 #include <model_manager.hpp>
 #include <model_block.hpp>
 #include <model_exception.hpp>
@@ -27,7 +28,9 @@
 
 #include "exceptions/model_exception.h"
 
-const QString ModelWindow::default_file_filter = QString("Model (*%1);; Any (*.*)").arg(mtea::Model::DEFAULT_MODEL_EXTENSION.c_str());
+const QString ModelWindow::default_file_filter = QString("Model (*%1 *%2);; Any (*.*)")
+                                                     .arg(mtea::Model::DEFAULT_MODEL_EXTENSION.c_str())
+                                                     .arg(mtea::ModelBinaryFormat::FILE_EXTENSION.c_str());
 
 ModelWindow::ModelWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::ModelWindow) {
     // Setup the main UI
@@ -204,12 +207,39 @@ void ModelWindow::openFileDialog() {
     }
 }
 
+void ModelWindow::openWorkspaceDialog() {
+    const QString dirName = QFileDialog::getExistingDirectory(this, tr("Open Workspace"));
+    if (dirName.isEmpty()) {
+        return;
+    }
+
+    // Index the chosen directory as the workspace, so that submodels resolve and prefetch from the index
+    try {
+        const auto index = mtea::WorkspaceIndex::open(std::filesystem::path(dirName.toStdString()));
+        mtea::ModelManager::get_instance().default_model_library()->set_workspace_index(index);
+
+        try {
+            index->save();
+        } catch (const mtea::ModelException&) {
+            // A read-only workspace is still indexed, but the index is not kept between sessions
+        }
+    } catch (const mtea::ModelException& ex) {
+        QMessageBox::warning(this, "error", ex.what());
+    }
+}
+
 bool ModelWindow::openModelFile(QString openFilename) {
     std::shared_ptr<mtea::Model> mdl = nullptr;
     const auto mdl_library = mtea::ModelManager::get_instance().default_model_library();
 
     try {
-        mdl = mdl_library->load_model(openFilename.toStdString());
+        // Refresh the workspace index when opening one of its models, where models outside of an opened workspace aren't indexed
+        const std::filesystem::path pth(openFilename.toStdString());
+        if (const auto index = mdl_library->get_workspace_index(); index != nullptr && index->contains(pth)) {
+            index->scan();
+        }
+
+        mdl = mdl_library->load_model(pth);
     } catch (const mtea::ModelException& ex) {
         QMessageBox::warning(this, "error", ex.what());
         return false;
@@ -316,7 +346,7 @@ void ModelWindow::changeModel(std::shared_ptr<mtea::Model> model) {
 
         // Set the new model
         if (model == nullptr) {
-            model = std::make_shared<mtea::Model>();
+            model = std::make_shared<mtea::Model>(mtea::ModelManager::get_instance());
         } else if (WindowManager::instance().model_is_open(model.get())) {
             throw ModelException("model already open");
         }
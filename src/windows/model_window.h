@@ -44,6 +44,8 @@ public slots:
 
     void openFileDialog();
 
+    void openWorkspaceDialog();
+
     bool openModelFile(QString openFilename);
 
     bool openModel(std::shared_ptr<mtea::Model> model);